@@ -0,0 +1,110 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "CpuIsa.hpp"
+
+// C++ includes
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+// Fluidika includes
+#include <Fluidika/Common/Exception.hpp>
+
+// The variants other than the baseline are compiled only for x86-64 with GCC or Clang (see Fluidika/CMakeLists.txt)
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FLUIDIKA_HAS_ISA_VARIANTS 1
+#else
+#define FLUIDIKA_HAS_ISA_VARIANTS 0
+#endif
+
+namespace Fluidika {
+namespace {
+
+/// The instruction sets in increasing order of capability.
+const CpuIsa isas[] = { CpuIsa::Baseline, CpuIsa::SSE42, CpuIsa::AVX2, CpuIsa::AVX512 };
+
+/// Return the instruction set selected for this process.
+auto selectCpuIsa() -> CpuIsa
+{
+    // The most capable instruction set supported
+    auto isa = CpuIsa::Baseline;
+    for(auto candidate : isas)
+        if(cpuIsaSupported(candidate))
+            isa = candidate;
+
+    const char* forced = std::getenv("FLUIDIKA_ISA");
+
+    if(forced == nullptr || *forced == '\0')
+        return isa;
+
+    std::string name(forced);
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+
+    const auto it = std::find_if(std::begin(isas), std::end(isas), [&](CpuIsa candidate) { return cpuIsaName(candidate) == name; });
+
+    if(it == std::end(isas))
+    {
+        warning(true, "The value `", forced, "` of environment variable FLUIDIKA_ISA is not one of baseline, sse4.2, avx2 or avx512. It will be ignored.");
+        return isa;
+    }
+
+    warning(*it > isa, "The instruction set `", name, "` forced with environment variable FLUIDIKA_ISA is not supported. Instruction set `", cpuIsaName(isa), "` will be used instead.");
+
+    return std::min(*it, isa);
+}
+
+} // namespace
+
+auto cpuIsa() -> CpuIsa
+{
+    static const auto isa = selectCpuIsa();
+    return isa;
+}
+
+auto cpuIsaSupported(CpuIsa isa) -> bool
+{
+#if FLUIDIKA_HAS_ISA_VARIANTS
+    __builtin_cpu_init();
+    switch(isa) {
+    case CpuIsa::SSE42:
+        return __builtin_cpu_supports("sse4.2");
+    case CpuIsa::AVX2:
+        return __builtin_cpu_supports("avx2");
+    case CpuIsa::AVX512:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl");
+    case CpuIsa::Baseline:
+    default:
+        return true;
+    }
+#else
+    return isa == CpuIsa::Baseline;
+#endif
+}
+
+auto cpuIsaName(CpuIsa isa) -> std::string
+{
+    switch(isa) {
+    case CpuIsa::SSE42: return "sse4.2";
+    case CpuIsa::AVX2: return "avx2";
+    case CpuIsa::AVX512: return "avx512";
+    case CpuIsa::Baseline:
+    default: return "baseline";
+    }
+}
+
+} // namespace Fluidika
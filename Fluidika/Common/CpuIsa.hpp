@@ -0,0 +1,49 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// C++ includes
+#include <string>
+
+namespace Fluidika {
+
+/// The instruction sets for which the batch kernels are compiled.
+/// The kernels of every instruction set are part of the same library. The most capable one supported by the
+/// processor is selected at runtime, so that a single build performs well on every node of a heterogeneous cluster.
+enum class CpuIsa
+{
+    Baseline, ///< The instruction set of the compiler's default target (e.g., SSE2 on x86-64)
+    SSE42,    ///< The SSE4.2 extensions (128-bit registers)
+    AVX2,     ///< The AVX2 extensions (256-bit registers)
+    AVX512,   ///< The AVX-512 F, DQ and VL extensions (512-bit registers)
+};
+
+/// Return the instruction set used by the batch kernels.
+/// This is the most capable instruction set supported by both the processor and the build of the library. It can be
+/// lowered with the environment variable `FLUIDIKA_ISA` (one of `baseline`, `sse4.2`, `avx2` or `avx512`), which is
+/// useful for reproducibility tests among nodes of different generations. A variant that is not supported cannot
+/// be forced, in which case the most capable supported one below it is used. The selection is done once, on the first call.
+auto cpuIsa() -> CpuIsa;
+
+/// Return true if the batch kernels of a given instruction set were compiled in this build and the processor supports them.
+auto cpuIsaSupported(CpuIsa isa) -> bool;
+
+/// Return the name of an instruction set as accepted by the environment variable `FLUIDIKA_ISA`.
+auto cpuIsaName(CpuIsa isa) -> std::string;
+
+} // namespace Fluidika
@@ -0,0 +1,326 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "Diagnostics.hpp"
+
+// C++ includes
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Fluidika {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// The ring buffer of the messages of a thread, written only by that thread and read only by the holder of the sink lock.
+class MessageRing
+{
+public:
+    /// Add a message to the ring, returning false if it is full.
+    auto push(std::string&& message) -> bool
+    {
+        const auto h = head.load(std::memory_order_relaxed);
+        const auto t = tail.load(std::memory_order_acquire);
+        if(h - t == capacity)
+            return false;
+        messages[h % capacity] = std::move(message);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Pass all messages in the ring to a function, removing them.
+    template<typename Function>
+    auto drain(const Function& f) -> void
+    {
+        auto t = tail.load(std::memory_order_relaxed);
+        const auto h = head.load(std::memory_order_acquire);
+        for(; t != h; ++t)
+            f(messages[t % capacity]);
+        tail.store(t, std::memory_order_release);
+    }
+
+    /// Return true if the ring has no messages.
+    auto empty() const -> bool
+    {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    /// The maximum number of messages in the ring.
+    static constexpr std::size_t capacity = 64;
+
+    /// The messages in the ring.
+    std::array<std::string, capacity> messages;
+
+    /// The number of messages ever added to the ring.
+    std::atomic<std::size_t> head{0};
+
+    /// The number of messages ever removed from the ring.
+    std::atomic<std::size_t> tail{0};
+};
+
+/// The rate limit state of a call site in a thread.
+struct SiteState
+{
+    /// The start of the current window.
+    Clock::time_point start;
+
+    /// The number of messages emitted in the current window.
+    std::size_t count = 0;
+
+    /// The number of messages suppressed since the last one emitted.
+    std::uint64_t suppressed = 0;
+
+    /// The generation of the rate limit for which the window was started.
+    std::uint64_t generation = 0;
+};
+
+/// The diagnostics state of a thread.
+struct ThreadState
+{
+    /// The messages of the thread not yet passed on to the sink.
+    MessageRing ring;
+
+    /// The rate limit states of the call sites, accessed only by the thread.
+    std::unordered_map<std::uint64_t, SiteState> sites;
+
+    /// The statistics of the messages of the thread, read by @ref diagnosticsStats.
+    std::atomic<std::uint64_t> emitted{0}, suppressed{0}, dropped{0};
+
+    /// Whether the thread is still running, so that the state can be discarded once drained.
+    std::atomic<bool> alive{true};
+};
+
+/// The default sink, which writes the messages to std::cerr.
+auto defaultSink(const std::string& message) -> void
+{
+    std::cerr << message << '\n';
+}
+
+/// Return true unless the diagnostic messages are disabled with the environment variable `FLUIDIKA_DIAGNOSTICS`.
+auto enabledByEnvironment() -> bool
+{
+    const char* value = std::getenv("FLUIDIKA_DIAGNOSTICS");
+    if(value == nullptr)
+        return true;
+    std::string name(value);
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+    return name != "off" && name != "0" && name != "false";
+}
+
+/// The diagnostics state of the process.
+struct Registry
+{
+    /// Whether the diagnostic messages are enabled.
+    std::atomic<bool> enabled{enabledByEnvironment()};
+
+    /// The maximum number of messages per call site, thread and window.
+    std::atomic<std::size_t> burst{10};
+
+    /// The length of the rate limit windows.
+    std::atomic<Clock::duration::rep> interval{std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)).count()};
+
+    /// The number of changes of the rate limit, which restart the windows of all call sites.
+    std::atomic<std::uint64_t> generation{1};
+
+    /// The lock held by the thread passing messages on to the sink, which also guards the list of threads and the sink.
+    std::mutex mutex;
+
+    /// The diagnostics states of all threads that have issued messages.
+    std::vector<std::shared_ptr<ThreadState>> threads;
+
+    /// The function that receives the messages.
+    DiagnosticsSink sink = defaultSink;
+
+    /// The statistics of the threads that have exited.
+    DiagnosticsStats retired;
+
+    /// Pass on the messages of all threads to the sink, discarding the states of the threads that have exited (the lock must be held).
+    auto drain() -> void
+    {
+        for(auto& thread : threads)
+            thread->ring.drain([&](const std::string& message) { sink(message); });
+
+        const auto exited = [&](const std::shared_ptr<ThreadState>& thread)
+        {
+            if(thread->alive.load(std::memory_order_acquire) || !thread->ring.empty())
+                return false;
+            retired.emitted += thread->emitted.load(std::memory_order_relaxed);
+            retired.suppressed += thread->suppressed.load(std::memory_order_relaxed);
+            retired.dropped += thread->dropped.load(std::memory_order_relaxed);
+            return true;
+        };
+
+        threads.erase(std::remove_if(threads.begin(), threads.end(), exited), threads.end());
+    }
+
+    /// Pass on the messages still buffered at the exit of the process.
+    ~Registry()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        drain();
+    }
+};
+
+/// Return the diagnostics state of the process.
+auto registry() -> Registry&
+{
+    static Registry instance;
+    return instance;
+}
+
+/// The handle of the diagnostics state of a thread, which registers it on construction and marks it as exited on destruction.
+struct ThreadHandle
+{
+    std::shared_ptr<ThreadState> state = std::make_shared<ThreadState>();
+
+    ThreadHandle()
+    {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.threads.push_back(state);
+    }
+
+    ~ThreadHandle()
+    {
+        state->alive.store(false, std::memory_order_release);
+    }
+};
+
+/// Return the diagnostics state of the calling thread.
+auto threadState() -> ThreadState&
+{
+    thread_local ThreadHandle handle;
+    return *handle.state;
+}
+
+} // namespace
+
+auto enableDiagnostics(bool enable) -> void
+{
+    registry().enabled.store(enable, std::memory_order_relaxed);
+}
+
+auto diagnosticsEnabled() -> bool
+{
+    return registry().enabled.load(std::memory_order_relaxed);
+}
+
+auto setDiagnosticsSink(DiagnosticsSink sink) -> void
+{
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.drain();
+    r.sink = sink ? std::move(sink) : DiagnosticsSink(defaultSink);
+}
+
+auto setDiagnosticsRateLimit(std::size_t burst, double interval) -> void
+{
+    auto& r = registry();
+    r.burst.store(burst, std::memory_order_relaxed);
+    r.interval.store(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(interval)).count(), std::memory_order_relaxed);
+    r.generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto flushDiagnostics() -> void
+{
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.drain();
+}
+
+auto diagnosticsStats() -> DiagnosticsStats
+{
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto stats = r.retired;
+    for(const auto& thread : r.threads)
+    {
+        stats.emitted += thread->emitted.load(std::memory_order_relaxed);
+        stats.suppressed += thread->suppressed.load(std::memory_order_relaxed);
+        stats.dropped += thread->dropped.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+namespace internal {
+
+auto admitDiagnostic(std::uint64_t site, std::uint64_t& suppressed) -> bool
+{
+    auto& r = registry();
+
+    if(!r.enabled.load(std::memory_order_relaxed))
+        return false;
+
+    auto& thread = threadState();
+    auto& state = thread.sites[site];
+
+    const auto burst = r.burst.load(std::memory_order_relaxed);
+    const auto generation = r.generation.load(std::memory_order_relaxed);
+
+    // Once the burst of a window is exhausted, the clock is only read every 64 suppressed messages, since reading it
+    // costs about as much as the rest of this function
+    if(state.count < burst || state.suppressed % 64 == 63 || state.generation != generation)
+    {
+        const auto now = Clock::now();
+        const auto interval = Clock::duration(r.interval.load(std::memory_order_relaxed));
+
+        if(now - state.start >= interval || state.generation != generation)
+            state.start = now, state.count = 0, state.generation = generation;
+    }
+
+    if(state.count >= burst)
+    {
+        ++state.suppressed;
+        thread.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    ++state.count;
+    suppressed = state.suppressed;
+    state.suppressed = 0;
+    return true;
+}
+
+auto emitDiagnostic(std::string message) -> void
+{
+    auto& r = registry();
+    auto& thread = threadState();
+
+    if(thread.ring.push(std::move(message)))
+        thread.emitted.fetch_add(1, std::memory_order_relaxed);
+    else thread.dropped.fetch_add(1, std::memory_order_relaxed);
+
+    // Pass on the buffered messages only if no other thread is doing so, instead of waiting for it
+    std::unique_lock<std::mutex> lock(r.mutex, std::try_to_lock);
+    if(lock.owns_lock())
+        r.drain();
+}
+
+} // namespace internal
+} // namespace Fluidika
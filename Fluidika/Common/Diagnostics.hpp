@@ -0,0 +1,87 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+// C++ includes
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace Fluidika {
+
+/// The type of functions that receive the diagnostic messages (e.g., warnings) of the library, one line at a time.
+using DiagnosticsSink = std::function<void(const std::string&)>;
+
+/// The statistics of the diagnostic messages issued since the start of the process.
+struct DiagnosticsStats
+{
+    /// The number of messages passed on to the sink or still buffered.
+    std::uint64_t emitted = 0;
+
+    /// The number of messages suppressed by the rate limit of their call sites.
+    std::uint64_t suppressed = 0;
+
+    /// The number of messages dropped because the buffer of their thread was full.
+    std::uint64_t dropped = 0;
+};
+
+/// Enable or disable the diagnostic messages of the library, which are enabled by default.
+/// They can also be disabled with the environment variable `FLUIDIKA_DIAGNOSTICS=off`. While disabled, a warning costs
+/// only the evaluation of its condition, and its message is neither formatted nor counted.
+auto enableDiagnostics(bool enable) -> void;
+
+/// Return true if the diagnostic messages of the library are enabled.
+auto diagnosticsEnabled() -> bool;
+
+/// Set the function that receives the diagnostic messages of the library, or the default one (which writes to std::cerr) if empty.
+/// The sink is never called by two threads at the same time. It must remain valid until replaced, since the messages
+/// still buffered at the exit of the process are passed on to it.
+auto setDiagnosticsSink(DiagnosticsSink sink) -> void;
+
+/// Set the rate limit of the diagnostic messages issued at each call site by each thread.
+/// Beyond *burst* messages in a window of *interval* seconds, the messages of a call site are suppressed, and their
+/// number is reported with the first message passed on after the window. Under heavy load, the end of a window is
+/// only checked every 64 suppressed messages, so that a window may last slightly longer than *interval*. Changing the
+/// rate limit restarts the windows of all call sites. The default is 10 messages per second. A call site is identified
+/// by the string literal that begins its messages, so that the messages beginning with the same literal share a limit.
+/// @param burst The maximum number of messages per window
+/// @param interval The length of the window (in units of s)
+auto setDiagnosticsRateLimit(std::size_t burst, double interval) -> void;
+
+/// Pass on to the sink the diagnostic messages still buffered by all threads.
+/// Messages are buffered when the sink is busy with those of another thread, and are otherwise passed on immediately.
+/// The buffered messages are also passed on by the next thread that issues a message, and at the exit of the process.
+auto flushDiagnostics() -> void;
+
+/// Return the statistics of the diagnostic messages issued since the start of the process.
+auto diagnosticsStats() -> DiagnosticsStats;
+
+namespace internal {
+
+/// Return true if a diagnostic message issued at a call site should be formatted and emitted by the calling thread.
+/// @param site The identifier of the call site
+/// @param[out] suppressed The number of messages of the call site suppressed since the last one emitted by the calling thread
+auto admitDiagnostic(std::uint64_t site, std::uint64_t& suppressed) -> bool;
+
+/// Emit a diagnostic message admitted by @ref admitDiagnostic through the buffer of the calling thread.
+auto emitDiagnostic(std::string message) -> void;
+
+} // namespace internal
+} // namespace Fluidika
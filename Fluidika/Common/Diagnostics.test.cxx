@@ -0,0 +1,128 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+
+// C++ includes
+#include <string>
+#include <thread>
+#include <vector>
+
+// Catch includes
+#include <catch2/catch.hpp>
+
+// Fluidika includes
+#include <Fluidika/Common/Diagnostics.hpp>
+#include <Fluidika/Common/Exception.hpp>
+using namespace Fluidika;
+
+TEST_CASE("Fluidika::Diagnostics", "[Diagnostics]")
+{
+    std::vector<std::string> messages;
+
+    setDiagnosticsSink([&](const std::string& message) { messages.push_back(message); });
+
+    const auto before = diagnosticsStats();
+
+    SECTION("when warnings are issued repeatedly at the same call site")
+    {
+        setDiagnosticsRateLimit(3, 3600.0);
+
+        for(int i = 0; i < 10; ++i)
+            warning(true, "The value ", i, " is out of range.");
+
+        for(int i = 0; i < 2; ++i)
+            warning(true, "The other value ", i, " is out of range.");
+
+        warning(false, "The value ", 0, " is out of range.");
+
+        REQUIRE(messages.size() == 5);
+        REQUIRE(messages[0].find("The value 0 is out of range.") != std::string::npos);
+        REQUIRE(messages[2].find("The value 2 is out of range.") != std::string::npos);
+        REQUIRE(messages[3].find("The other value 0 is out of range.") != std::string::npos);
+
+        const auto stats = diagnosticsStats();
+
+        REQUIRE(stats.emitted - before.emitted == 5);
+        REQUIRE(stats.suppressed - before.suppressed == 7);
+
+        // The number of suppressed warnings is reported with the next one emitted after the window
+        setDiagnosticsRateLimit(3, 0.0);
+
+        warning(true, "The value ", 10, " is out of range.");
+
+        REQUIRE(messages.size() == 6);
+        REQUIRE(messages[5].find("The value 10 is out of range. (7 similar warnings were suppressed)") != std::string::npos);
+    }
+
+    SECTION("when warnings are issued with strings built at run time")
+    {
+        setDiagnosticsRateLimit(3, 3600.0);
+
+        // The strings are kept alive, so that each has an address of its own
+        std::vector<std::string> names;
+        for(int i = 0; i < 10; ++i)
+            names.push_back("the variable number " + std::to_string(i));
+
+        for(const auto& name : names)
+            warning(true, "The value of ", name.c_str(), " is out of range.");
+
+        REQUIRE(messages.size() == 3);
+        REQUIRE(messages[2].find("The value of the variable number 2 is out of range.") != std::string::npos);
+        REQUIRE(diagnosticsStats().suppressed - before.suppressed == 7);
+    }
+
+    SECTION("when warnings are issued by many threads")
+    {
+        setDiagnosticsRateLimit(5, 3600.0);
+
+        const auto nthreads = 8;
+
+        std::vector<std::thread> threads;
+        for(int k = 0; k < nthreads; ++k)
+            threads.emplace_back([] { for(int i = 0; i < 1000; ++i) warning(true, "The value ", i, " is out of range."); });
+
+        for(auto& thread : threads)
+            thread.join();
+
+        flushDiagnostics();
+
+        const auto stats = diagnosticsStats();
+
+        REQUIRE(messages.size() == 5 * nthreads);
+        REQUIRE(stats.emitted - before.emitted == 5 * nthreads);
+        REQUIRE(stats.suppressed - before.suppressed == 995 * nthreads);
+        REQUIRE(stats.dropped == before.dropped);
+    }
+
+    SECTION("when the diagnostics are disabled")
+    {
+        enableDiagnostics(false);
+
+        REQUIRE_FALSE(diagnosticsEnabled());
+
+        warning(true, "The value ", 0, " is out of range.");
+
+        enableDiagnostics(true);
+
+        REQUIRE(messages.empty());
+        REQUIRE(diagnosticsStats().emitted == before.emitted);
+        REQUIRE(diagnosticsStats().suppressed == before.suppressed);
+    }
+
+    setDiagnosticsSink(nullptr);
+    setDiagnosticsRateLimit(10, 1.0);
+}
@@ -0,0 +1,52 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// C++ includes
+#include <cmath>
+
+// Fluidika includes
+#include <Fluidika/Common/Simd.hpp>
+
+/// A minimal forward-mode dual number used in the tests to check that the generic models can be differentiated automatically.
+struct Dual
+{
+    double val = 0.0, grad = 0.0;
+    Dual() = default;
+    Dual(double val, double grad = 0.0) : val(val), grad(grad) {}
+    auto operator+=(const Dual& b) -> Dual& { return *this = Dual(val + b.val, grad + b.grad); }
+    auto operator-=(const Dual& b) -> Dual& { return *this = Dual(val - b.val, grad - b.grad); }
+    auto operator*=(const Dual& b) -> Dual& { return *this = Dual(val * b.val, grad * b.val + val * b.grad); }
+};
+
+inline auto operator-(const Dual& a) -> Dual { return Dual(-a.val, -a.grad); }
+inline auto operator+(const Dual& a, const Dual& b) -> Dual { return Dual(a.val + b.val, a.grad + b.grad); }
+inline auto operator-(const Dual& a, const Dual& b) -> Dual { return Dual(a.val - b.val, a.grad - b.grad); }
+inline auto operator*(const Dual& a, const Dual& b) -> Dual { return Dual(a.val * b.val, a.grad * b.val + a.val * b.grad); }
+inline auto operator/(const Dual& a, const Dual& b) -> Dual { return Dual(a.val / b.val, (a.grad * b.val - a.val * b.grad)/(b.val * b.val)); }
+inline auto exp(const Dual& a) -> Dual { return Dual(std::exp(a.val), std::exp(a.val) * a.grad); }
+inline auto log(const Dual& a) -> Dual { return Dual(std::log(a.val), a.grad / a.val); }
+inline auto sqrt(const Dual& a) -> Dual { return Dual(std::sqrt(a.val), 0.5 * a.grad / std::sqrt(a.val)); }
+inline auto pow(const Dual& a, double b) -> Dual { return Dual(std::pow(a.val, b), b * std::pow(a.val, b - 1) * a.grad); }
+
+namespace Fluidika {
+
+template<>
+struct ValueTypeHelper<Dual> { using type = double; };
+
+} // namespace Fluidika
@@ -18,20 +18,56 @@
 #pragma once
 
 // C++ includes
-#include <iostream>
+#include <cstdint>
 #include <exception>
+#include <stdexcept>
+#include <type_traits>
 
 // Fluidika includes
+#include <Fluidika/Common/Diagnostics.hpp>
 #include <Fluidika/Common/StringUtils.hpp>
 
 namespace Fluidika {
+namespace internal {
+
+inline auto diagnosticSite() -> std::uint64_t
+{
+    return 0;
+}
+
+/// Return the identifier of the call site of a diagnostic message, which is the address of its first item.
+/// The first item must thus be a string literal (or another string that outlives the process), and strings built at run
+/// time, such as those of `std::string::c_str()`, must only come after it, or each call would have a call site of its own.
+/// The messages whose first item is not a C string share a single call site.
+template<typename T, typename... Args>
+auto diagnosticSite(const T& item, const Args&...) -> std::uint64_t
+{
+    if constexpr(std::is_same_v<T, const char*>)
+        return reinterpret_cast<std::uintptr_t>(item);
+    return 0;
+}
+
+} // namespace internal
 
 /// Issue a warning message if condition is true.
+/// The message is passed on to the sink of the diagnostic messages (see Diagnostics.hpp), which is std::cerr by default,
+/// subject to the rate limit of its call site. The message is only formatted if it is not suppressed. The call site is
+/// identified by the first item, which must be a string literal (see @ref internal::diagnosticSite).
 template<typename... Args>
 auto warning(bool condition, Args... items) -> void
 {
-    if(condition)
-        std::cerr << "\033[1;33m***WARNING***\033[0m" << " " << str(items...) << std::endl;
+    if(!condition)
+        return;
+
+    std::uint64_t suppressed = 0;
+
+    if(!internal::admitDiagnostic(internal::diagnosticSite(items...), suppressed))
+        return;
+
+    if(suppressed > 0)
+        internal::emitDiagnostic(str("\033[1;33m***WARNING***\033[0m", " ", str(items...), " (", suppressed, " similar warnings were suppressed)"));
+    else
+        internal::emitDiagnostic(str("\033[1;33m***WARNING***\033[0m", " ", str(items...)));
 }
 
 /// Raise a runtime error if condition is true.
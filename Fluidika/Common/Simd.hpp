@@ -0,0 +1,117 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// C++ includes
+#include <algorithm>
+#include <cstddef>
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define FLUIDIKA_HAS_SIMD 1
+#else
+#define FLUIDIKA_HAS_SIMD 0
+#endif
+
+// Fluidika includes
+#include <Fluidika/Common/Real.hpp>
+
+// The inline namespace of the generic kernels, which differs among the translation units compiled for different
+// instruction sets (see CpuIsa.hpp), so that their template instantiations are never merged by the linker
+#ifndef FLUIDIKA_ISA_NAMESPACE
+#define FLUIDIKA_ISA_NAMESPACE isa_baseline
+#endif
+
+namespace Fluidika {
+
+#if FLUIDIKA_HAS_SIMD
+
+namespace stdx = std::experimental;
+
+/// The type used for packs of real values evaluated together in the lanes of the native SIMD registers.
+using RealSimd = stdx::native_simd<Real>;
+
+/// The type used for packs of single-precision values evaluated together in the lanes of the native SIMD registers.
+/// These packs have twice as many lanes as @ref RealSimd.
+using FloatSimd = stdx::native_simd<float>;
+
+#endif
+
+/// The type of the values in a scalar type (the type itself) or in the lanes of a SIMD type.
+template<typename Scalar>
+struct ValueTypeHelper { using type = Scalar; };
+
+#if FLUIDIKA_HAS_SIMD
+template<typename T, typename Abi>
+struct ValueTypeHelper<stdx::simd<T, Abi>> { using type = T; };
+#endif
+
+/// The type of the values in a scalar type (the type itself) or in the lanes of a SIMD type (e.g., float for FloatSimd).
+template<typename Scalar>
+using ValueType = typename ValueTypeHelper<Scalar>::type;
+
+/// Return the value in a given lane of a real value, which has a single lane.
+inline auto lane(RealConstRef x, std::size_t) -> Real
+{
+    return x;
+}
+
+/// Return the value in a given lane of a single-precision value, which has a single lane.
+inline auto lane(float x, std::size_t) -> float
+{
+    return x;
+}
+
+#if FLUIDIKA_HAS_SIMD
+
+/// Return the value in a given lane of a pack of values.
+template<typename T, typename Abi>
+auto lane(const stdx::simd<T, Abi>& x, std::size_t i) -> T
+{
+    return x[i];
+}
+
+/// Return a pack with the first *m* values of an array, with the last of them repeated in the remaining lanes.
+/// The values are converted to the type of the lanes of the pack (e.g., from double to float for FloatSimd).
+/// @tparam Simd The type of the pack (e.g., RealSimd or FloatSimd)
+/// @param values The array of values with at least *m* entries
+/// @param m The number of values to be loaded, between 1 and the number of lanes
+template<typename Simd, typename Value>
+auto load(const Value* values, std::size_t m) -> Simd
+{
+    using T = typename Simd::value_type;
+    if(m == Simd::size())
+        return Simd(values, stdx::element_aligned);
+    return Simd([&](auto i) { return static_cast<T>(values[std::min<std::size_t>(i, m - 1)]); });
+}
+
+/// Store the values in the first *m* lanes of a pack in an array.
+/// @param x The pack of values
+/// @param[out] values The array with at least *m* entries where the values are stored
+/// @param m The number of values to be stored, between 1 and the number of lanes
+template<typename T, typename Abi>
+auto store(const stdx::simd<T, Abi>& x, T* values, std::size_t m) -> void
+{
+    if(m == x.size())
+        x.copy_to(values, stdx::element_aligned);
+    else for(std::size_t i = 0; i < m; ++i)
+        values[i] = x[i];
+}
+
+#endif
+
+} // namespace Fluidika
@@ -0,0 +1,406 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "TableFile.hpp"
+
+// C++ includes
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <utility>
+
+// System includes
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Fluidika includes
+#include <Fluidika/Common/Exception.hpp>
+
+namespace Fluidika {
+namespace {
+
+/// The magic string at the start of a table file.
+const char table_file_magic[8] = { 'F', 'L', 'D', 'K', 'T', 'A', 'B', '\0' };
+
+/// The byte-order mark of a table file, which reads differently on a machine with another byte order.
+constexpr std::uint32_t table_file_byte_order = 0x01020304;
+
+/// The type of the values of a column stored as 64-bit IEEE 754 floating-point numbers.
+constexpr std::uint32_t table_file_type_float64 = 1;
+
+static_assert(sizeof(Real) == 8 && std::numeric_limits<Real>::is_iec559, "The table files store real values as 64-bit IEEE 754 floating-point numbers.");
+
+/// The header of a table file (see @ref writeTableFile).
+struct TableFileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t rows;
+    std::uint32_t cols;
+    std::uint32_t alignment;
+    std::uint64_t size;
+    std::uint64_t checksum;
+    std::uint8_t reserved[16];
+};
+
+/// The descriptor of a column of a table file (see @ref writeTableFile).
+struct TableFileDescriptor
+{
+    char name[32];
+    std::uint32_t type;
+    std::uint32_t reserved;
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::uint64_t checksum;
+};
+
+static_assert(sizeof(TableFileHeader) == 64, "The header of a table file must have 64 bytes.");
+static_assert(sizeof(TableFileDescriptor) == 64, "The descriptor of a column of a table file must have 64 bytes.");
+
+/// Return the 64-bit FNV-1a hash of given data taken as a sequence of 64-bit words, continuing from a given hash.
+/// The last word is padded with zeros if the size of the data is not a multiple of 8 bytes.
+auto tableFileChecksum(const void* data, std::size_t size, std::uint64_t hash = 0xcbf29ce484222325) -> std::uint64_t
+{
+    const auto bytes = static_cast<const unsigned char*>(data);
+    for(std::size_t i = 0; i < size; i += 8)
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, bytes + i, std::min<std::size_t>(8, size - i));
+        hash = (hash ^ word) * 0x100000001b3;
+    }
+    return hash;
+}
+
+/// Return the checksum of the header, with its checksum set to zero, and the descriptors of a table file.
+auto tableFileHeaderChecksum(TableFileHeader header, const void* descriptors, std::size_t cols) -> std::uint64_t
+{
+    header.checksum = 0;
+    return tableFileChecksum(descriptors, cols * sizeof(TableFileDescriptor), tableFileChecksum(&header, sizeof(header)));
+}
+
+/// Return the smallest multiple of the alignment of the columns not below a given offset.
+auto tableFileAlign(std::uint64_t offset) -> std::uint64_t
+{
+    return (offset + tableFileAlignment - 1) / tableFileAlignment * tableFileAlignment;
+}
+
+/// The read-only and shared memory mapping of a file, which is released on destruction.
+struct TableFileMapping
+{
+    /// The start of the mapping, or null if the file is empty.
+    const unsigned char* data = nullptr;
+
+    /// The size of the mapping (in bytes).
+    std::size_t size = 0;
+
+    /// Construct a TableFileMapping instance by mapping a file into memory.
+    explicit TableFileMapping(const std::string& path)
+    {
+#if defined(_WIN32)
+        const auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        error(file == INVALID_HANDLE_VALUE, "Could not open table file `", path, "`.");
+        LARGE_INTEGER filesize;
+        const auto sized = GetFileSizeEx(file, &filesize);
+        const auto mapping = sized && filesize.QuadPart > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+        CloseHandle(file);
+        error(!sized, "Could not determine the size of table file `", path, "`.");
+        if(filesize.QuadPart == 0)
+            return;
+        error(mapping == nullptr, "Could not map table file `", path, "` into memory.");
+        const auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        error(view == nullptr, "Could not map table file `", path, "` into memory.");
+        data = static_cast<const unsigned char*>(view);
+        size = static_cast<std::size_t>(filesize.QuadPart);
+#else
+        const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        error(fd < 0, "Could not open table file `", path, "`: ", std::strerror(errno));
+        struct stat st;
+        if(::fstat(fd, &st) != 0)
+        {
+            const auto reason = std::strerror(errno);
+            ::close(fd);
+            error(true, "Could not determine the size of table file `", path, "`: ", reason);
+        }
+        if(st.st_size == 0)
+        {
+            ::close(fd);
+            return;
+        }
+        const auto view = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        const auto reason = std::strerror(errno);
+        ::close(fd); // the mapping remains valid after the file is closed
+        error(view == MAP_FAILED, "Could not map table file `", path, "` into memory: ", reason);
+        data = static_cast<const unsigned char*>(view);
+        size = st.st_size;
+#endif
+    }
+
+    /// Destroy this TableFileMapping instance by unmapping the file from memory.
+    ~TableFileMapping()
+    {
+        if(data == nullptr)
+            return;
+#if defined(_WIN32)
+        UnmapViewOfFile(data);
+#else
+        ::munmap(const_cast<unsigned char*>(data), size);
+#endif
+    }
+
+    TableFileMapping(const TableFileMapping&) = delete;
+
+    auto operator=(const TableFileMapping&) -> TableFileMapping& = delete;
+};
+
+} // namespace
+
+auto writeTableFile(const std::string& path, std::size_t rows, const std::vector<TableFileColumn>& columns) -> void
+{
+    const auto cols = columns.size();
+
+    error(cols > std::numeric_limits<std::uint32_t>::max(), "Could not write table file `", path, "` with ", cols, " columns, which are too many.");
+    error(rows > std::numeric_limits<std::uint64_t>::max() / sizeof(Real) / (cols + 1), "Could not write table file `", path, "` with ", rows, " rows, which are too many.");
+
+    TableFileHeader header = {};
+    std::memcpy(header.magic, table_file_magic, sizeof(header.magic));
+    header.version = tableFileVersion;
+    header.byte_order = table_file_byte_order;
+    header.rows = rows;
+    header.cols = static_cast<std::uint32_t>(cols);
+    header.alignment = tableFileAlignment;
+
+    std::vector<TableFileDescriptor> descriptors(cols);
+
+    auto offset = tableFileAlign(sizeof(TableFileHeader) + cols * sizeof(TableFileDescriptor));
+
+    for(std::size_t i = 0; i < cols; ++i)
+    {
+        const auto& name = columns[i].name;
+
+        error(name.empty() || name.size() > tableFileMaxColumnName, "Could not write table file `", path, "` with column name `", name, "`, which must have between 1 and ", tableFileMaxColumnName, " characters.");
+        error(std::count_if(columns.begin(), columns.end(), [&](const auto& column) { return column.name == name; }) > 1, "Could not write table file `", path, "` with more than one column named `", name, "`.");
+        error(rows > 0 && columns[i].data == nullptr, "Could not write table file `", path, "` with column `", name, "`, which has no values.");
+
+        auto& descriptor = descriptors[i];
+        std::memcpy(descriptor.name, name.data(), name.size());
+        descriptor.type = table_file_type_float64;
+        descriptor.offset = offset;
+        descriptor.size = rows * sizeof(Real);
+        descriptor.checksum = tableFileChecksum(columns[i].data, descriptor.size);
+
+        offset = tableFileAlign(offset + descriptor.size);
+    }
+
+    header.size = cols ? descriptors.back().offset + descriptors.back().size : offset;
+    header.checksum = tableFileHeaderChecksum(header, descriptors.data(), cols);
+
+    // Write the table to a temporary file next to the requested one, which replaces it only once complete
+    const auto temporary = path + ".tmp";
+
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+
+    error(!out, "Could not create table file `", temporary, "`.");
+
+    const char zeros[tableFileAlignment] = {};
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(descriptors.data()), cols * sizeof(TableFileDescriptor));
+
+    std::uint64_t written = sizeof(header) + cols * sizeof(TableFileDescriptor);
+
+    for(std::size_t i = 0; i < cols; ++i)
+    {
+        out.write(zeros, descriptors[i].offset - written);
+        out.write(reinterpret_cast<const char*>(columns[i].data), descriptors[i].size);
+        written = descriptors[i].offset + descriptors[i].size;
+    }
+
+    out.close();
+
+    if(!out)
+    {
+        std::remove(temporary.c_str());
+        error(true, "Could not write table file `", temporary, "`.");
+    }
+
+#if defined(_WIN32)
+    std::remove(path.c_str()); // std::rename does not replace an existing file on Windows
+#endif
+
+    if(std::rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        const auto reason = std::strerror(errno);
+        std::remove(temporary.c_str());
+        error(true, "Could not rename table file `", temporary, "` to `", path, "`: ", reason);
+    }
+}
+
+struct TableFile::Impl
+{
+    /// The path of the table file.
+    std::string path;
+
+    /// The memory mapping of the table file.
+    TableFileMapping mapping;
+
+    /// The version of the format of the table file.
+    std::uint32_t version = 0;
+
+    /// The number of rows of the table.
+    std::size_t rows = 0;
+
+    /// The names of the columns of the table.
+    std::vector<std::string> names;
+
+    /// The values of the columns of the table.
+    std::vector<const Real*> columns;
+
+    /// The checksums of the values of the columns of the table.
+    std::vector<std::uint64_t> checksums;
+
+    /// Construct an Impl instance by mapping a table file into memory.
+    explicit Impl(const std::string& path)
+    : path(path), mapping(path)
+    {
+        const auto data = mapping.data;
+        const auto size = mapping.size;
+
+        error(size < sizeof(TableFileHeader), "Could not open table file `", path, "`, which is too small to be a table file.");
+
+        TableFileHeader header;
+        std::memcpy(&header, data, sizeof(header));
+
+        error(std::memcmp(header.magic, table_file_magic, sizeof(header.magic)) != 0, "Could not open table file `", path, "`, which is not a table file.");
+        error(header.byte_order != table_file_byte_order, "Could not open table file `", path, "`, which was written on a machine with a different byte order.");
+        error(header.version == 0 || header.version > tableFileVersion, "Could not open table file `", path, "` with format version ", header.version, ", since only versions up to ", tableFileVersion, " are supported.");
+        error(header.size != size, "Could not open table file `", path, "`, whose size is ", size, " bytes instead of ", header.size, " bytes. The file may be truncated.");
+        error(header.cols > (size - sizeof(TableFileHeader)) / sizeof(TableFileDescriptor), "Could not open table file `", path, "`, which is too small for its ", header.cols, " columns.");
+        error(header.alignment < tableFileAlignment || (header.alignment & (header.alignment - 1)) != 0, "Could not open table file `", path, "` with column alignment ", header.alignment, ", which must be a power of two not below ", tableFileAlignment, ".");
+
+        const auto descriptors = data + sizeof(TableFileHeader);
+
+        error(tableFileHeaderChecksum(header, descriptors, header.cols) != header.checksum, "Could not open table file `", path, "`, whose header does not agree with its checksum.");
+        error(header.rows > size / sizeof(Real), "Could not open table file `", path, "`, which is too small for its ", header.rows, " rows.");
+
+        version = header.version;
+        rows = header.rows;
+
+        const auto begin = sizeof(TableFileHeader) + header.cols * sizeof(TableFileDescriptor);
+
+        for(std::size_t i = 0; i < header.cols; ++i)
+        {
+            TableFileDescriptor descriptor;
+            std::memcpy(&descriptor, descriptors + i * sizeof(descriptor), sizeof(descriptor));
+
+            error(std::memchr(descriptor.name, '\0', sizeof(descriptor.name)) == nullptr, "Could not open table file `", path, "`, whose column ", i, " has a name without a terminating null character.");
+
+            const std::string name(descriptor.name);
+
+            error(descriptor.type != table_file_type_float64, "Could not open table file `", path, "`, whose column `", name, "` has unsupported type ", descriptor.type, ".");
+            error(descriptor.size != rows * sizeof(Real), "Could not open table file `", path, "`, whose column `", name, "` has ", descriptor.size, " bytes instead of ", rows * sizeof(Real), " bytes.");
+            error(descriptor.offset % header.alignment != 0 || descriptor.offset < begin, "Could not open table file `", path, "`, whose column `", name, "` has invalid offset ", descriptor.offset, ".");
+            error(descriptor.offset > size || descriptor.size > size - descriptor.offset, "Could not open table file `", path, "`, whose column `", name, "` lies beyond the end of the file.");
+
+            names.push_back(name);
+            columns.push_back(reinterpret_cast<const Real*>(data + descriptor.offset));
+            checksums.push_back(descriptor.checksum);
+        }
+    }
+};
+
+TableFile::TableFile(const std::string& path)
+: pimpl(std::make_shared<const Impl>(path))
+{}
+
+TableFile::TableFile(const TableFile& other)
+: pimpl(other.pimpl)
+{}
+
+TableFile::~TableFile()
+{}
+
+auto TableFile::operator=(TableFile other) -> TableFile&
+{
+    pimpl = std::move(other.pimpl);
+    return *this;
+}
+
+auto TableFile::path() const -> const std::string&
+{
+    return pimpl->path;
+}
+
+auto TableFile::version() const -> std::uint32_t
+{
+    return pimpl->version;
+}
+
+auto TableFile::rows() const -> std::size_t
+{
+    return pimpl->rows;
+}
+
+auto TableFile::cols() const -> std::size_t
+{
+    return pimpl->columns.size();
+}
+
+auto TableFile::name(std::size_t i) const -> const std::string&
+{
+    return pimpl->names[i];
+}
+
+auto TableFile::index(const std::string& name) const -> std::size_t
+{
+    const auto& names = pimpl->names;
+    return std::find(names.begin(), names.end(), name) - names.begin();
+}
+
+auto TableFile::column(std::size_t i) const -> const Real*
+{
+    return pimpl->columns[i];
+}
+
+auto TableFile::column(const std::string& name) const -> const Real*
+{
+    const auto i = index(name);
+    error(i == cols(), "There is no column named `", name, "` in table file `", path(), "`.");
+    return column(i);
+}
+
+auto TableFile::verify() const -> bool
+{
+    for(std::size_t i = 0; i < cols(); ++i)
+        if(tableFileChecksum(pimpl->columns[i], rows() * sizeof(Real)) != pimpl->checksums[i])
+            return false;
+    return true;
+}
+
+} // namespace Fluidika
@@ -0,0 +1,140 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// C++ includes
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Fluidika includes
+#include <Fluidika/Common/Real.hpp>
+
+namespace Fluidika {
+
+/// The version of the format of the table files written by @ref writeTableFile.
+constexpr std::uint32_t tableFileVersion = 1;
+
+/// The alignment of the data of each column in a table file (in bytes).
+constexpr std::size_t tableFileAlignment = 64;
+
+/// The maximum length of the name of a column in a table file, which is stored with a terminating null character in 32 bytes.
+constexpr std::size_t tableFileMaxColumnName = 31;
+
+/// A column of a table to be written with @ref writeTableFile.
+struct TableFileColumn
+{
+    /// The name of the column, which must be unique in the table and have at most 31 characters.
+    std::string name;
+
+    /// The values of the column, one per row of the table.
+    const Real* data = nullptr;
+};
+
+/// Write a table of real values to a binary table file that can be opened with @ref TableFile.
+/// The table file contains, in this order, a header of 64 bytes, a descriptor of 64 bytes per column, and the values of each
+/// column stored contiguously, starting at an offset that is a multiple of 64 bytes. All integers and values are stored in the
+/// byte order of the machine that writes the file. The header contains:
+/// - bytes 0-7: the magic string `FLDKTAB` followed by a null character
+/// - bytes 8-11: the version of the format (currently 1)
+/// - bytes 12-15: the byte-order mark 0x01020304
+/// - bytes 16-23: the number of rows
+/// - bytes 24-27: the number of columns
+/// - bytes 28-31: the alignment of the values of the columns (64)
+/// - bytes 32-39: the size of the file (in bytes)
+/// - bytes 40-47: the checksum of the header, with these bytes set to zero, and the descriptors
+/// - bytes 48-63: reserved (zero)
+///
+/// The descriptor of each column contains:
+/// - bytes 0-31: the name of the column, terminated by a null character
+/// - bytes 32-35: the type of the values (1 for 64-bit IEEE 754 floating-point numbers)
+/// - bytes 36-39: reserved (zero)
+/// - bytes 40-47: the offset of the values from the start of the file (in bytes)
+/// - bytes 48-55: the size of the values (in bytes)
+/// - bytes 56-63: the checksum of the values
+///
+/// The checksums are the 64-bit FNV-1a hash of the data taken as a sequence of 64-bit words. The file is first written next
+/// to *path* and then renamed, so that processes that mapped a previous file with the same path keep an intact view of it.
+/// @param path The path of the table file
+/// @param rows The number of rows of the table
+/// @param columns The columns of the table
+auto writeTableFile(const std::string& path, std::size_t rows, const std::vector<TableFileColumn>& columns) -> void;
+
+/// Used to read a binary table file written with @ref writeTableFile, which is mapped into memory without copies.
+/// The file is mapped read-only and shared, so that the processes on a node that open the same file share its pages
+/// in the page cache, and only the pages that are accessed are read from disk. Opening a table file only checks its
+/// header and descriptors, whose checksum is verified, and does not read the values of its columns, whose checksums
+/// are verified with @ref verify. A table file written on a machine with a different byte order cannot be opened.
+/// Copies of a TableFile instance share the same mapping, which is released when the last of them is destroyed.
+class TableFile
+{
+public:
+    /// Construct a TableFile instance by mapping a table file into memory.
+    /// @param path The path of the table file
+    explicit TableFile(const std::string& path);
+
+    /// Construct a copy of a TableFile instance.
+    TableFile(const TableFile& other);
+
+    /// Destroy this TableFile instance.
+    ~TableFile();
+
+    /// Assign a copy of a TableFile instance to this.
+    auto operator=(TableFile other) -> TableFile&;
+
+    /// Return the path of the table file.
+    auto path() const -> const std::string&;
+
+    /// Return the version of the format of the table file.
+    auto version() const -> std::uint32_t;
+
+    /// Return the number of rows of the table.
+    auto rows() const -> std::size_t;
+
+    /// Return the number of columns of the table.
+    auto cols() const -> std::size_t;
+
+    /// Return the name of a column of the table.
+    /// @param i The index of the column
+    auto name(std::size_t i) const -> const std::string&;
+
+    /// Return the index of a column of the table with given name, or the number of columns if there is none.
+    /// @param name The name of the column
+    auto index(const std::string& name) const -> std::size_t;
+
+    /// Return the values of a column of the table, which are aligned to 64 bytes.
+    /// @param i The index of the column
+    auto column(std::size_t i) const -> const Real*;
+
+    /// Return the values of a column of the table with given name, which are aligned to 64 bytes.
+    /// @param name The name of the column, which must exist in the table
+    auto column(const std::string& name) const -> const Real*;
+
+    /// Return true if the values of all columns of the table agree with their checksums.
+    /// This reads the entire table file.
+    auto verify() const -> bool;
+
+private:
+    struct Impl;
+
+    std::shared_ptr<const Impl> pimpl;
+};
+
+} // namespace Fluidika
@@ -0,0 +1,183 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+// C++ includes
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Catch includes
+#include <catch2/catch.hpp>
+
+// Fluidika includes
+#include <Fluidika/Common/TableFile.hpp>
+#include <Fluidika/Water/WaterData.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+using namespace Fluidika;
+
+TEST_CASE("Fluidika::TableFile", "[TableFile]")
+{
+    const auto path = (std::filesystem::temp_directory_path() / "fluidika-table-file-test.bin").string();
+
+    // Overwrite the byte at given offset of the table file
+    const auto corrupt = [&](std::size_t offset)
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekg(offset);
+        const auto byte = file.get();
+        file.seekp(offset);
+        file.put(static_cast<char>(byte ^ 0x10));
+    };
+
+    SECTION("when the reference data of Wagner and Pruss (2002) is written")
+    {
+        writeWaterThermoDataSinglePhaseStateWagnerPruss(path);
+
+        const TableFile table(path);
+        const auto& data = waterThermoDataSinglePhaseStateWagnerPruss();
+
+        REQUIRE(table.path() == path);
+        REQUIRE(table.version() == tableFileVersion);
+        REQUIRE(table.rows() == data.size());
+        REQUIRE(table.cols() == 9);
+        REQUIRE(table.name(0) == "temperature");
+        REQUIRE(table.name(8) == "speed_of_sound");
+        REQUIRE(table.index("density") == 2);
+        REQUIRE(table.index("viscosity") == table.cols());
+        REQUIRE_THROWS(table.column("viscosity"));
+        REQUIRE(table.verify());
+
+        for(std::size_t i = 0; i < table.cols(); ++i)
+            REQUIRE(reinterpret_cast<std::uintptr_t>(table.column(i)) % tableFileAlignment == 0);
+
+        const auto T = table.column("temperature");
+        const auto P = table.column("pressure");
+        const auto D = table.column("density");
+        const auto cp = table.column("cp");
+
+        for(std::size_t i = 0; i < data.size(); ++i)
+        {
+            REQUIRE(T[i] == data[i].temperature);
+            REQUIRE(P[i] == data[i].pressure);
+            REQUIRE(D[i] == data[i].density);
+            REQUIRE(cp[i] == data[i].cp);
+        }
+
+        // Copies share the same mapping, which outlives the original instance
+        auto copy = std::make_unique<TableFile>(table);
+        TableFile assigned = *copy;
+        copy.reset();
+        REQUIRE(assigned.column(2) == D);
+        REQUIRE(assigned.verify());
+
+        writeWaterThermoDataSaturatedLiquidStateWagnerPruss(path);
+        REQUIRE(TableFile(path).column("density")[0] == waterThermoDataSaturatedLiquidStateWagnerPruss()[0].density);
+        REQUIRE(assigned.column(2)[0] == data[0].density); // the previous file is still mapped, since it was replaced by renaming
+    }
+
+    SECTION("when a large table is written")
+    {
+        const std::size_t rows = 1 << 20;
+
+        std::vector<Real> x(rows), y(rows);
+        for(std::size_t i = 0; i < rows; ++i)
+        {
+            x[i] = 0.5 * i;
+            y[i] = 1.0/(1.0 + i);
+        }
+
+        writeTableFile(path, rows, {{ "x", x.data() }, { "y", y.data() }});
+
+        const TableFile table(path);
+
+        REQUIRE(table.rows() == rows);
+        REQUIRE(table.cols() == 2);
+        REQUIRE(table.verify());
+        REQUIRE(table.column("x")[rows - 1] == x[rows - 1]);
+        REQUIRE(table.column("y")[rows/2] == y[rows/2]);
+        REQUIRE(std::filesystem::file_size(path) == 64 + 2*64 + rows*8 + rows*8);
+    }
+
+    SECTION("when an empty table is written")
+    {
+        writeTableFile(path, 0, {{ "x", nullptr }});
+
+        const TableFile table(path);
+
+        REQUIRE(table.rows() == 0);
+        REQUIRE(table.cols() == 1);
+        REQUIRE(table.verify());
+    }
+
+    SECTION("when invalid tables are written")
+    {
+        const Real x[] = { 1.0, 2.0 };
+
+        REQUIRE_THROWS(writeTableFile(path, 2, {{ "", x }}));
+        REQUIRE_THROWS(writeTableFile(path, 2, {{ std::string(32, 'x'), x }}));
+        REQUIRE_THROWS(writeTableFile(path, 2, {{ "x", x }, { "x", x }}));
+        REQUIRE_THROWS(writeTableFile(path, 2, {{ "x", nullptr }}));
+    }
+
+    SECTION("when a table file is corrupted")
+    {
+        writeWaterThermoDataSaturatedVaporStateWagnerPruss(path);
+
+        REQUIRE(TableFile(path).verify());
+
+        // A corrupted value is found by the verification of the checksums of the columns
+        corrupt(64 + 9*64 + 8);
+        REQUIRE_NOTHROW(TableFile(path));
+        REQUIRE_FALSE(TableFile(path).verify());
+
+        // A corrupted descriptor is found when the table file is opened
+        writeWaterThermoDataSaturatedVaporStateWagnerPruss(path);
+        corrupt(64 + 5);
+        REQUIRE_THROWS(TableFile(path));
+
+        // A file with another magic string, version or byte order is not opened
+        for(auto offset : { 0, 8, 12 })
+        {
+            writeWaterThermoDataSaturatedVaporStateWagnerPruss(path);
+            corrupt(offset);
+            REQUIRE_THROWS(TableFile(path));
+        }
+
+        // A truncated file is not opened
+        writeWaterThermoDataSaturatedVaporStateWagnerPruss(path);
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+        REQUIRE_THROWS(TableFile(path));
+
+        std::filesystem::resize_file(path, 16);
+        REQUIRE_THROWS(TableFile(path));
+
+        std::filesystem::resize_file(path, 0);
+        REQUIRE_THROWS(TableFile(path));
+    }
+
+    SECTION("when a table file does not exist")
+    {
+        std::remove(path.c_str());
+        REQUIRE_THROWS(TableFile(path));
+    }
+
+    std::remove(path.c_str());
+}
@@ -19,16 +19,24 @@
 
 // Fluidika includes
 #include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Common/Diagnostics.hpp>
 #include <Fluidika/Common/Exception.hpp>
 #include <Fluidika/Common/Real.hpp>
+#include <Fluidika/Common/Simd.hpp>
 #include <Fluidika/Common/StateOfMatter.hpp>
 #include <Fluidika/Common/StringUtils.hpp>
+#include <Fluidika/Common/TableFile.hpp>
 #include <Fluidika/Water/ElectroModels/HelgesonKirkham.hpp>
 #include <Fluidika/Water/ElectroModels/JohnsonNorton.hpp>
 #include <Fluidika/Water/ElectroModels/UematsuFranck.hpp>
 #include <Fluidika/Water/ThermoModels/HGK.hpp>
 #include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/ThermoModels/WaterAdaptiveTable.hpp>
 #include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
+#include <Fluidika/Water/ThermoModels/WaterDensityLattice.hpp>
+#include <Fluidika/Water/ThermoModels/WaterSaturationCurve.hpp>
+#include <Fluidika/Water/ThermoModels/WaterSplineTable.hpp>
+#include <Fluidika/Water/ThermoModels/WaterStateTracker.hpp>
 #include <Fluidika/Water/Water.hpp>
 #include <Fluidika/Water/WaterData.hpp>
 #include <Fluidika/Water/WaterProps.hpp>
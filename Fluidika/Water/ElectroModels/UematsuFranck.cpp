@@ -17,16 +17,16 @@
 
 #include "UematsuFranck.hpp"
 
-// C++ includes
-#include <cmath>
-using std::sqrt;
-
 // Fluidika includes
 #include <Fluidika/Common/Exception.hpp>
+#include <Fluidika/Water/ElectroModels/UematsuFranckGeneric.hpp>
 #include <Fluidika/Water/WaterProps.hpp>
 
 namespace Fluidika {
 
+// The double instantiation of the generic function
+template auto generic::waterElectroPropsUematsuFranck(const WaterThermoPropsBase<Real>& wtp, const UematsuFranckParams& params) -> WaterElectroPropsBase<Real>;
+
 auto waterElectroPropsUematsuFranck(const WaterThermoProps& wtp) -> WaterElectroProps
 {
     // Temperature and pressure for electrostatic properties calculation
@@ -66,69 +66,7 @@ auto waterElectroPropsUematsuFranck(const WaterThermoProps& wtp) -> WaterElectro
 
 auto waterElectroPropsUematsuFranck(const WaterThermoProps& wtp, const UematsuFranckParams& params) -> WaterElectroProps
 {
-	const auto& A1 = params.A1;
-	const auto& A2 = params.A2;
-	const auto& A3 = params.A3;
-	const auto& A4 = params.A4;
-	const auto& A5 = params.A5;
-	const auto& A6 = params.A6;
-	const auto& A7 = params.A7;
-	const auto& A8 = params.A8;
-	const auto& A9 = params.A9;
-	const auto& A10 = params.A10;
-
-	WaterElectroProps we = {};
-
-	const auto T = wtp.temperature;
-
-	const auto alpha  = -wtp.densityT/wtp.density;
-    const auto beta   =  wtp.densityP/wtp.density;
-    const auto alphaT = -wtp.densityTT/wtp.density + alpha*alpha;
-    const auto betaT  =  wtp.densityTP/wtp.density + alpha*beta;
-    const auto betaP  =  wtp.densityPP/wtp.density - beta*beta;
-
-    // The reference density (in kg/m3) in Uematsu and Franck (1980) dielectric constant model
-    const auto Tr = 298.15;
-
-    // The reference density (in kg/m3) in Uematsu and Franck (1980) dielectric constant model
-    const auto Dr = 1000.0;
-
-	const auto t = T/Tr;
-	const auto tt = t*t;
-	const auto ttt = t*tt;
-	const auto tttt = t*ttt;
-
-	const auto r = wtp.density/Dr;
-
-	const Real k[] = { 1.0, A1/t, A2/t + A3 + A4*t, A5/t + A6*t + A7*tt, A8/tt + A9/t + A10 };
-	const Real k_t[] = { 0.0, -A1/tt, -A2/tt + A4, -A5/tt + A6 + 2*A7*t, -2*A8/ttt - A9/tt };
-	const Real k_tt[] = { 0.0, 2*A1/ttt, 2*A2/ttt, 2*A5/ttt + 2*A7, 6*A8/tttt + 2*A9/ttt };
-
-	for(auto i = 0; i <= 4; ++i)
-	{
-		const auto ri    = pow(r, i);
-		const auto ki    = k[i];
-		const auto ki_t  = k_t[i]/Tr;
-		const auto ki_tt = k_tt[i]/(Tr*Tr);
-
-		we.epsilon   += ki*ri;
-		we.epsilonT  += ri*(ki_t - i*alpha*ki);
-		we.epsilonP  += ri*ki*i*beta;
-		we.epsilonTT += ri*(ki_tt - i*(alpha*ki_t + ki*alphaT) - i*alpha*(ki_t - i*alpha*ki));
-		we.epsilonTP += ri*ki*i*beta*(ki_t/ki - i*alpha + betaT/beta);
-		we.epsilonPP += ri*ki*i*beta*(i*beta + betaP/beta);
-	}
-
-	const auto epsilon2 = we.epsilon * we.epsilon;
-
-	we.bornZ = -1.0/we.epsilon;
-	we.bornY = we.epsilonT/epsilon2;
-	we.bornQ = we.epsilonP/epsilon2;
-	we.bornU = we.epsilonTP/epsilon2 - 2.0*we.bornY*we.bornQ*we.epsilon;
-	we.bornN = we.epsilonPP/epsilon2 - 2.0*we.bornQ*we.bornQ*we.epsilon;
-	we.bornX = we.epsilonTT/epsilon2 - 2.0*we.bornY*we.bornY*we.epsilon;
-
-	return we;
+    return { generic::waterElectroPropsUematsuFranck(wtp, params) };
 }
 
 } // namespace Fluidika
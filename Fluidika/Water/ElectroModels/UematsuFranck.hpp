@@ -87,6 +87,7 @@ auto waterElectroPropsUematsuFranck(const WaterThermoProps& wtp) -> WaterElectro
 /// See equation (1) and Table 3 in Uematsu and Franck (1980).
 /// @param wtp The thermodynamic properties of water
 /// @param params The parameters in the Uematsu and Franck (1980) model
+/// @see generic::waterElectroPropsUematsuFranck
 auto waterElectroPropsUematsuFranck(const WaterThermoProps& wtp, const UematsuFranckParams& params) -> WaterElectroProps;
 
 } // namespace Fluidika
@@ -19,7 +19,9 @@
 #include <catch2/catch.hpp>
 
 // Fluidika includes
+#include <Fluidika/Common/Dual.test.hxx>
 #include <Fluidika/Water/ElectroModels/UematsuFranck.hpp>
+#include <Fluidika/Water/ElectroModels/UematsuFranckGeneric.hpp>
 #include <Fluidika/Water/ThermoModels/HGK.hpp>
 #include <Fluidika/Water/WaterProps.hpp>
 using namespace Fluidika;
@@ -71,17 +73,82 @@ TEST_CASE("Fluidika::WaterElectroModels::UematsuFranck", "[UematsuFranck]")
 
     const auto MPa = 1.0e6;
 
-    for(std::size_t i = 0; i < nt; ++i) for(std::size_t j = 0; j < np; ++j)
+    SECTION("when compared with the dielectric constants in Table 4 of Uematsu and Franck (1990)")
     {
-        const auto expected = epsilon_uematsu_franck_1990[j][i];
-        const auto P = pressures[j] * MPa; // pressure in Pa
-        const auto T = temperatures[i] + 273.15; // temperature in K
-        const auto stateofmatter = expected < 10.0 ? StateOfMatter::Gas : StateOfMatter::Liquid;
-        const auto wtp = waterThermoPropsHGK(T, P, stateofmatter);
-        const auto wep = waterElectroPropsUematsuFranck(wtp);
+        for(std::size_t i = 0; i < nt; ++i) for(std::size_t j = 0; j < np; ++j)
+        {
+            const auto expected = epsilon_uematsu_franck_1990[j][i];
+            const auto P = pressures[j] * MPa; // pressure in Pa
+            const auto T = temperatures[i] + 273.15; // temperature in K
+            const auto stateofmatter = expected < 10.0 ? StateOfMatter::Gas : StateOfMatter::Liquid;
+            const auto wtp = waterThermoPropsHGK(T, P, stateofmatter);
+            const auto wep = waterElectroPropsUematsuFranck(wtp);
 
-        const auto tol = 1e-2;
+            const auto tol = 1e-2;
 
-        CHECK(wep.epsilon == Approx(expected).epsilon(tol));
+            CHECK(wep.epsilon == Approx(expected).epsilon(tol));
+        }
+    }
+
+    SECTION("when generic scalar types are used")
+    {
+        // The parameters in Table 3 of Uematsu and Franck (1980)
+        const UematsuFranckParams params = { 0.762571e+1, 0.244003e+3, -0.140569e+3, 0.277841e+2, -0.962805e+2, 0.417909e+2, -0.102099e+2, -0.452059e+2, 0.846395e+2, -0.358644e+2 };
+
+        for(auto T : { 298.15, 423.15, 573.15, 773.15 }) for(auto P : { 1.0e+7, 1.0e+8 })
+        {
+            const auto wtp = waterThermoPropsHGK(T, P);
+            const auto wep = waterElectroPropsUematsuFranck(wtp, params);
+
+            // The state of water as dual numbers whose gradients are the derivatives with respect to temperature (dT = 1) or pressure (dT = 0) at constant pressure or temperature
+            const auto dual = [&](double dT)
+            {
+                WaterThermoPropsBase<Dual> res = {};
+                res.temperature = Dual(T, dT);
+                res.density     = Dual(wtp.density, dT ? wtp.densityT : wtp.densityP);
+                res.densityT    = Dual(wtp.densityT, dT ? wtp.densityTT : wtp.densityTP);
+                res.densityP    = Dual(wtp.densityP, dT ? wtp.densityTP : wtp.densityPP);
+                res.densityTT   = wtp.densityTT;
+                res.densityTP   = wtp.densityTP;
+                res.densityPP   = wtp.densityPP;
+                return res;
+            };
+
+            const auto wepT = generic::waterElectroPropsUematsuFranck(dual(1.0), params);
+            const auto wepP = generic::waterElectroPropsUematsuFranck(dual(0.0), params);
+
+            REQUIRE(wepT.epsilon.val == wep.epsilon);
+            REQUIRE(wepT.bornX.val == wep.bornX);
+
+            // The derivatives computed with dual numbers must match the analytical ones
+            REQUIRE(wepT.epsilon.grad  == Approx(wep.epsilonT).epsilon(1e-10));
+            REQUIRE(wepP.epsilon.grad  == Approx(wep.epsilonP).epsilon(1e-10));
+            REQUIRE(wepT.epsilonT.grad == Approx(wep.epsilonTT).epsilon(1e-10));
+            REQUIRE(wepP.epsilonT.grad == Approx(wep.epsilonTP).epsilon(1e-10));
+            REQUIRE(wepT.epsilonP.grad == Approx(wep.epsilonTP).epsilon(1e-10));
+            REQUIRE(wepP.epsilonP.grad == Approx(wep.epsilonPP).epsilon(1e-10));
+            REQUIRE(wepT.bornZ.grad    == Approx(wep.bornY).epsilon(1e-10));
+            REQUIRE(wepP.bornZ.grad    == Approx(wep.bornQ).epsilon(1e-10));
+
+#if FLUIDIKA_HAS_SIMD
+            // Every lane of a SIMD pack must match the scalar evaluation
+            WaterThermoPropsBase<RealSimd> wtps = {};
+            wtps.temperature = T;
+            wtps.density     = wtp.density;
+            wtps.densityT    = wtp.densityT;
+            wtps.densityP    = wtp.densityP;
+            wtps.densityTT   = wtp.densityTT;
+            wtps.densityTP   = wtp.densityTP;
+            wtps.densityPP   = wtp.densityPP;
+
+            const auto weps = generic::waterElectroPropsUematsuFranck(wtps, params);
+
+            for(std::size_t i = 0; i < RealSimd::size(); ++i)
+            {
+                REQUIRE(weps.epsilon[i] == Approx(wep.epsilon).epsilon(1e-14));
+                REQUIRE(weps.bornX[i] == Approx(wep.bornX).epsilon(1e-12));
+            }
+#endif
+        }
     }
 }
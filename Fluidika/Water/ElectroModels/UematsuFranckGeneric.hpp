@@ -0,0 +1,115 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// Fluidika includes
+#include <Fluidika/Common/Real.hpp>
+#include <Fluidika/Common/Simd.hpp>
+#include <Fluidika/Water/ElectroModels/UematsuFranck.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+
+namespace Fluidika {
+namespace generic {
+inline namespace FLUIDIKA_ISA_NAMESPACE {
+
+/// Calculate the electrostatic properties of water using Uematsu and Franck (1980) model with a generic scalar type.
+/// The scalar type can be a floating-point type, a pack of floating-point values (e.g., RealSimd), or any other type
+/// with the arithmetic operators (e.g., a dual number type for automatic differentiation). The parameters of the model
+/// are converted to ValueType<Scalar> before use, as in @ref waterHelmholtzPropsWagnerPruss.
+/// @param wtp The thermodynamic properties of water
+/// @param params The parameters in the Uematsu and Franck (1980) model
+/// @see Fluidika::waterElectroPropsUematsuFranck
+template<typename Scalar>
+auto waterElectroPropsUematsuFranck(const WaterThermoPropsBase<Scalar>& wtp, const UematsuFranckParams& params) -> WaterElectroPropsBase<Scalar>
+{
+    using V = ValueType<Scalar>;
+
+    const V A1  = params.A1;
+    const V A2  = params.A2;
+    const V A3  = params.A3;
+    const V A4  = params.A4;
+    const V A5  = params.A5;
+    const V A6  = params.A6;
+    const V A7  = params.A7;
+    const V A8  = params.A8;
+    const V A9  = params.A9;
+    const V A10 = params.A10;
+
+    // The reference temperature (in K) in Uematsu and Franck (1980) dielectric constant model
+    const V Tr = 298.15;
+
+    // The reference density (in kg/m3) in Uematsu and Franck (1980) dielectric constant model
+    const V Dr = 1000.0;
+
+    WaterElectroPropsBase<Scalar> we = {};
+
+    const Scalar alpha  = -wtp.densityT/wtp.density;
+    const Scalar beta   =  wtp.densityP/wtp.density;
+    const Scalar alphaT = -wtp.densityTT/wtp.density + alpha*alpha;
+    const Scalar betaT  =  wtp.densityTP/wtp.density + alpha*beta;
+    const Scalar betaP  =  wtp.densityPP/wtp.density - beta*beta;
+
+    const Scalar t = wtp.temperature/Tr;
+    const Scalar tt = t*t;
+    const Scalar ttt = t*tt;
+    const Scalar tttt = t*ttt;
+
+    const Scalar r = wtp.density/Dr;
+
+    const Scalar k[] = { V(1), A1/t, A2/t + A3 + A4*t, A5/t + A6*t + A7*tt, A8/tt + A9/t + A10 };
+    const Scalar k_t[] = { V(0), -A1/tt, -A2/tt + A4, -A5/tt + A6 + V(2)*A7*t, V(-2)*A8/ttt - A9/tt };
+    const Scalar k_tt[] = { V(0), V(2)*A1/ttt, V(2)*A2/ttt, V(2)*A5/ttt + V(2)*A7, V(6)*A8/tttt + V(2)*A9/ttt };
+
+    // The powers of the reduced density, r^i, are accumulated in the loop
+    Scalar ri = V(1);
+
+    for(auto i = 0; i <= 4; ++i)
+    {
+        const V vi = i;
+        const Scalar ki    = k[i];
+        const Scalar ki_t  = k_t[i]/Tr;
+        const Scalar ki_tt = k_tt[i]/(Tr*Tr);
+
+        we.epsilon   += ki*ri;
+        we.epsilonT  += ri*(ki_t - vi*alpha*ki);
+        we.epsilonP  += ri*ki*vi*beta;
+        we.epsilonTT += ri*(ki_tt - vi*(alpha*ki_t + ki*alphaT) - vi*alpha*(ki_t - vi*alpha*ki));
+        we.epsilonTP += ri*ki*vi*beta*(ki_t/ki - vi*alpha + betaT/beta);
+        we.epsilonPP += ri*ki*vi*beta*(vi*beta + betaP/beta);
+
+        ri *= r;
+    }
+
+    const Scalar epsilon2 = we.epsilon * we.epsilon;
+
+    we.bornZ = V(-1)/we.epsilon;
+    we.bornY = we.epsilonT/epsilon2;
+    we.bornQ = we.epsilonP/epsilon2;
+    we.bornU = we.epsilonTP/epsilon2 - V(2)*we.bornY*we.bornQ*we.epsilon;
+    we.bornN = we.epsilonPP/epsilon2 - V(2)*we.bornQ*we.bornQ*we.epsilon;
+    we.bornX = we.epsilonTT/epsilon2 - V(2)*we.bornY*we.bornY*we.epsilon;
+
+    return we;
+}
+
+// The double instantiation is compiled into the library
+extern template auto waterElectroPropsUematsuFranck(const WaterThermoPropsBase<Real>& wtp, const UematsuFranckParams& params) -> WaterElectroPropsBase<Real>;
+
+} // inline namespace FLUIDIKA_ISA_NAMESPACE
+} // namespace generic
+} // namespace Fluidika
@@ -0,0 +1,181 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "BatchKernels.hpp"
+
+// Fluidika includes
+#include <Fluidika/Water/ThermoModels/BatchKernelsGeneric.hpp>
+
+namespace Fluidika {
+namespace {
+
+#if !FLUIDIKA_HAS_SIMD
+
+/// Evaluate the Helmholtz free energy states of water with the Wagner and Pruss (2002) equation of state one at a time.
+template<typename Value, typename Result>
+auto waterHelmholtzPropsWagnerPrussSerial(std::size_t n, const Value* T, const Value* D, Result* res) -> void
+{
+    for(std::size_t k = 0; k < n; ++k)
+        res[k] = generic::wagnerpruss::extract<Result>(generic::waterHelmholtzPropsWagnerPruss(T[k], D[k]), 0);
+}
+
+/// Evaluate the Helmholtz free energy states of water with the Haar--Gallagher--Kell (1984) equation of state one at a time, storing them column by column.
+template<typename Value>
+auto waterHelmholtzPropsHGKSerial(std::size_t n, const Value* T, const Value* D, const WaterHelmholtzPropsArraysBase<Value>& res) -> void
+{
+    for(std::size_t k = 0; k < n; ++k)
+    {
+        const auto aux = generic::waterHelmholtzPropsHGK(T[k], D[k]);
+
+        res.helmholtz[k]    = aux.helmholtz;
+        res.helmholtzT[k]   = aux.helmholtzT;
+        res.helmholtzD[k]   = aux.helmholtzD;
+        res.helmholtzTT[k]  = aux.helmholtzTT;
+        res.helmholtzTD[k]  = aux.helmholtzTD;
+        res.helmholtzDD[k]  = aux.helmholtzDD;
+        res.helmholtzTTT[k] = aux.helmholtzTTT;
+        res.helmholtzTTD[k] = aux.helmholtzTTD;
+        res.helmholtzTDD[k] = aux.helmholtzTDD;
+        res.helmholtzDDD[k] = aux.helmholtzDDD;
+    }
+}
+
+/// Calculate the thermodynamic properties of water for many pairs of temperature and pressure one at a time with given temperature terms and Helmholtz functions of a model.
+/// The iterations use the Helmholtz function with derivatives up to second order until the last ones, as the single-state solvers.
+template<typename Terms, typename HelmholtzIter, typename Helmholtz>
+auto waterThermoPropsSerial(std::size_t n, const Real* T, const Real* P, const Real* D0, WaterThermoProps* res, WaterSolverStatus* status, const Terms& terms, const HelmholtzIter& helmholtziter, const Helmholtz& helmholtz) -> std::size_t
+{
+    std::size_t failures = 0;
+    for(std::size_t k = 0; k < n; ++k)
+    {
+        const auto tt = terms(T[k]);
+        const auto model = [&](const Real&, const Real& D) { return generic::wagnerpruss::extract<WaterHelmholtzProps>(helmholtz(tt, D), 0); };
+        const auto modeliter = [&](const Real&, const Real& D) { return generic::wagnerpruss::extract<WaterHelmholtzProps>(helmholtziter(tt, D), 0); };
+
+        WaterSolverResult result;
+        res[k] = generic::waterThermoProps(model, modeliter, T[k], P[k], D0[k], &result);
+
+        // The properties of the last iterate are returned if the iterations did not converge, so the status is taken from the solver
+        const auto converged = result.status == WaterSolverStatus::Converged;
+        if(status) status[k] = converged ? WaterSolverStatus::Converged : WaterSolverStatus::NotConverged;
+        failures += !converged;
+    }
+    return failures;
+}
+
+/// Calculate the densities of water for many pairs of temperature and pressure one at a time in single precision with given temperature terms and Helmholtz function of a model.
+template<typename Terms, typename HelmholtzIter>
+auto waterDensitySinglePrecisionSerial(std::size_t n, const Real* T, const Real* P, const Real* D0, Real* D, WaterSolverStatus* status, const Terms& terms, const HelmholtzIter& helmholtziter) -> std::size_t
+{
+    std::size_t failures = 0;
+    for(std::size_t k = 0; k < n; ++k)
+    {
+        const auto tt = terms(static_cast<float>(T[k]));
+        const auto model = [&](float, float D) { return generic::wagnerpruss::extract<WaterHelmholtzPropsFloat>(helmholtziter(tt, D), 0); };
+
+        auto outcome = WaterSolverStatus::Converged;
+        D[k] = generic::waterDensitySinglePrecision(model, T[k], P[k], D0[k], &outcome);
+
+        if(status) status[k] = outcome;
+        failures += outcome != WaterSolverStatus::Converged;
+    }
+    return failures;
+}
+
+auto waterThermoPropsWagnerPrussSerial(std::size_t n, const Real* T, const Real* P, const Real* D0, WaterThermoProps* res, WaterSolverStatus* status) -> std::size_t
+{
+    const auto terms = [](const Real& T) { return generic::wagnerpruss::calculateTemperatureTerms(T); };
+    const auto helmholtziter = [](const auto& tt, const Real& D) { return generic::wagnerpruss::calculateWaterHelmholtzPropsWagnerPruss<2>(tt, D); };
+    const auto helmholtz = [](const auto& tt, const Real& D) { return generic::wagnerpruss::calculateWaterHelmholtzPropsWagnerPruss<3>(tt, D); };
+    return waterThermoPropsSerial(n, T, P, D0, res, status, terms, helmholtziter, helmholtz);
+}
+
+auto waterThermoPropsHGKSerial(std::size_t n, const Real* T, const Real* P, const Real* D0, WaterThermoProps* res, WaterSolverStatus* status) -> std::size_t
+{
+    const auto terms = [](const Real& T) { return generic::hgk::calculateTemperatureTerms(T); };
+    const auto helmholtziter = [](const auto& tt, const Real& D) { return generic::hgk::calculateWaterHelmholtzPropsHGK<2>(tt, D); };
+    const auto helmholtz = [](const auto& tt, const Real& D) { return generic::hgk::calculateWaterHelmholtzPropsHGK<3>(tt, D); };
+    return waterThermoPropsSerial(n, T, P, D0, res, status, terms, helmholtziter, helmholtz);
+}
+
+auto waterDensityWagnerPrussSerial(std::size_t n, const Real* T, const Real* P, const Real* D0, Real* D, WaterSolverStatus* status) -> std::size_t
+{
+    const auto terms = [](float T) { return generic::wagnerpruss::calculateTemperatureTerms(T); };
+    const auto helmholtziter = [](const auto& tt, float D) { return generic::wagnerpruss::calculateWaterHelmholtzPropsWagnerPruss<2>(tt, D); };
+    return waterDensitySinglePrecisionSerial(n, T, P, D0, D, status, terms, helmholtziter);
+}
+
+auto waterDensityHGKSerial(std::size_t n, const Real* T, const Real* P, const Real* D0, Real* D, WaterSolverStatus* status) -> std::size_t
+{
+    const auto terms = [](float T) { return generic::hgk::calculateTemperatureTerms(T); };
+    const auto helmholtziter = [](const auto& tt, float D) { return generic::hgk::calculateWaterHelmholtzPropsHGK<2>(tt, D); };
+    return waterDensitySinglePrecisionSerial(n, T, P, D0, D, status, terms, helmholtziter);
+}
+
+#endif
+
+/// Return the batch kernels for the instruction set selected at the first call.
+auto selectWaterBatchKernels() -> const WaterBatchKernels&
+{
+    for(auto isa = cpuIsa(); isa != CpuIsa::Baseline; isa = static_cast<CpuIsa>(static_cast<int>(isa) - 1))
+        if(const auto kernels = waterBatchKernels(isa))
+            return *kernels;
+    return *waterBatchKernelsBaseline();
+}
+
+} // namespace
+
+auto waterBatchKernels() -> const WaterBatchKernels&
+{
+    static const auto& kernels = selectWaterBatchKernels();
+    return kernels;
+}
+
+auto waterBatchKernels(CpuIsa isa) -> const WaterBatchKernels*
+{
+    if(!cpuIsaSupported(isa))
+        return nullptr;
+
+    switch(isa) {
+    case CpuIsa::SSE42: return waterBatchKernelsSSE42();
+    case CpuIsa::AVX2: return waterBatchKernelsAVX2();
+    case CpuIsa::AVX512: return waterBatchKernelsAVX512();
+    case CpuIsa::Baseline:
+    default: return waterBatchKernelsBaseline();
+    }
+}
+
+auto waterBatchKernelsBaseline() -> const WaterBatchKernels*
+{
+#if FLUIDIKA_HAS_SIMD
+    return &generic::waterBatchKernels;
+#else
+    static const WaterBatchKernels kernels = {
+        waterHelmholtzPropsWagnerPrussSerial<Real, WaterHelmholtzProps>,
+        waterHelmholtzPropsWagnerPrussSerial<float, WaterHelmholtzPropsFloat>,
+        waterHelmholtzPropsHGKSerial<Real>,
+        waterHelmholtzPropsHGKSerial<float>,
+        waterThermoPropsWagnerPrussSerial,
+        waterThermoPropsHGKSerial,
+        waterDensityWagnerPrussSerial,
+        waterDensityHGKSerial,
+    };
+    return &kernels;
+#endif
+}
+
+} // namespace Fluidika
@@ -0,0 +1,79 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// C++ includes
+#include <cstddef>
+
+// Fluidika includes
+#include <Fluidika/Common/CpuIsa.hpp>
+#include <Fluidika/Common/Real.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+
+namespace Fluidika {
+
+/// The batch kernels of the water thermodynamic models compiled for one instruction set.
+/// @see CpuIsa, waterBatchKernels
+struct WaterBatchKernels
+{
+    /// The kernel of @ref waterHelmholtzPropsWagnerPrussBatch in double precision.
+    auto (*wagnerPruss)(std::size_t n, const Real* T, const Real* D, WaterHelmholtzProps* res) -> void;
+
+    /// The kernel of @ref waterHelmholtzPropsWagnerPrussBatch in single precision.
+    auto (*wagnerPrussFloat)(std::size_t n, const float* T, const float* D, WaterHelmholtzPropsFloat* res) -> void;
+
+    /// The kernel of @ref waterHelmholtzPropsHGKBatch in double precision.
+    auto (*hgk)(std::size_t n, const Real* T, const Real* D, const WaterHelmholtzPropsArraysBase<Real>& res) -> void;
+
+    /// The kernel of @ref waterHelmholtzPropsHGKBatch in single precision.
+    auto (*hgkFloat)(std::size_t n, const float* T, const float* D, const WaterHelmholtzPropsArraysBase<float>& res) -> void;
+
+    /// The kernel of @ref waterThermoPropsWagnerPrussBatch, which returns the number of states not converged.
+    auto (*wagnerPrussThermo)(std::size_t n, const Real* T, const Real* P, const Real* D0, WaterThermoProps* res, WaterSolverStatus* status) -> std::size_t;
+
+    /// The kernel of @ref waterThermoPropsHGKBatch, which returns the number of states not converged.
+    auto (*hgkThermo)(std::size_t n, const Real* T, const Real* P, const Real* D0, WaterThermoProps* res, WaterSolverStatus* status) -> std::size_t;
+
+    /// The kernel of the densities of @ref waterThermoPropsWagnerPrussBatch in single precision, which returns the number of states not converged.
+    auto (*wagnerPrussDensityFloat)(std::size_t n, const Real* T, const Real* P, const Real* D0, Real* D, WaterSolverStatus* status) -> std::size_t;
+
+    /// The kernel of the densities of @ref waterThermoPropsHGKBatch in single precision, which returns the number of states not converged.
+    auto (*hgkDensityFloat)(std::size_t n, const Real* T, const Real* P, const Real* D0, Real* D, WaterSolverStatus* status) -> std::size_t;
+};
+
+/// Return the batch kernels for the instruction set selected with @ref cpuIsa.
+auto waterBatchKernels() -> const WaterBatchKernels&;
+
+/// Return the batch kernels compiled for a given instruction set.
+/// @return The batch kernels, or nullptr if they were not compiled in this build or are not supported by the processor.
+auto waterBatchKernels(CpuIsa isa) -> const WaterBatchKernels*;
+
+/// Return the batch kernels compiled for the default target of the compiler, which are always available.
+auto waterBatchKernelsBaseline() -> const WaterBatchKernels*;
+
+/// Return the batch kernels compiled with the SSE4.2 extensions, or nullptr if they were not compiled in this build.
+auto waterBatchKernelsSSE42() -> const WaterBatchKernels*;
+
+/// Return the batch kernels compiled with the AVX2 extensions, or nullptr if they were not compiled in this build.
+auto waterBatchKernelsAVX2() -> const WaterBatchKernels*;
+
+/// Return the batch kernels compiled with the AVX-512 extensions, or nullptr if they were not compiled in this build.
+auto waterBatchKernelsAVX512() -> const WaterBatchKernels*;
+
+} // namespace Fluidika
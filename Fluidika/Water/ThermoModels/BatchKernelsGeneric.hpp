@@ -0,0 +1,100 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// Fluidika includes
+#include <Fluidika/Common/Simd.hpp>
+#include <Fluidika/Water/ThermoModels/BatchKernels.hpp>
+#include <Fluidika/Water/ThermoModels/HGKGeneric.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPrussGeneric.hpp>
+
+// Force every call in the batch kernels to be inlined, so that the code compiled for one instruction set does not
+// emit out-of-line copies of inline functions (e.g., those of the standard library) that the linker could choose
+// in place of the copies used by the other variants
+#if defined(__GNUC__) || defined(__clang__)
+#define FLUIDIKA_FLATTEN __attribute__((flatten))
+#else
+#define FLUIDIKA_FLATTEN
+#endif
+
+#if FLUIDIKA_HAS_SIMD
+
+namespace Fluidika {
+namespace generic {
+inline namespace FLUIDIKA_ISA_NAMESPACE {
+namespace batchkernels {
+
+FLUIDIKA_FLATTEN inline auto wagnerPruss(std::size_t n, const Real* T, const Real* D, WaterHelmholtzProps* res) -> void
+{
+    waterHelmholtzPropsWagnerPrussBatch<RealSimd>(n, T, D, res);
+}
+
+FLUIDIKA_FLATTEN inline auto wagnerPrussFloat(std::size_t n, const float* T, const float* D, WaterHelmholtzPropsFloat* res) -> void
+{
+    waterHelmholtzPropsWagnerPrussBatch<FloatSimd>(n, T, D, res);
+}
+
+FLUIDIKA_FLATTEN inline auto hgk(std::size_t n, const Real* T, const Real* D, const WaterHelmholtzPropsArraysBase<Real>& res) -> void
+{
+    waterHelmholtzPropsHGKBatch<RealSimd>(n, T, D, res);
+}
+
+FLUIDIKA_FLATTEN inline auto hgkFloat(std::size_t n, const float* T, const float* D, const WaterHelmholtzPropsArraysBase<float>& res) -> void
+{
+    waterHelmholtzPropsHGKBatch<FloatSimd>(n, T, D, res);
+}
+
+FLUIDIKA_FLATTEN inline auto wagnerPrussThermo(std::size_t n, const Real* T, const Real* P, const Real* D0, WaterThermoProps* res, WaterSolverStatus* status) -> std::size_t
+{
+    return waterThermoPropsWagnerPrussBatch<RealSimd>(n, T, P, D0, res, status);
+}
+
+FLUIDIKA_FLATTEN inline auto hgkThermo(std::size_t n, const Real* T, const Real* P, const Real* D0, WaterThermoProps* res, WaterSolverStatus* status) -> std::size_t
+{
+    return waterThermoPropsHGKBatch<RealSimd>(n, T, P, D0, res, status);
+}
+
+FLUIDIKA_FLATTEN inline auto wagnerPrussDensityFloat(std::size_t n, const Real* T, const Real* P, const Real* D0, Real* D, WaterSolverStatus* status) -> std::size_t
+{
+    return waterDensityWagnerPrussBatch<FloatSimd>(n, T, P, D0, D, status);
+}
+
+FLUIDIKA_FLATTEN inline auto hgkDensityFloat(std::size_t n, const Real* T, const Real* P, const Real* D0, Real* D, WaterSolverStatus* status) -> std::size_t
+{
+    return waterDensityHGKBatch<FloatSimd>(n, T, P, D0, D, status);
+}
+
+} // namespace batchkernels
+
+/// The batch kernels compiled for the instruction set of the current translation unit (see FLUIDIKA_ISA_NAMESPACE).
+inline const WaterBatchKernels waterBatchKernels = {
+    batchkernels::wagnerPruss,
+    batchkernels::wagnerPrussFloat,
+    batchkernels::hgk,
+    batchkernels::hgkFloat,
+    batchkernels::wagnerPrussThermo,
+    batchkernels::hgkThermo,
+    batchkernels::wagnerPrussDensityFloat,
+    batchkernels::hgkDensityFloat,
+};
+
+} // inline namespace FLUIDIKA_ISA_NAMESPACE
+} // namespace generic
+} // namespace Fluidika
+
+#endif
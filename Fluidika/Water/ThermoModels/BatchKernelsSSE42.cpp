@@ -0,0 +1,38 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+// The kernels in this file are compiled with the SSE4.2 extensions (see Fluidika/CMakeLists.txt),
+// inside their own inline namespace so that none of their instantiations is shared with the other variants
+#define FLUIDIKA_ISA_NAMESPACE isa_sse42
+
+#include "BatchKernels.hpp"
+
+// Fluidika includes
+#include <Fluidika/Water/ThermoModels/BatchKernelsGeneric.hpp>
+
+namespace Fluidika {
+
+auto waterBatchKernelsSSE42() -> const WaterBatchKernels*
+{
+#if FLUIDIKA_HAS_SIMD && defined(__SSE4_2__)
+    return &generic::waterBatchKernels;
+#else
+    return nullptr;
+#endif
+}
+
+} // namespace Fluidika
@@ -18,425 +18,287 @@
 #include "HGK.hpp"
 
 // C++ includes
-#include <cmath>
-using std::log;
-using std::pow;
+#include <array>
+#include <memory>
+#include <vector>
 
 // Fluidika includes
 #include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Common/Exception.hpp>
 #include <Fluidika/Common/Real.hpp>
+#include <Fluidika/Common/Simd.hpp>
+#include <Fluidika/Water/ThermoModels/BatchKernels.hpp>
+#include <Fluidika/Water/ThermoModels/HGKGeneric.hpp>
 #include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/ThermoModels/UtilsGeneric.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
 #include <Fluidika/Water/WaterProps.hpp>
 
 namespace Fluidika {
-namespace {
-
-//=================================================================================================
-// Reference constants as given in Kestin et al (1984)
-//=================================================================================================
 
-// Reference temperature of water (in unit of K) --- Eq. (4.1)
-const double referenceTemperature = 647.27;
+// The double instantiations of the generic functions
+template auto generic::waterHelmholtzPropsHGK(const Real& T, const Real& D) -> WaterHelmholtzPropsBase<Real>;
+template auto generic::waterHelmholtzPropsHGKUpToOrder<0>(const Real& T, const Real& D) -> WaterHelmholtzPropsBase<Real>;
+template auto generic::waterHelmholtzPropsHGKUpToOrder<1>(const Real& T, const Real& D) -> WaterHelmholtzPropsBase<Real>;
+template auto generic::waterHelmholtzPropsHGKUpToOrder<2>(const Real& T, const Real& D) -> WaterHelmholtzPropsBase<Real>;
+template auto generic::waterHelmholtzPropsHGKUpToOrder<3>(const Real& T, const Real& D) -> WaterHelmholtzPropsBase<Real>;
 
-// Reference density of water (in unit of kg/m3) --- Eq. (4.2)
-const double referenceDensity = 317.763;
+namespace {
 
-// Reference pressure of water (in unit of Pa) --- Eq. (4.3)
-const double referencePressure = 22.115e+06;
+using generic::hgk::TemperatureTerms;
+using generic::hgk::calculateTemperatureTerms;
+using generic::hgk::calculateWaterHelmholtzPropsHGK;
 
-// Reference viscosity of water (in unit of Pa*s) --- Eq. (4.4)
-const double referenceViscosity = 55.071e-06;
+/// Return the Helmholtz free energy properties of water stored in a given lane of the evaluated states.
+template<typename Result, typename Scalar>
+auto extract(const WaterHelmholtzPropsBase<Scalar>& aux, std::size_t i) -> Result
+{
+    Result res;
+    res.helmholtz    = lane(aux.helmholtz, i);
+    res.helmholtzT   = lane(aux.helmholtzT, i);
+    res.helmholtzD   = lane(aux.helmholtzD, i);
+    res.helmholtzTT  = lane(aux.helmholtzTT, i);
+    res.helmholtzTD  = lane(aux.helmholtzTD, i);
+    res.helmholtzDD  = lane(aux.helmholtzDD, i);
+    res.helmholtzTTT = lane(aux.helmholtzTTT, i);
+    res.helmholtzTTD = lane(aux.helmholtzTTD, i);
+    res.helmholtzTDD = lane(aux.helmholtzTDD, i);
+    res.helmholtzDDD = lane(aux.helmholtzDDD, i);
+    return res;
+}
 
-// Reference thermal conductivity of water (in unit of W/(K*m)) --- Eq. (4.5)
-const double referenceThermalConductivity = 0.49450;
+/// Return the function that evaluates the equation of state with partial derivatives up to a given order at the temperature of given terms.
+template<int order>
+auto isothermModel(const TemperatureTerms<Real>& terms)
+{
+    return [&terms](RealConstRef, RealConstRef D) { return extract<WaterHelmholtzProps>(calculateWaterHelmholtzPropsHGK<order>(terms, D), 0); };
+}
 
-// Reference surface tension of water (in unit of N/m) --- Eq. (4.6)
-const double referenceSurfaceTension = 235.8e-3;
+} // namespace
 
-// Reference constant for Helmholtz function (in unit of J/kg) --- Eq. (4.7)
-const double referenceHelmholtz = 69595.89;
+auto waterHelmholtzPropsHGK(RealConstRef T, RealConstRef D) -> WaterHelmholtzProps
+{
+    return extract<WaterHelmholtzProps>(generic::waterHelmholtzPropsHGK(T, D), 0);
+}
 
-// Reference constant for entropy specific heat (in unit of J/(kg*K)) --- Eq. (4.8)
-const double referenceEntropy = 107.5222;
+template<int order>
+auto waterHelmholtzPropsHGKUpToOrder(RealConstRef T, RealConstRef D) -> WaterHelmholtzProps
+{
+    return extract<WaterHelmholtzProps>(generic::waterHelmholtzPropsHGKUpToOrder<order>(T, D), 0);
+}
 
-// Reference constant for sound speed (in unit of m/s) --- Eq. (4.9)
-const double referenceSoundSpeed = 263.810;
+template auto waterHelmholtzPropsHGKUpToOrder<0>(RealConstRef T, RealConstRef D) -> WaterHelmholtzProps;
+template auto waterHelmholtzPropsHGKUpToOrder<1>(RealConstRef T, RealConstRef D) -> WaterHelmholtzProps;
+template auto waterHelmholtzPropsHGKUpToOrder<2>(RealConstRef T, RealConstRef D) -> WaterHelmholtzProps;
+template auto waterHelmholtzPropsHGKUpToOrder<3>(RealConstRef T, RealConstRef D) -> WaterHelmholtzProps;
 
-const double A0[] =
+auto waterHelmholtzPropsHGKFloat(float T, float D) -> WaterHelmholtzPropsFloat
 {
-	-0.130840393653E+2,
-	-0.857020420940E+2,
-	 0.765192919131E-2,
-	-0.620600116069E+0,
-	-0.106924329402E+2,
-	-0.280671377296E+1,
-	 0.119843634845E+3,
-	-0.823907389256E+2,
-	 0.555864146443E+2,
-	-0.310698122980E+2,
-	 0.136200239305E+2,
-	-0.457116129409E+1,
-	 0.115382128188E+1,
-	-0.214242224683E+0,
-	 0.282800597384E-1,
-	-0.250384152737E-2,
-	 0.132952679669E-3,
-	-0.319277411208E-5
-};
+    return extract<WaterHelmholtzPropsFloat>(calculateWaterHelmholtzPropsHGK<3>(T, D), 0);
+}
 
-const double A1[] =
+auto waterHelmholtzPropsHGKBatch(std::size_t n, const Real* T, const Real* D, const WaterHelmholtzPropsArrays& res) -> void
 {
-	 0.15383053E+1,
-	-0.81048367E+0,
-	-0.68305748E+1,
-	 0.00000000E+0,
-	 0.86756271E+0
-};
+    waterBatchKernels().hgk(n, T, D, res);
+}
 
-const double A20 = 0.42923415E+1;
+auto waterHelmholtzPropsHGKBatch(std::size_t n, const float* T, const float* D, const WaterHelmholtzPropsArraysFloat& res) -> void
+{
+    waterBatchKernels().hgkFloat(n, T, D, res);
+}
 
-const double yc[] =
+struct HGKIsotherm::Impl
 {
-	 0.59402227E-1,
-	-0.28128238E-1,
-	 0.56826674E-3,
-	-0.27987451E-3
+    /// The contributions to the equation of state that depend only on temperature.
+    TemperatureTerms<Real> terms;
+
+    /// Construct a HGKIsotherm::Impl instance.
+    Impl(RealConstRef T)
+    : terms(calculateTemperatureTerms(T))
+    {}
 };
 
-const double z0 = 0.317763E+0;
+HGKIsotherm::HGKIsotherm(RealConstRef T)
+: pimpl(new Impl(T))
+{}
 
-const int ki[] =
-{
-	1,	1,	1,	1,	2,	2,	2,	2,
-	3,	3,	3,	3,	4,	4,	4,	4,
-	5,	5,	5,	5,	6,	6,	6,	6,
-	7,	7,	7,	7,	9,	9,	9,	9,
-	3,	3,	1,	5
-};
+HGKIsotherm::HGKIsotherm(const HGKIsotherm& other)
+: pimpl(new Impl(*other.pimpl))
+{}
 
-const int li[] =
-{
-	1,	2,	4,	6,	1,	2,	4,	6,
-	1,	2,	4,	6,	1,	2,	4,	6,
-	1,	2,	4,	6,	1,	2,	4,	6,
-	1,	2,	4,	6,	1,	2,	4,	6,
-	0,	3,	3,	3
-};
+HGKIsotherm::~HGKIsotherm()
+{}
 
-const double A3[] =
+auto HGKIsotherm::operator=(HGKIsotherm other) -> HGKIsotherm&
 {
-	-0.76221190138079E+1,
-	 0.32661493707555E+2,
-	 0.11305763156821E+2,
-	-0.10015404767712E+1,
-	 0.12830064355028E+3,
-	-0.28371416789846E+3,
-	 0.24256279839182E+3,
-	-0.99357645626725E+2,
-	-0.12275453013171E+4,
-	 0.23077622506234E+4,
-	-0.16352219929859E+4,
-	 0.58436648297764E+3,
-	 0.42365441415641E+4,
-	-0.78027526961828E+4,
-	 0.38855645739589E+4,
-	-0.91225112529381E+3,
-	-0.90143895703666E+4,
-	 0.15196214817734E+5,
-	-0.39616651358508E+4,
-	-0.72027511617558E+3,
-	 0.11147126705990E+5,
-	-0.17412065252210E+5,
-	 0.99918281207782E+3,
-	 0.33504807153854E+4,
-	-0.64752644922631E+4,
-	 0.98323730907847E+4,
-	 0.83877854108422E+3,
-	-0.27919349903103E+4,
-	 0.11112410081192E+4,
-	-0.17287587261807E+4,
-	-0.36233262795423E+3,
-	 0.61139429010144E+3,
-	 0.32968064728562E+2,
-	 0.10411239605066E+3,
-	-0.38225874712590E+2,
-	-0.20307478607599E+3
-};
+    pimpl = std::move(other.pimpl);
+    return *this;
+}
 
-const int mi[] = { 2, 2, 2, 4 };
+auto HGKIsotherm::temperature() const -> Real
+{
+    return pimpl->terms.T;
+}
 
-const int ni[] = { 0, 2, 0, 0 };
+auto HGKIsotherm::evaluate(RealConstRef D) const -> WaterHelmholtzProps
+{
+    return extract<WaterHelmholtzProps>(calculateWaterHelmholtzPropsHGK<3>(pimpl->terms, D), 0);
+}
 
-const double alpha[] = { 34, 40, 30, 1050 };
+template<int order>
+auto HGKIsotherm::evaluate(RealConstRef D) const -> WaterHelmholtzProps
+{
+    return extract<WaterHelmholtzProps>(calculateWaterHelmholtzPropsHGK<order>(pimpl->terms, D), 0);
+}
 
-const double beta[] = { 20000, 20000, 40000, 25 };
+template auto HGKIsotherm::evaluate<0>(RealConstRef D) const -> WaterHelmholtzProps;
+template auto HGKIsotherm::evaluate<1>(RealConstRef D) const -> WaterHelmholtzProps;
+template auto HGKIsotherm::evaluate<2>(RealConstRef D) const -> WaterHelmholtzProps;
+template auto HGKIsotherm::evaluate<3>(RealConstRef D) const -> WaterHelmholtzProps;
 
-const double ri[] =
+auto waterThermoPropsHGK(RealConstRef T, RealConstRef P, RealConstRef D0) -> WaterThermoProps
 {
-	0.10038928E+1,
-	0.10038928E+1,
-	0.10038928E+1,
-	0.48778492E+1
-};
+    const auto terms = calculateTemperatureTerms(T);
+    const auto model = isothermModel<3>(terms);
+    const auto modeliter = isothermModel<2>(terms);
+    return generic::waterThermoProps(model, modeliter, T, P, D0);
+}
 
-const double ti[] =
+auto waterThermoPropsHGK(RealConstRef T, RealConstRef P, RealConstRef D0, WaterDensityMethod method) -> WaterThermoProps
 {
-	0.98876821E+0,
-	0.98876821E+0,
-	0.99124013E+0,
-	0.41713659E+0
-};
+    WaterSolverResult result;
+    return waterThermoPropsHGK(T, P, D0, method, result);
+}
 
-const double A4[] =
+auto waterThermoPropsHGK(RealConstRef T, RealConstRef P, RealConstRef D0, WaterDensityMethod method, WaterSolverResult& result) -> WaterThermoProps
 {
-	-0.32329494E-2,
-	-0.24139355E-1,
-	 0.79027651E-3,
-	-0.13362857E+1
-};
+    const auto terms = calculateTemperatureTerms(T);
+    const auto model = isothermModel<3>(terms);
+    const auto modeliter = isothermModel<2>(terms);
 
-auto calculateWaterHelmholtzPropsHGK0(RealConstRef t) -> WaterHelmholtzProps
-{
-	WaterHelmholtzProps s = {};
+    if(method == WaterDensityMethod::Newton)
+        return generic::waterThermoProps(model, modeliter, T, P, D0, &result);
 
-	const auto ln_t = log(t);
+    if(method == WaterDensityMethod::Halley)
+        return generic::waterThermoPropsHalley(model, T, P, D0, &result);
 
-	s.helmholtz    = (A0[0] + A0[1] * t) * ln_t;
-	s.helmholtzT   =  A0[0]/t + A0[1]*(ln_t + 1);
-	s.helmholtzTT  = -A0[0]/(t*t) + A0[1]/t;
-	s.helmholtzTTT =  2*A0[0]/(t*t*t) - A0[1]/(t*t);
+    return generic::waterThermoPropsSafeguarded(model, modeliter, T, P, D0, &result);
+}
 
-	for(int i = 2; i <= 17; ++i)
-	{
-		const auto aux = A0[i] * pow(t, i - 4);
+auto waterThermoPropsHGK(RealConstRef T, RealConstRef P, WaterDensityMethod method) -> WaterThermoProps
+{
+    return waterThermoPropsHGK(T, P, waterDensityInitialGuess(T, P), method);
+}
 
-		s.helmholtz    += aux;
-		s.helmholtzT   += aux * (i - 4)/t;
-		s.helmholtzTT  += aux * (i - 4)*(i - 5)/(t*t);
-		s.helmholtzTTT += aux * (i - 4)*(i - 5)*(i - 6)/(t*t*t);
-	}
+auto waterThermoPropsHGKBatch(std::size_t n, const Real* T, const Real* P, const Real* D0, WaterThermoProps* res, WaterSolverStatus* status) -> void
+{
+    const auto failures = waterBatchKernels().hgkThermo(n, T, P, D0, res, status);
 
-	return s;
+    warning(failures > 0, "The calculation of water density did not converge for ", failures, " of ", n, " states.");
 }
 
-auto calculateWaterHelmholtzPropsHGK1(RealConstRef t, RealConstRef d) -> WaterHelmholtzProps
+auto waterThermoPropsHGKBatch(std::size_t n, const Real* T, const Real* P, const Real* D0, WaterThermoProps* res, WaterSolverStatus* status, WaterPrecision precision) -> void
 {
-	WaterHelmholtzProps s = {};
+    if(precision == WaterPrecision::Double)
+        return waterThermoPropsHGKBatch(n, T, P, D0, res, status);
 
-	for(int i = 0; i <= 4; ++i)
-	{
-		const auto aux = d * A1[i] * pow(t, 1 - i);
+    // The densities calculated in single-precision packs
+    std::vector<Real> D(n);
 
-		s.helmholtz    += aux;
-		s.helmholtzT   -= aux * (i - 1)/t;
-		s.helmholtzTT  += aux * (i - 1)*i/(t*t);
-		s.helmholtzTTT -= aux * (i - 1)*i*(i + 1)/(t*t*t);
-	}
+    if(precision == WaterPrecision::Mixed)
+    {
+        // Refine the single-precision densities with double-precision Newton iterations, starting from the initial guesses where those did not converge
+        std::vector<WaterSolverStatus> single(n);
+        waterBatchKernels().hgkDensityFloat(n, T, P, D0, D.data(), single.data());
 
-	s.helmholtzD   = s.helmholtz/d;
-	s.helmholtzTD  = s.helmholtzT/d;
-	s.helmholtzTTD = s.helmholtzTT/d;
+        for(std::size_t i = 0; i < n; ++i)
+            if(single[i] != WaterSolverStatus::Converged)
+                D[i] = D0[i];
 
-	return s;
+        return waterThermoPropsHGKBatch(n, T, P, D.data(), res, status);
+    }
+
+    const auto failures = waterBatchKernels().hgkDensityFloat(n, T, P, D0, D.data(), status);
+
+    for(std::size_t i = 0; i < n; ++i)
+        res[i] = waterThermoProps(T[i], D[i], waterHelmholtzPropsHGK(T[i], D[i]));
+
+    warning(failures > 0, "The calculation of water density in single precision did not converge for ", failures, " of ", n, " states.");
 }
 
-auto calculateWaterHelmholtzPropsHGK2(RealConstRef t, RealConstRef d) -> WaterHelmholtzProps
+auto waterThermoPropsHGKBatch(std::size_t n, const Real* T, const Real* P, WaterThermoProps* res, WaterSolverStatus* status) -> void
 {
-	WaterHelmholtzProps s = {};
-
-	const auto t3   = pow(t, -3);
-	const auto t5   = pow(t, -5);
-	const auto ln_t = log(t);
-
-	const auto y     = d * (yc[0] + yc[1]*ln_t + yc[2]*t3 + yc[3]*t5);
-	const auto y_r   = y/d;
-	const auto y_t   = d * (yc[1] - 3.0*yc[2]*t3 - 5.0*yc[3]*t5)/t;
-	const auto y_rr  = 0.0;
-	const auto y_tt  = d * (-yc[1] + 12.0*yc[2]*t3 + 30.0*yc[3]*t5)/(t*t);
-	const auto y_rt  = y_t/d;
-	const auto y_rrr = 0.0;
-	const auto y_rrt = y_rt/d - y_t/(d*d);
-	const auto y_rtt = y_tt/d;
-	const auto y_ttt = d * (2*yc[1] - 60*yc[2]*t3 - 210*yc[3]*t5)/(t*t*t);
-
-	const auto x    = 1.0/(1.0 - y);
-	const auto x2   = x * x;
-	const auto x_r  = y_r * x2;
-	const auto x_t  = y_t * x2;
-	const auto x_rr = y_rr * x2 + 2.0 * y_r * x_r * x;
-	const auto x_tt = y_tt * x2 + 2.0 * y_t * x_t * x;
-	const auto x_rt = y_rt * x2 + 2.0 * y_r * x_t * x;
-	const auto x_rrr = y_rrr*x2 + 4*y_rr*x_r*x + 2*y_r*(x_rr*x + x_r*x_r);
-	const auto x_rrt = y_rrt*x2 + 2*(y_rt*x_r + y_rr*x_t) + 2*y_r*(x_rt*x + x_r*x_t);
-	const auto x_rtt = y_rtt*x2 + 4*y_rt*x_t*x + 2*y_r*(x_tt*x + x_t*x_t);
-	const auto x_ttt = y_ttt*x2 + 4*y_tt*x_t*x + 2*y_t*(x_tt*x + x_t*x_t);
-
-	const auto u     = log(d * x);
-	const auto u_r   = x_r/x + 1.0/d;
-	const auto u_t   = x_t/x;
-	const auto u_rr  = x_rr/x - x_r*x_r/(x*x) - 1.0/(d*d);
-	const auto u_rt  = x_rt/x - x_r*x_t/(x*x);
-	const auto u_tt  = x_tt/x - x_t*x_t/(x*x);
-	const auto u_rrr = x_rrr/x - 3*x_rr*x_r/(x*x) + 2*x_r*x_r*x_r/(x*x*x) + 2/(d*d*d);
-	const auto u_rrt = x_rrt/x - (2*x_rt*x_r + x_rr*x_t)/(x*x) + 2*x_r*x_r*x_t/(x*x*x);
-	const auto u_rtt = x_rtt/x - (2*x_rt*x_t + x_tt*x_r)/(x*x) + 2*x_t*x_t*x_r/(x*x*x);
-	const auto u_ttt = x_ttt/x - 3*x_tt*x_t/(x*x) + 2*x_t*x_t*x_t/(x*x*x);
-
-	const auto c1 = -130.0/3.0;
-	const auto c2 =  169.0/6.0;
-	const auto c3 = -14.0;
-
-	s.helmholtz    = A20 * t * (u + c1*x  + c2*x*x + c3*y);
-	s.helmholtzD   = A20 * t * (u_r + c1*x_r + 2*c2*x*x_r + c3*y_r);
-	s.helmholtzT   = A20 * t * (u_t + c1*x_t + 2*c2*x*x_t + c3*y_t) + s.helmholtz/t;
-	s.helmholtzDD  = A20 * t * (u_rr + c1*x_rr + 2*c2*(x*x_rr + x_r*x_r) + c3*y_rr);
-	s.helmholtzTD  = A20 * t * (u_rt + c1*x_rt + 2*c2*(x*x_rt + x_r*x_t) + c3*y_rt) + s.helmholtzD/t;
-	s.helmholtzTT  = A20 * t * (u_tt + c1*x_tt + 2*c2*(x*x_tt + x_t*x_t) + c3*y_tt) + 2*(s.helmholtzT/t - s.helmholtz/(t*t));
-	s.helmholtzDDD = A20 * t * (u_rrr + c1*x_rrr + 2*c2*(3*x_r*x_rr + x*x_rrr) + c3*y_rrr);
-	s.helmholtzTDD = A20 * t * (u_rrt + c1*x_rrt + 2*c2*(x_t*x_rr + 2*x_r*x_rt + x*x_rrt) + c3*y_rrt) + s.helmholtzDD/t;
-	s.helmholtzTTD = A20 * t * (u_rtt + c1*x_rtt + 2*c2*(x_r*x_tt + 2*x_t*x_rt + x*x_rtt) + c3*y_rtt) + 2*(s.helmholtzTD - s.helmholtzD/t)/t;
-	s.helmholtzTTT = A20 * t * (u_ttt + c1*x_ttt + 2*c2*(3*x_t*x_tt + x*x_ttt) + c3*y_ttt) + 3*(s.helmholtzTT - 2*s.helmholtzT/t + s.helmholtz/(t*t))/t;
-
-	return s;
+    std::vector<Real> D0(n);
+    for(std::size_t i = 0; i < n; ++i)
+        D0[i] = waterDensityInitialGuess(T[i], P[i]);
+
+    waterThermoPropsHGKBatch(n, T, P, D0.data(), res, status);
 }
 
-auto calculateWaterHelmholtzPropsHGK3(RealConstRef t, RealConstRef d) -> WaterHelmholtzProps
+auto waterThermoPropsHGK(RealConstRef T, RealConstRef P, RealConstRef D0, WaterPrecision precision) -> WaterThermoProps
 {
-	WaterHelmholtzProps s = {};
-
-	const auto z     =  1 - exp(-z0 * d);
-	const auto z_r   =  z0 * (1 - z);
-	const auto z_rr  = -z0 * z_r;
-	const auto z_rrr = -z0 * z_rr;
-
-	for(int i = 0; i <= 35; ++i)
-	{
-		const auto lambda     =  A3[i] * pow(t, -li[i]) * pow(z, ki[i]);
-		const auto lambda_r   =  ki[i]*z_r*lambda/z;
-		const auto lambda_t   = -li[i]*lambda/t;
-		const auto lambda_rr  =  lambda_r*(z_rr/z_r + lambda_r/lambda - z_r/z);
-		const auto lambda_rt  =  lambda_r*lambda_t/lambda;
-		const auto lambda_tt  =  lambda_t*(lambda_t/lambda - 1.0/t);
-		const auto lambda_rrr =  lambda_rr*(z_rr/z_r + lambda_r/lambda - z_r/z) + lambda_r*(z_rrr/z_r - pow(z_rr/z_r, 2) + lambda_rr/lambda - pow(lambda_r/lambda, 2) - z_rr/z + pow(z_r/z, 2));
-		const auto lambda_rrt = -pow(lambda_r/lambda, 2)*lambda_t + (lambda_rr*lambda_t + lambda_rt*lambda_r)/lambda;
-		const auto lambda_rtt = -pow(lambda_t/lambda, 2)*lambda_r + (lambda_tt*lambda_r + lambda_rt*lambda_t)/lambda;
-		const auto lambda_ttt =  lambda_tt * (lambda_t/lambda - 1.0/t) + lambda_t*(lambda_tt/lambda - pow(lambda_t/lambda, 2) + 1.0/(t*t));
-
-		s.helmholtz    += lambda;
-		s.helmholtzD   += lambda_r;
-		s.helmholtzT   += lambda_t;
-		s.helmholtzDD  += lambda_rr;
-		s.helmholtzTD  += lambda_rt;
-		s.helmholtzTT  += lambda_tt;
-		s.helmholtzDDD += lambda_rrr;
-		s.helmholtzTDD += lambda_rrt;
-		s.helmholtzTTD += lambda_rtt;
-		s.helmholtzTTT += lambda_ttt;
-	}
-
-	return s;
+    if(precision == WaterPrecision::Double)
+        return waterThermoPropsHGK(T, P, D0);
+
+    const auto terms = calculateTemperatureTerms<float>(T);
+    const auto modeliter = [&](float, float D) { return extract<WaterHelmholtzPropsFloat>(calculateWaterHelmholtzPropsHGK<2>(terms, D), 0); };
+    WaterSolverStatus status;
+    const auto D = generic::waterDensitySinglePrecision(modeliter, T, P, D0, &status);
+
+    // Refine the single-precision density with double-precision Newton iterations, which converge in one or two steps (from the initial guess if it did not converge)
+    if(precision == WaterPrecision::Mixed)
+        return waterThermoPropsHGK(T, P, status == WaterSolverStatus::Converged ? Real(D) : D0);
+
+    return waterThermoProps(T, D, waterHelmholtzPropsHGK(T, D));
 }
 
-auto calculateWaterHelmholtzPropsHGK4(RealConstRef t, RealConstRef d) -> WaterHelmholtzProps
+auto waterThermoPropsHGK(RealConstRef T, RealConstRef P, WaterPrecision precision) -> WaterThermoProps
 {
-	WaterHelmholtzProps s = {};
-
-	for(int i = 0; i <= 3; ++i)
-	{
-		const auto delta   = (d - ri[i])/ri[i];
-		const auto tau     = (t - ti[i])/ti[i];
-		const auto delta_r = 1.0/ri[i];
-		const auto tau_t   = 1.0/ti[i];
-
-		const auto delta_m = pow(delta, mi[i]);
-		const auto delta_n = pow(delta, ni[i]);
-
-		const auto psi    = (ni[i] - alpha[i]*mi[i]*delta_m)*delta_r/delta;
-		const auto psi_r  = -(ni[i] + alpha[i]*mi[i]*(mi[i] - 1)*delta_m)*pow(delta_r/delta, 2);
-		const auto psi_rr = (2*ni[i] - alpha[i]*mi[i]*(mi[i] - 1)*(mi[i] - 2)*delta_m)*pow(delta_r/delta, 3);
-
-		const auto theta     =  A4[i]*delta_n*exp(-alpha[i]*delta_m - beta[i]*tau*tau);
-		const auto theta_r   =  psi*theta;
-		const auto theta_t   = -2*beta[i]*tau*tau_t*theta;
-		const auto theta_rr  =  psi_r*theta + psi*theta_r;
-		const auto theta_tt  =  2*beta[i]*(2*beta[i]*tau*tau - 1)*tau_t*tau_t*theta;
-		const auto theta_rt  = -2*beta[i]*tau*tau_t*theta_r;
-		const auto theta_rrr =  psi_rr*theta + 2*psi_r*theta_r + psi*theta_rr;
-		const auto theta_rrt =  psi_r*theta_r + psi*theta_rt;
-		const auto theta_rtt =  psi*theta_tt;
-		const auto theta_ttt = -2*beta[i]*(2*tau_t*tau_t*theta_t + tau*tau_t*theta_tt);
-
-		s.helmholtz    += theta;
-		s.helmholtzD   += theta_r;
-		s.helmholtzT   += theta_t;
-		s.helmholtzDD  += theta_rr;
-		s.helmholtzTD  += theta_rt;
-		s.helmholtzTT  += theta_tt;
-		s.helmholtzDDD += theta_rrr;
-		s.helmholtzTDD += theta_rrt;
-		s.helmholtzTTD += theta_rtt;
-		s.helmholtzTTT += theta_ttt;
-	}
-
-	return s;
+    return waterThermoPropsHGK(T, P, waterDensityInitialGuess(T, P), precision);
 }
 
-} // namespace
+auto waterThermoPropsHGK(RealConstRef T, RealConstRef P) -> WaterThermoProps
+{
+    return waterThermoPropsHGK(T, P, waterDensityInitialGuess(T, P));
+}
 
-auto waterHelmholtzPropsHGK(RealConstRef T, RealConstRef D) -> WaterHelmholtzProps
+auto waterThermoPropsHGK(RealConstRef T, RealConstRef P, StateOfMatter stateofmatter) -> WaterThermoProps
 {
-	// The dimensionless temperature and density
-	const auto t = T/referenceTemperature;
-	const auto r = D/referenceDensity;
-
-	// Compute the contributions from each auxiliary Helmholtz state
-	WaterHelmholtzProps aux0, aux1, aux2, aux3, aux4, res;
-	aux0 = calculateWaterHelmholtzPropsHGK0(t);
-	aux1 = calculateWaterHelmholtzPropsHGK1(t, r);
-	aux2 = calculateWaterHelmholtzPropsHGK2(t, r);
-	aux3 = calculateWaterHelmholtzPropsHGK3(t, r);
-	aux4 = calculateWaterHelmholtzPropsHGK4(t, r);
-
-	// Assemble the contributions from each auxiliary Helmholtz state
-	res.helmholtz    = aux0.helmholtz    + aux1.helmholtz    + aux2.helmholtz    + aux3.helmholtz    + aux4.helmholtz;
-	res.helmholtzD   = aux0.helmholtzD   + aux1.helmholtzD   + aux2.helmholtzD   + aux3.helmholtzD   + aux4.helmholtzD;
-	res.helmholtzT   = aux0.helmholtzT   + aux1.helmholtzT   + aux2.helmholtzT   + aux3.helmholtzT   + aux4.helmholtzT;
-	res.helmholtzDD  = aux0.helmholtzDD  + aux1.helmholtzDD  + aux2.helmholtzDD  + aux3.helmholtzDD  + aux4.helmholtzDD;
-	res.helmholtzTD  = aux0.helmholtzTD  + aux1.helmholtzTD  + aux2.helmholtzTD  + aux3.helmholtzTD  + aux4.helmholtzTD;
-	res.helmholtzTT  = aux0.helmholtzTT  + aux1.helmholtzTT  + aux2.helmholtzTT  + aux3.helmholtzTT  + aux4.helmholtzTT;
-	res.helmholtzDDD = aux0.helmholtzDDD + aux1.helmholtzDDD + aux2.helmholtzDDD + aux3.helmholtzDDD + aux4.helmholtzDDD;
-	res.helmholtzTDD = aux0.helmholtzTDD + aux1.helmholtzTDD + aux2.helmholtzTDD + aux3.helmholtzTDD + aux4.helmholtzTDD;
-	res.helmholtzTTD = aux0.helmholtzTTD + aux1.helmholtzTTD + aux2.helmholtzTTD + aux3.helmholtzTTD + aux4.helmholtzTTD;
-	res.helmholtzTTT = aux0.helmholtzTTT + aux1.helmholtzTTT + aux2.helmholtzTTT + aux3.helmholtzTTT + aux4.helmholtzTTT;
-
-	// Convert the Helmholtz free energy of water and its derivatives to dimensioned form
-	res.helmholtz    *= referenceHelmholtz;
-	res.helmholtzD   *= referenceHelmholtz/referenceDensity;
-	res.helmholtzT   *= referenceHelmholtz/referenceTemperature;
-	res.helmholtzDD  *= referenceHelmholtz/referenceDensity/referenceDensity;
-	res.helmholtzTD  *= referenceHelmholtz/referenceDensity/referenceTemperature;
-	res.helmholtzTT  *= referenceHelmholtz/referenceTemperature/referenceTemperature;
-	res.helmholtzDDD *= referenceHelmholtz/referenceDensity/referenceDensity/referenceDensity;
-	res.helmholtzTDD *= referenceHelmholtz/referenceDensity/referenceDensity/referenceTemperature;
-	res.helmholtzTTD *= referenceHelmholtz/referenceDensity/referenceTemperature/referenceTemperature;
-	res.helmholtzTTT *= referenceHelmholtz/referenceTemperature/referenceTemperature/referenceTemperature;
-
-	return res;
+    return waterThermoPropsHGK(T, P, waterDensityInitialGuess(T, P, stateofmatter));
 }
 
-auto waterThermoPropsHGK(RealConstRef T, RealConstRef P, RealConstRef D0) -> WaterThermoProps
+auto waterSaturationPropsHGK(RealConstRef T) -> WaterSaturationProps
 {
-    return waterThermoProps(waterHelmholtzPropsHGK, T, P, D0);
+    WaterSolverResult result;
+    return waterSaturationPropsHGK(T, result);
 }
 
-auto waterThermoPropsHGK(RealConstRef T, RealConstRef P) -> WaterThermoProps
+auto waterSaturationPropsHGK(RealConstRef T, WaterSolverResult& result) -> WaterSaturationProps
 {
-    return waterThermoProps(waterHelmholtzPropsHGK, T, P);
+    const auto terms = calculateTemperatureTerms(T);
+    const auto model = isothermModel<2>(terms);
+    const auto Dl0 = waterDensitySaturatedLiquidStateWagnerPruss(T);
+    const auto Dv0 = waterDensitySaturatedVaporStateWagnerPruss(T);
+    return generic::waterSaturationProps(model, T, Dl0, Dv0, &result);
 }
 
-auto waterThermoPropsHGK(RealConstRef T, RealConstRef P, StateOfMatter stateofmatter) -> WaterThermoProps
+auto waterSaturationPropsHGKBatch(std::size_t n, const Real* T, WaterSaturationProps* res, WaterSolverStatus* status) -> void
 {
-    return waterThermoProps(waterHelmholtzPropsHGK, T, P, stateofmatter);
+    const auto solve = [](RealConstRef T, RealConstRef Dl0, RealConstRef Dv0, WaterSolverResult& result)
+    {
+        const auto terms = calculateTemperatureTerms(T);
+        const auto model = isothermModel<2>(terms);
+        return generic::waterSaturationPropsNewton(model, T, Dl0, Dv0, result);
+    };
+
+    const auto guess = [](RealConstRef T)
+    {
+        return std::array<Real, 2>{ waterDensitySaturatedLiquidStateWagnerPruss(T), waterDensitySaturatedVaporStateWagnerPruss(T) };
+    };
+
+    const auto failures = generic::waterSaturationPropsBatch(n, T, res, status, solve, guess);
+
+    warning(failures > 0, "The calculation of water at saturation did not converge for ", failures, " of ", n, " temperatures.");
 }
 
 } // namespace Fluidika
@@ -17,6 +17,10 @@
 
 #pragma once
 
+// C++ includes
+#include <cstddef>
+#include <memory>
+
 // Fluidika includes
 #include <Fluidika/Common/Real.hpp>
 #include <Fluidika/Common/StateOfMatter.hpp>
@@ -25,7 +29,15 @@ namespace Fluidika {
 
 // Forward declarations
 struct WaterHelmholtzProps;
+struct WaterHelmholtzPropsArrays;
+struct WaterHelmholtzPropsArraysFloat;
+struct WaterHelmholtzPropsFloat;
+struct WaterSaturationProps;
+struct WaterSolverResult;
 struct WaterThermoProps;
+enum class WaterDensityMethod;
+enum class WaterPrecision;
+enum class WaterSolverStatus;
 
 /// Calculate the Helmholtz free energy state of water using the Haar--Gallagher--Kell (1984) equation of state
 /// @param T The temperature of water (in units of K)
@@ -34,6 +46,83 @@ struct WaterThermoProps;
 /// @see WaterHelmholtzProps
 auto waterHelmholtzPropsHGK(RealConstRef T, RealConstRef D) -> WaterHelmholtzProps;
 
+/// Calculate the Helmholtz free energy state of water using the Haar--Gallagher--Kell (1984) equation of state with partial derivatives up to a given order.
+/// Only the fields of WaterHelmholtzProps whose derivative order is not greater than *order* are computed, and the others are set to zero.
+/// @tparam order The highest order of the partial derivatives to be computed (0, 1, 2 or 3)
+/// @param T The temperature of water (in units of K)
+/// @param D The density of water (in units of kg/m3)
+/// @return The Helmholtz free energy state of water
+/// @see WaterHelmholtzProps, waterHelmholtzPropsHGK
+template<int order>
+auto waterHelmholtzPropsHGKUpToOrder(RealConstRef T, RealConstRef D) -> WaterHelmholtzProps;
+
+/// Calculate the Helmholtz free energy states of water using the Haar--Gallagher--Kell (1984) equation of state for many pairs of temperature and density.
+/// The states are evaluated in packs whose size is the number of lanes in the native SIMD registers, and the results are
+/// written column by column. The five contributions of the model are accumulated together in each pack, and the 36 residual
+/// terms are evaluated as a polynomial in the density variable whose coefficients depend only on temperature.
+/// @param n The number of states to be evaluated
+/// @param T The array of temperatures of water (in units of K) with length *n*
+/// @param D The array of densities of water (in units of kg/m3) with length *n*
+/// @param[out] res The arrays of Helmholtz free energy properties of water, each with length *n*
+/// @see waterHelmholtzPropsHGK
+auto waterHelmholtzPropsHGKBatch(std::size_t n, const Real* T, const Real* D, const WaterHelmholtzPropsArrays& res) -> void;
+
+/// Calculate the Helmholtz free energy state of water using the Haar--Gallagher--Kell (1984) equation of state in single precision.
+/// @param T The temperature of water (in units of K)
+/// @param D The density of water (in units of kg/m3)
+/// @return The Helmholtz free energy state of water in single precision
+auto waterHelmholtzPropsHGKFloat(float T, float D) -> WaterHelmholtzPropsFloat;
+
+/// Calculate the Helmholtz free energy states of water using the Haar--Gallagher--Kell (1984) equation of state for many pairs of temperature and density in single precision.
+/// @param n The number of states to be evaluated
+/// @param T The array of temperatures of water (in units of K) with length *n*
+/// @param D The array of densities of water (in units of kg/m3) with length *n*
+/// @param[out] res The arrays of Helmholtz free energy properties of water, each with length *n*
+/// @see waterHelmholtzPropsHGKFloat
+auto waterHelmholtzPropsHGKBatch(std::size_t n, const float* T, const float* D, const WaterHelmholtzPropsArraysFloat& res) -> void;
+
+/// Used to evaluate the Haar--Gallagher--Kell (1984) equation of state for water at a fixed temperature and many densities.
+/// All contributions that depend only on temperature (the base function, and the temperature factors of the
+/// residual terms) are computed once at construction. Method @ref evaluate then only computes the contributions
+/// that depend on density, which makes it considerably faster than @ref waterHelmholtzPropsHGK when many densities
+/// are evaluated at the same temperature, as in the calculation of isotherms.
+class HGKIsotherm
+{
+public:
+    /// Construct a HGKIsotherm instance.
+    /// @param T The temperature of water (in units of K)
+    explicit HGKIsotherm(RealConstRef T);
+
+    /// Construct a copy of a HGKIsotherm instance.
+    HGKIsotherm(const HGKIsotherm& other);
+
+    /// Destroy this HGKIsotherm instance.
+    ~HGKIsotherm();
+
+    /// Assign a copy of a HGKIsotherm instance to this.
+    auto operator=(HGKIsotherm other) -> HGKIsotherm&;
+
+    /// Return the temperature of the isotherm (in units of K).
+    auto temperature() const -> Real;
+
+    /// Calculate the Helmholtz free energy state of water at the temperature of the isotherm.
+    /// The result is the same as that of @ref waterHelmholtzPropsHGK.
+    /// @param D The density of water (in units of kg/m3)
+    auto evaluate(RealConstRef D) const -> WaterHelmholtzProps;
+
+    /// Calculate the Helmholtz free energy state of water at the temperature of the isotherm with partial derivatives up to a given order.
+    /// The result is the same as that of @ref waterHelmholtzPropsHGKUpToOrder.
+    /// @tparam order The highest order of the partial derivatives to be computed (0, 1, 2 or 3)
+    /// @param D The density of water (in units of kg/m3)
+    template<int order>
+    auto evaluate(RealConstRef D) const -> WaterHelmholtzProps;
+
+private:
+    struct Impl;
+
+    std::unique_ptr<Impl> pimpl;
+};
+
 /// Calculate the thermodynamic properties of water using the Haar--Gallagher--Kell (1984) equation of state with given temperature, pressure and an initial guess for density.
 /// The equations of state described in Wagner and Pruss (2002) and Haar--Gallagher--Kell (1984) for calculation
 /// of thermodynamic properties of water and steam are formulated so that temperature and density are given.
@@ -48,21 +137,125 @@ auto waterHelmholtzPropsHGK(RealConstRef T, RealConstRef D) -> WaterHelmholtzPro
 auto waterThermoPropsHGK(RealConstRef T, RealConstRef P, RealConstRef D0) -> WaterThermoProps;
 
 /// Calculate the thermodynamic properties of water using the Haar--Gallagher--Kell (1984) equation of state with given temperature and pressure.
-/// This method uses an initial guess for water density obtained from Table 13.2 of Wagner and Pruss (2002)
-/// using method @ref waterThermoDataNearestWagnerPruss. Convergence should then be faster because the initial guess
-/// will most likely be fairly close to the actual water density at given temperature and pressure conditions.
+/// This method uses an initial guess for water density interpolated in Table 13.2 of Wagner and Pruss (2002) on the side of
+/// the saturation curve of the given state using method @ref waterThermoDataInterpolatedDensityWagnerPruss (or the density
+/// of @ref waterDensityLattice if enabled, see @ref waterDensityInitialGuess). Convergence should then be faster because
+/// the initial guess will most likely be fairly close to the actual water density at given temperature and pressure conditions.
 /// @param T The temperature of water (in units of K)
 /// @param P The pressure of water (in units of Pa)
 auto waterThermoPropsHGK(RealConstRef T, RealConstRef P) -> WaterThermoProps;
 
+/// Calculate the thermodynamic properties of water using the Haar--Gallagher--Kell (1984) equation of state with given temperature, pressure, initial guess for density and precision.
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param D0 The initial guess for the density of water (in units of kg/m3)
+/// @param precision The floating-point precision of the calculation
+/// @see WaterPrecision
+auto waterThermoPropsHGK(RealConstRef T, RealConstRef P, RealConstRef D0, WaterPrecision precision) -> WaterThermoProps;
+
+/// Calculate the thermodynamic properties of water using the Haar--Gallagher--Kell (1984) equation of state with given temperature, pressure and precision.
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param precision The floating-point precision of the calculation
+/// @see WaterPrecision
+auto waterThermoPropsHGK(RealConstRef T, RealConstRef P, WaterPrecision precision) -> WaterThermoProps;
+
+/// Calculate the thermodynamic properties of water using the Haar--Gallagher--Kell (1984) equation of state with given temperature, pressure, initial guess for density and iterative method.
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param D0 The initial guess for the density of water (in units of kg/m3)
+/// @param method The iterative method used to calculate density
+/// @see WaterDensityMethod
+auto waterThermoPropsHGK(RealConstRef T, RealConstRef P, RealConstRef D0, WaterDensityMethod method) -> WaterThermoProps;
+
+/// Calculate the thermodynamic properties of water using the Haar--Gallagher--Kell (1984) equation of state with given temperature, pressure, initial guess for density and iterative method, with the diagnostics of the iterations.
+/// If the iterations do not converge, the properties at the last iterate are returned, and if the input is invalid or
+/// the iterations diverge, zero properties are returned, as indicated by the status of *result*.
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param D0 The initial guess for the density of water (in units of kg/m3)
+/// @param method The iterative method used to calculate density
+/// @param[out] result The diagnostics of the iterations
+/// @see WaterDensityMethod, WaterSolverResult
+auto waterThermoPropsHGK(RealConstRef T, RealConstRef P, RealConstRef D0, WaterDensityMethod method, WaterSolverResult& result) -> WaterThermoProps;
+
+/// Calculate the thermodynamic properties of water using the Haar--Gallagher--Kell (1984) equation of state with given temperature, pressure and iterative method.
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param method The iterative method used to calculate density
+/// @see WaterDensityMethod
+auto waterThermoPropsHGK(RealConstRef T, RealConstRef P, WaterDensityMethod method) -> WaterThermoProps;
+
+/// Calculate the thermodynamic properties of water using the Haar--Gallagher--Kell (1984) equation of state for many pairs of temperature and pressure, with initial guesses for density.
+/// The Newton iterations of several states are performed together in the lanes of the native SIMD registers. Converged
+/// lanes are retired with masks, and the states that need many iterations (e.g., near saturation) are compacted into
+/// packs of their own. The results agree with those of @ref waterThermoPropsHGK to within the tolerance of the iterations.
+/// @param n The number of states to be calculated
+/// @param T The array of temperatures of water (in units of K) with length *n*
+/// @param P The array of pressures of water (in units of Pa) with length *n*
+/// @param D0 The array of initial guesses for the density of water (in units of kg/m3) with length *n*
+/// @param[out] res The array of thermodynamic properties of water with length *n* (those of the last iterate for the states not converged)
+/// @param[out] status The array of outcomes of the density calculations with length *n*, or nullptr if not needed
+auto waterThermoPropsHGKBatch(std::size_t n, const Real* T, const Real* P, const Real* D0, WaterThermoProps* res, WaterSolverStatus* status) -> void;
+
+/// Calculate the thermodynamic properties of water using the Haar--Gallagher--Kell (1984) equation of state for many pairs of temperature and pressure, with initial guesses for density and given precision.
+/// With @ref WaterPrecision::Single, the densities are calculated in single-precision packs, which have twice as many lanes
+/// as the double-precision ones, and the properties are then evaluated once in double precision at these densities.
+/// With @ref WaterPrecision::Mixed, these densities are then the initial guesses of the double-precision batch calculation.
+/// @param n The number of states to be calculated
+/// @param T The array of temperatures of water (in units of K) with length *n*
+/// @param P The array of pressures of water (in units of Pa) with length *n*
+/// @param D0 The array of initial guesses for the density of water (in units of kg/m3) with length *n*
+/// @param[out] res The array of thermodynamic properties of water with length *n* (those of the last iterate for the states not converged)
+/// @param[out] status The array of outcomes of the density calculations with length *n*, or nullptr if not needed
+/// @param precision The floating-point precision of the calculation
+/// @see WaterPrecision
+auto waterThermoPropsHGKBatch(std::size_t n, const Real* T, const Real* P, const Real* D0, WaterThermoProps* res, WaterSolverStatus* status, WaterPrecision precision) -> void;
+
+/// Calculate the thermodynamic properties of water using the Haar--Gallagher--Kell (1984) equation of state for many pairs of temperature and pressure.
+/// The initial guesses for density are obtained with @ref waterDensityInitialGuess.
+/// @param n The number of states to be calculated
+/// @param T The array of temperatures of water (in units of K) with length *n*
+/// @param P The array of pressures of water (in units of Pa) with length *n*
+/// @param[out] res The array of thermodynamic properties of water with length *n*
+/// @param[out] status The array of outcomes of the density calculations with length *n*, or nullptr if not needed
+/// @see waterThermoPropsHGKBatch
+auto waterThermoPropsHGKBatch(std::size_t n, const Real* T, const Real* P, WaterThermoProps* res, WaterSolverStatus* status) -> void;
+
 /// Calculate the thermodynamic properties of water using the Haar--Gallagher--Kell (1984) equation of state with given temperature and pressure and specific state of matter for water.
-/// This method uses an initial guess for water density obtained from Table 13.2 of Wagner and Pruss (2002)
-/// using either method @ref waterThermoDataMinTemperatureWagnerPruss if given state of matter is either liquid or solid,
-/// and method @ref waterThermoDataMaxTemperatureWagnerPruss if gas or plasma. This is to help Newton's algorithm
-/// to converge to a solution that represents the desired state of matter of water.
+/// This method uses an initial guess for water density extrapolated from the density of saturated liquid if given state of
+/// matter is either liquid or solid, and of saturated vapor if gas or plasma (see @ref waterDensitySaturationGuess).
+/// This is to help Newton's algorithm to converge to a solution that represents the desired state of matter of water.
 /// @param T The temperature of water (in units of K)
 /// @param P The pressure of water (in units of Pa)
 /// @param stateofmatter The state of matter of water.
 auto waterThermoPropsHGK(RealConstRef T, RealConstRef P, StateOfMatter stateofmatter) -> WaterThermoProps;
 
+/// Calculate the properties of water at saturation using the Haar--Gallagher--Kell (1984) equation of state with given temperature.
+/// The densities of saturated liquid and vapor water are calculated so that both phases have the same pressure and
+/// specific Gibbs free energy according to the equation of state, which makes them thermodynamically consistent with
+/// the other properties of the model, unlike the auxiliary correlations of Wagner and Pruss (2002) used as initial guesses.
+/// For repeated calculations, the spline returned by @ref waterSaturationCurve is considerably faster.
+/// @param T The temperature of water (in units of K), which must be below the critical temperature
+/// @return The properties of water at saturation
+/// @see WaterSaturationProps
+auto waterSaturationPropsHGK(RealConstRef T) -> WaterSaturationProps;
+
+/// Calculate the properties of water at saturation using the Haar--Gallagher--Kell (1984) equation of state with given temperature, with the diagnostics of the iterations.
+/// @param T The temperature of water (in units of K), which must be below the critical temperature
+/// @param[out] result The diagnostics of the iterations
+/// @return The properties of water at saturation (zero if the input is invalid or the iterations diverge)
+/// @see WaterSaturationProps, WaterSolverResult
+auto waterSaturationPropsHGK(RealConstRef T, WaterSolverResult& result) -> WaterSaturationProps;
+
+/// Calculate the properties of water at saturation using the Haar--Gallagher--Kell (1984) equation of state for many temperatures.
+/// The initial guesses of each temperature are extrapolated from the saturation properties at the previous one, if it
+/// is within 5 K, so that temperatures in ascending or descending order converge in one or two iterations.
+/// @param n The number of temperatures
+/// @param T The array of temperatures of water (in units of K) with length *n*
+/// @param[out] res The array of properties of water at saturation with length *n*
+/// @param[out] status The array of outcomes of the calculations with length *n*, or nullptr if not needed
+/// @see waterSaturationPropsHGK
+auto waterSaturationPropsHGKBatch(std::size_t n, const Real* T, WaterSaturationProps* res, WaterSolverStatus* status) -> void;
+
 } // namespace Fluidika
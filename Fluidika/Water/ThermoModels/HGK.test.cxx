@@ -17,13 +17,17 @@
 
 // C++ includes
 #include <array>
+#include <cmath>
+#include <vector>
 
 // Catch includes
 #include <catch2/catch.hpp>
 
 // Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
 #include <Fluidika/Water/ThermoModels/HGK.hpp>
 #include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
 #include <Fluidika/Water/WaterProps.hpp>
 using namespace Fluidika;
 
@@ -151,6 +155,306 @@ TEST_CASE("Fluidika::WaterThermoModels::HGK", "[HGK]")
        }
    }
 
+    SECTION("when arrays of temperature and density are given")
+    {
+        // Use an odd number of states so that the last pack is partially filled
+        std::vector<Real> T, D;
+        for(auto temperature = 280.0; temperature <= 1200.0; temperature += 40.0)
+            for(auto density = 0.1; density <= 1200.0; density *= 1.7)
+                T.push_back(temperature), D.push_back(density);
+        T.push_back(T.back()), D.push_back(D.front());
+
+        const auto n = T.size();
+
+        std::vector<Real> a(n), aT(n), aD(n), aTT(n), aTD(n), aDD(n), aTTT(n), aTTD(n), aTDD(n), aDDD(n);
+
+        WaterHelmholtzPropsArrays res;
+        res.helmholtz    = a.data();
+        res.helmholtzT   = aT.data();
+        res.helmholtzD   = aD.data();
+        res.helmholtzTT  = aTT.data();
+        res.helmholtzTD  = aTD.data();
+        res.helmholtzDD  = aDD.data();
+        res.helmholtzTTT = aTTT.data();
+        res.helmholtzTTD = aTTD.data();
+        res.helmholtzTDD = aTDD.data();
+        res.helmholtzDDD = aDDD.data();
+
+        waterHelmholtzPropsHGKBatch(n, T.data(), D.data(), res);
+
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            const auto expected = waterHelmholtzPropsHGK(T[i], D[i]);
+
+            REQUIRE(a[i]    == Approx(expected.helmholtz).epsilon(1e-12));
+            REQUIRE(aT[i]   == Approx(expected.helmholtzT).epsilon(1e-12));
+            REQUIRE(aD[i]   == Approx(expected.helmholtzD).epsilon(1e-12));
+            REQUIRE(aTT[i]  == Approx(expected.helmholtzTT).epsilon(1e-12));
+            REQUIRE(aTD[i]  == Approx(expected.helmholtzTD).epsilon(1e-12));
+            REQUIRE(aDD[i]  == Approx(expected.helmholtzDD).epsilon(1e-12));
+            REQUIRE(aTTT[i] == Approx(expected.helmholtzTTT).epsilon(1e-12));
+            REQUIRE(aTTD[i] == Approx(expected.helmholtzTTD).epsilon(1e-12));
+            REQUIRE(aTDD[i] == Approx(expected.helmholtzTDD).epsilon(1e-12));
+            REQUIRE(aDDD[i] == Approx(expected.helmholtzDDD).epsilon(1e-12));
+        }
+    }
+
+    SECTION("when only partial derivatives up to a given order are needed")
+    {
+        for(auto item : table12_kestin_et_al_1984)
+        {
+            dimensionalform(item);
+
+            const auto T = item[0];
+            const auto D = item[1];
+            const auto h  = waterHelmholtzPropsHGK(T, D);
+            const auto h0 = waterHelmholtzPropsHGKUpToOrder<0>(T, D);
+            const auto h1 = waterHelmholtzPropsHGKUpToOrder<1>(T, D);
+            const auto h2 = waterHelmholtzPropsHGKUpToOrder<2>(T, D);
+            const auto h3 = waterHelmholtzPropsHGKUpToOrder<3>(T, D);
+
+            REQUIRE(h0.helmholtz == Approx(h.helmholtz));
+            REQUIRE(h0.helmholtzT == 0.0);
+            REQUIRE(h0.helmholtzD == 0.0);
+
+            REQUIRE(h1.helmholtzT == Approx(h.helmholtzT));
+            REQUIRE(h1.helmholtzD == Approx(h.helmholtzD));
+            REQUIRE(h1.helmholtzTT == 0.0);
+            REQUIRE(h1.helmholtzTD == 0.0);
+            REQUIRE(h1.helmholtzDD == 0.0);
+
+            REQUIRE(h2.helmholtzTT == Approx(h.helmholtzTT));
+            REQUIRE(h2.helmholtzTD == Approx(h.helmholtzTD));
+            REQUIRE(h2.helmholtzDD == Approx(h.helmholtzDD));
+            REQUIRE(h2.helmholtzTTT == 0.0);
+            REQUIRE(h2.helmholtzTTD == 0.0);
+            REQUIRE(h2.helmholtzTDD == 0.0);
+            REQUIRE(h2.helmholtzDDD == 0.0);
+
+            REQUIRE(h3.helmholtzTTT == Approx(h.helmholtzTTT));
+            REQUIRE(h3.helmholtzTTD == Approx(h.helmholtzTTD));
+            REQUIRE(h3.helmholtzTDD == Approx(h.helmholtzTDD));
+            REQUIRE(h3.helmholtzDDD == Approx(h.helmholtzDDD));
+        }
+    }
+
+    SECTION("when many densities are evaluated at the same temperature")
+    {
+        for(auto item : table12_kestin_et_al_1984)
+        {
+            dimensionalform(item);
+
+            const auto T = item[0];
+            const auto D = item[1];
+            const HGKIsotherm isotherm(T);
+
+            REQUIRE(isotherm.temperature() == T);
+
+            const auto wtp = waterThermoProps(T, D, isotherm.evaluate(D));
+
+            REQUIRE(wtp.helmholtz == approx(item[2]).scale(kJ));
+            REQUIRE(wtp.pressure == approx(item[3]).scale(MPa));
+            REQUIRE(wtp.cv == approx(item[4]).scale(kJ));
+
+            for(auto factor : { 0.5, 1.0, 1.2 })
+            {
+                const auto expected = waterHelmholtzPropsHGK(T, D * factor);
+                const auto h = isotherm.evaluate(D * factor);
+                const auto h2 = isotherm.evaluate<2>(D * factor);
+
+                REQUIRE(h.helmholtz    == Approx(expected.helmholtz).epsilon(1e-12));
+                REQUIRE(h.helmholtzT   == Approx(expected.helmholtzT).epsilon(1e-12));
+                REQUIRE(h.helmholtzD   == Approx(expected.helmholtzD).epsilon(1e-12));
+                REQUIRE(h.helmholtzTT  == Approx(expected.helmholtzTT).epsilon(1e-12));
+                REQUIRE(h.helmholtzTD  == Approx(expected.helmholtzTD).epsilon(1e-12));
+                REQUIRE(h.helmholtzDD  == Approx(expected.helmholtzDD).epsilon(1e-12));
+                REQUIRE(h.helmholtzTTT == Approx(expected.helmholtzTTT).epsilon(1e-12));
+                REQUIRE(h.helmholtzTTD == Approx(expected.helmholtzTTD).epsilon(1e-12));
+                REQUIRE(h.helmholtzTDD == Approx(expected.helmholtzTDD).epsilon(1e-12));
+                REQUIRE(h.helmholtzDDD == Approx(expected.helmholtzDDD).epsilon(1e-12));
+
+                REQUIRE(h2.helmholtzDD  == Approx(expected.helmholtzDD).epsilon(1e-12));
+                REQUIRE(h2.helmholtzDDD == 0.0);
+            }
+        }
+    }
+
+    SECTION("when single-precision arithmetic is used")
+    {
+        std::vector<float> T, D;
+        for(auto temperature = 280.0f; temperature <= 1200.0f; temperature += 40.0f)
+            for(auto density = 0.1f; density <= 1200.0f; density *= 1.7f)
+                T.push_back(temperature), D.push_back(density);
+
+        const auto n = T.size();
+
+        std::vector<float> a(n), aT(n), aD(n), aTT(n), aTD(n), aDD(n), aTTT(n), aTTD(n), aTDD(n), aDDD(n);
+
+        WaterHelmholtzPropsArraysFloat res;
+        res.helmholtz    = a.data();
+        res.helmholtzT   = aT.data();
+        res.helmholtzD   = aD.data();
+        res.helmholtzTT  = aTT.data();
+        res.helmholtzTD  = aTD.data();
+        res.helmholtzDD  = aDD.data();
+        res.helmholtzTTT = aTTT.data();
+        res.helmholtzTTD = aTTD.data();
+        res.helmholtzTDD = aTDD.data();
+        res.helmholtzDDD = aDDD.data();
+
+        waterHelmholtzPropsHGKBatch(n, T.data(), D.data(), res);
+
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            const auto expected = waterHelmholtzPropsHGKFloat(T[i], D[i]);
+
+            REQUIRE(a[i]   == Approx(expected.helmholtz).epsilon(1e-5));
+            REQUIRE(aT[i]  == Approx(expected.helmholtzT).epsilon(1e-5));
+            REQUIRE(aTT[i] == Approx(expected.helmholtzTT).epsilon(1e-5));
+        }
+
+        for(auto item : table12_kestin_et_al_1984)
+        {
+            dimensionalform(item);
+
+            const auto T = item[0];
+            const auto D = item[1] * 1.2;
+            const auto P = item[3];
+            const auto expected = waterThermoPropsHGK(T, P, D);
+            const auto mixed = waterThermoPropsHGK(T, P, D, WaterPrecision::Mixed);
+            const auto single = waterThermoPropsHGK(T, P, D, WaterPrecision::Single);
+
+            // The double-precision refinement meets the tolerance of the pressure residual of the double-precision solver
+            REQUIRE(std::abs(mixed.pressure - P)/waterCriticalPressure < 1e-8);
+            REQUIRE(mixed.density == Approx(expected.density).epsilon(1e-12));
+            REQUIRE(mixed.helmholtz == Approx(expected.helmholtz).scale(kJ).epsilon(1e-6));
+
+            REQUIRE(single.density == Approx(expected.density).epsilon(1e-4));
+            REQUIRE(single.cv == approx(item[4]).scale(kJ));
+
+            // The batch calculation of a single state, in single-precision packs, agrees with the single-state one within its tolerance
+            WaterThermoProps batch;
+            waterThermoPropsHGKBatch(1, &T, &P, &D, &batch, nullptr, WaterPrecision::Single);
+
+            REQUIRE(batch.density == Approx(single.density).epsilon(2e-5));
+
+            WaterSolverStatus status;
+            waterThermoPropsHGKBatch(1, &T, &P, &D, &batch, &status, WaterPrecision::Mixed);
+
+            REQUIRE(status == WaterSolverStatus::Converged);
+            REQUIRE(std::abs(batch.pressure - P)/waterCriticalPressure < 1e-8);
+            REQUIRE(batch.density == Approx(expected.density).epsilon(1e-12));
+        }
+    }
+
+    SECTION("when temperature and pressure are given, and Halley's method is used")
+    {
+        for(auto item : table12_kestin_et_al_1984)
+        {
+            dimensionalform(item);
+
+            const auto T = item[0];
+            const auto D = item[1] * 1.2; // multiply density by 1.2 to ensure we don't start with an initial guess that is the exact solution
+            const auto P = item[3];
+            const auto wtp = waterThermoPropsHGK(T, P, D, WaterDensityMethod::Halley);
+
+            REQUIRE(wtp.density == approx(item[1]));
+            REQUIRE(wtp.helmholtz == approx(item[2]).scale(kJ));
+            REQUIRE(wtp.pressure == approx(item[3]).scale(MPa));
+            REQUIRE(wtp.cv == approx(item[4]).scale(kJ));
+        }
+    }
+
+    SECTION("when temperature and pressure are given, and the safeguarded method is used")
+    {
+        for(auto item : table12_kestin_et_al_1984)
+        {
+            dimensionalform(item);
+
+            const auto T = item[0];
+            const auto D = item[1] > waterCriticalDensity ? 1.0 : 1000.0; // start with an initial guess in the wrong phase
+            const auto P = item[3];
+            const auto wtp = waterThermoPropsHGK(T, P, D, WaterDensityMethod::Safeguarded);
+
+            REQUIRE(wtp.density == approx(item[1]));
+            REQUIRE(wtp.helmholtz == approx(item[2]).scale(kJ));
+            REQUIRE(wtp.pressure == approx(item[3]).scale(MPa));
+            REQUIRE(wtp.cv == approx(item[4]).scale(kJ));
+        }
+    }
+
+    SECTION("when arrays of temperature and pressure are given")
+    {
+        std::vector<Real> T, P, D0;
+        for(auto item : table12_kestin_et_al_1984)
+        {
+            dimensionalform(item);
+            T.push_back(item[0]);
+            P.push_back(item[3]);
+            D0.push_back(item[1] * 1.2); // multiply density by 1.2 to ensure we don't start with an initial guess that is the exact solution
+        }
+
+        const auto n = T.size();
+
+        std::vector<WaterThermoProps> res(n);
+        std::vector<WaterSolverStatus> status(n);
+        waterThermoPropsHGKBatch(n, T.data(), P.data(), D0.data(), res.data(), status.data());
+
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            // The single-state algorithm evaluates the properties at the last iterate, so the results agree to within its tolerance
+            const auto expected = waterThermoPropsHGK(T[i], P[i], D0[i]);
+
+            REQUIRE(status[i] == WaterSolverStatus::Converged);
+            REQUIRE(res[i].density == Approx(expected.density).epsilon(1e-10));
+            REQUIRE(res[i].helmholtz == Approx(expected.helmholtz).scale(kJ).epsilon(1e-6));
+            REQUIRE(res[i].cv == Approx(expected.cv).scale(kJ).epsilon(1e-6));
+        }
+    }
+
+    SECTION("when the saturation state is calculated")
+    {
+        std::vector<Real> T;
+        for(auto t = 275.0; t < 645.0; t += 10.0)
+        {
+            T.push_back(t);
+
+            WaterSolverResult result;
+            const auto sat = waterSaturationPropsHGK(t, result);
+
+            REQUIRE(result.status == WaterSolverStatus::Converged);
+
+            // Both phases have the same pressure and Gibbs free energy
+            const auto wl = waterThermoProps(t, sat.density_liquid, waterHelmholtzPropsHGK(t, sat.density_liquid));
+            const auto wv = waterThermoProps(t, sat.density_vapor, waterHelmholtzPropsHGK(t, sat.density_vapor));
+
+            REQUIRE(wl.pressure == Approx(sat.pressure).epsilon(1e-8).margin(1e-2)); // the pressure of the liquid changes by about 2 MPa per kg/m3
+            REQUIRE(wv.pressure == Approx(sat.pressure).epsilon(1e-12));
+            REQUIRE(wl.gibbs == Approx(wv.gibbs).scale(kJ).epsilon(1e-9));
+
+            // The saturation states of HGK are close to those of Wagner and Pruss (2002)
+            REQUIRE(sat.pressure == Approx(waterPressureSaturatedStateWagnerPruss(t)).epsilon(5e-3));
+            REQUIRE(sat.density_liquid == Approx(waterDensitySaturatedLiquidStateWagnerPruss(t)).epsilon(5e-3));
+            REQUIRE(sat.density_vapor == Approx(waterDensitySaturatedVaporStateWagnerPruss(t)).epsilon(5e-3));
+        }
+
+        const auto n = T.size();
+
+        std::vector<WaterSaturationProps> res(n);
+        std::vector<WaterSolverStatus> status(n);
+        waterSaturationPropsHGKBatch(n, T.data(), res.data(), status.data());
+
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            const auto expected = waterSaturationPropsHGK(T[i]);
+
+            REQUIRE(status[i] == WaterSolverStatus::Converged);
+            REQUIRE(res[i].pressure == Approx(expected.pressure).epsilon(1e-10));
+            REQUIRE(res[i].density_liquid == Approx(expected.density_liquid).epsilon(1e-10));
+            REQUIRE(res[i].density_vapor == Approx(expected.density_vapor).epsilon(1e-10));
+        }
+    }
+
     SECTION("when temperature and pressure are given, and density is given as initial guess")
     {
         for(auto item : table12_kestin_et_al_1984)
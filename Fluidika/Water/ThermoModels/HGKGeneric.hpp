@@ -0,0 +1,763 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// C++ includes
+#include <cmath>
+#include <cstddef>
+
+// Fluidika includes
+#include <Fluidika/Common/Real.hpp>
+#include <Fluidika/Common/Simd.hpp>
+#include <Fluidika/Water/ThermoModels/UtilsGeneric.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+
+namespace Fluidika {
+namespace generic {
+inline namespace FLUIDIKA_ISA_NAMESPACE {
+namespace hgk {
+
+using std::exp;
+using std::log;
+
+//=================================================================================================
+// Reference constants as given in Kestin et al (1984)
+//=================================================================================================
+
+// Reference temperature of water (in unit of K) --- Eq. (4.1)
+constexpr double referenceTemperature = 647.27;
+
+// Reference density of water (in unit of kg/m3) --- Eq. (4.2)
+constexpr double referenceDensity = 317.763;
+
+// Reference pressure of water (in unit of Pa) --- Eq. (4.3)
+constexpr double referencePressure = 22.115e+06;
+
+// Reference viscosity of water (in unit of Pa*s) --- Eq. (4.4)
+constexpr double referenceViscosity = 55.071e-06;
+
+// Reference thermal conductivity of water (in unit of W/(K*m)) --- Eq. (4.5)
+constexpr double referenceThermalConductivity = 0.49450;
+
+// Reference surface tension of water (in unit of N/m) --- Eq. (4.6)
+constexpr double referenceSurfaceTension = 235.8e-3;
+
+// Reference constant for Helmholtz function (in unit of J/kg) --- Eq. (4.7)
+constexpr double referenceHelmholtz = 69595.89;
+
+// Reference constant for entropy specific heat (in unit of J/(kg*K)) --- Eq. (4.8)
+constexpr double referenceEntropy = 107.5222;
+
+// Reference constant for sound speed (in unit of m/s) --- Eq. (4.9)
+constexpr double referenceSoundSpeed = 263.810;
+
+constexpr double A0[] =
+{
+	-0.130840393653E+2,
+	-0.857020420940E+2,
+	 0.765192919131E-2,
+	-0.620600116069E+0,
+	-0.106924329402E+2,
+	-0.280671377296E+1,
+	 0.119843634845E+3,
+	-0.823907389256E+2,
+	 0.555864146443E+2,
+	-0.310698122980E+2,
+	 0.136200239305E+2,
+	-0.457116129409E+1,
+	 0.115382128188E+1,
+	-0.214242224683E+0,
+	 0.282800597384E-1,
+	-0.250384152737E-2,
+	 0.132952679669E-3,
+	-0.319277411208E-5
+};
+
+constexpr double A1[] =
+{
+	 0.15383053E+1,
+	-0.81048367E+0,
+	-0.68305748E+1,
+	 0.00000000E+0,
+	 0.86756271E+0
+};
+
+constexpr double A20 = 0.42923415E+1;
+
+constexpr double yc[] =
+{
+	 0.59402227E-1,
+	-0.28128238E-1,
+	 0.56826674E-3,
+	-0.27987451E-3
+};
+
+constexpr double z0 = 0.317763E+0;
+
+constexpr int ki[] =
+{
+	1,	1,	1,	1,	2,	2,	2,	2,
+	3,	3,	3,	3,	4,	4,	4,	4,
+	5,	5,	5,	5,	6,	6,	6,	6,
+	7,	7,	7,	7,	9,	9,	9,	9,
+	3,	3,	1,	5
+};
+
+constexpr int li[] =
+{
+	1,	2,	4,	6,	1,	2,	4,	6,
+	1,	2,	4,	6,	1,	2,	4,	6,
+	1,	2,	4,	6,	1,	2,	4,	6,
+	1,	2,	4,	6,	1,	2,	4,	6,
+	0,	3,	3,	3
+};
+
+constexpr double A3[] =
+{
+	-0.76221190138079E+1,
+	 0.32661493707555E+2,
+	 0.11305763156821E+2,
+	-0.10015404767712E+1,
+	 0.12830064355028E+3,
+	-0.28371416789846E+3,
+	 0.24256279839182E+3,
+	-0.99357645626725E+2,
+	-0.12275453013171E+4,
+	 0.23077622506234E+4,
+	-0.16352219929859E+4,
+	 0.58436648297764E+3,
+	 0.42365441415641E+4,
+	-0.78027526961828E+4,
+	 0.38855645739589E+4,
+	-0.91225112529381E+3,
+	-0.90143895703666E+4,
+	 0.15196214817734E+5,
+	-0.39616651358508E+4,
+	-0.72027511617558E+3,
+	 0.11147126705990E+5,
+	-0.17412065252210E+5,
+	 0.99918281207782E+3,
+	 0.33504807153854E+4,
+	-0.64752644922631E+4,
+	 0.98323730907847E+4,
+	 0.83877854108422E+3,
+	-0.27919349903103E+4,
+	 0.11112410081192E+4,
+	-0.17287587261807E+4,
+	-0.36233262795423E+3,
+	 0.61139429010144E+3,
+	 0.32968064728562E+2,
+	 0.10411239605066E+3,
+	-0.38225874712590E+2,
+	-0.20307478607599E+3
+};
+
+constexpr int mi[] = { 2, 2, 2, 4 };
+
+constexpr int ni[] = { 0, 2, 0, 0 };
+
+constexpr double alpha[] = { 34, 40, 30, 1050 };
+
+constexpr double beta[] = { 20000, 20000, 40000, 25 };
+
+constexpr double ri[] =
+{
+	0.10038928E+1,
+	0.10038928E+1,
+	0.10038928E+1,
+	0.48778492E+1
+};
+
+constexpr double ti[] =
+{
+	0.98876821E+0,
+	0.98876821E+0,
+	0.99124013E+0,
+	0.41713659E+0
+};
+
+constexpr double A4[] =
+{
+	-0.32329494E-2,
+	-0.24139355E-1,
+	 0.79027651E-3,
+	-0.13362857E+1
+};
+
+/// The coefficients of the fourth contribution written as a polynomial in z and 1/t, where entry [k][l] multiplies z^k/t^l.
+struct PolynomialCoefficients
+{
+	double c[10][7];
+};
+
+constexpr auto calculatePolynomialCoefficients() -> PolynomialCoefficients
+{
+	PolynomialCoefficients p = {};
+	for(int i = 0; i <= 35; ++i)
+		p.c[ki[i]][li[i]] += A3[i];
+	return p;
+}
+
+constexpr auto A3zt = calculatePolynomialCoefficients();
+
+// The factors that convert the dimensionless Helmholtz free energy and its partial derivatives to dimensioned form
+constexpr double scale    = referenceHelmholtz;
+constexpr double scaleT   = scale/referenceTemperature;
+constexpr double scaleD   = scale/referenceDensity;
+constexpr double scaleTT  = scaleT/referenceTemperature;
+constexpr double scaleTD  = scaleT/referenceDensity;
+constexpr double scaleDD  = scaleD/referenceDensity;
+constexpr double scaleTTT = scaleTT/referenceTemperature;
+constexpr double scaleTTD = scaleTT/referenceDensity;
+constexpr double scaleTDD = scaleTD/referenceDensity;
+constexpr double scaleDDD = scaleDD/referenceDensity;
+
+/// The contributions to the Haar--Gallagher--Kell (1984) equation of state that depend only on temperature.
+template<typename Scalar>
+struct TemperatureTerms
+{
+	/// The temperature of water (in units of K).
+	Scalar T;
+
+	/// The dimensionless temperature t = T/Tr and its inverse.
+	Scalar t, it;
+
+	/// The base function, which depends only on t, and its partial derivatives with respect to t.
+	Scalar base, base_t, base_tt, base_ttt;
+
+	/// The sum of A1[i]*t^(1 - i) in the second contribution and its partial derivatives with respect to t.
+	Scalar b, b_t, b_tt, b_ttt;
+
+	/// The ratio y/d in the third contribution and its partial derivatives with respect to t.
+	Scalar y, y_t, y_tt, y_ttt;
+
+	/// The coefficients of z^k in the fourth contribution and their partial derivatives with respect to t.
+	Scalar q[10], q_t[10], q_tt[10], q_ttt[10];
+
+	/// The reduced temperatures (t - ti)/ti and the factors exp(-beta*tau^2) of the terms in the fifth contribution.
+	Scalar tau[4], gauss[4];
+};
+
+template<typename Scalar>
+auto calculateTemperatureTerms(const Scalar& T) -> TemperatureTerms<Scalar>
+{
+	using V = ValueType<Scalar>;
+
+	TemperatureTerms<Scalar> tt;
+
+	const Scalar t  = T/V(referenceTemperature);
+	const Scalar it = 1/t;
+
+	tt.T  = T;
+	tt.t  = t;
+	tt.it = it;
+
+	// The powers t^k for k = 0, ..., 13 and 1/t^k for k = 0, ..., 9
+	Scalar tpow[14], itpow[10];
+
+	tpow[0] = itpow[0] = 1;
+	for(int k = 1; k < 14; ++k)
+		tpow[k] = tpow[k - 1] * t;
+	for(int k = 1; k < 10; ++k)
+		itpow[k] = itpow[k - 1] * it;
+
+	const auto ln_t = log(t);
+
+	// The base function
+	const V a0 = A0[0], a1 = A0[1];
+
+	tt.base     = (a0 + a1 * t) * ln_t;
+	tt.base_t   = a0*it + a1*(ln_t + 1);
+	tt.base_tt  = -a0*itpow[2] + a1*it;
+	tt.base_ttt = 2*a0*itpow[3] - a1*itpow[2];
+
+	for(int i = 2; i <= 17; ++i)
+	{
+		const int m = i - 4;
+
+		const Scalar aux = V(A0[i]) * (m >= 0 ? tpow[m] : itpow[-m]);
+
+		tt.base     += aux;
+		tt.base_t   += aux * m*it;
+		tt.base_tt  += aux * m*(m - 1)*itpow[2];
+		tt.base_ttt += aux * m*(m - 1)*(m - 2)*itpow[3];
+	}
+
+	// The temperature factor of the second contribution
+	tt.b = tt.b_t = tt.b_tt = tt.b_ttt = 0;
+
+	for(int i = 0; i <= 4; ++i)
+	{
+		const Scalar aux = V(A1[i]) * (i == 0 ? t : itpow[i - 1]);
+
+		tt.b     += aux;
+		tt.b_t   -= aux * (i - 1)*it;
+		tt.b_tt  += aux * (i - 1)*i*itpow[2];
+		tt.b_ttt -= aux * (i - 1)*i*(i + 1)*itpow[3];
+	}
+
+	// The temperature factor of the third contribution
+	const auto t3 = itpow[3];
+	const auto t5 = itpow[5];
+
+	const V y0 = yc[0], y1 = yc[1], y2 = yc[2], y3 = yc[3];
+
+	tt.y     = y0 + y1*ln_t + y2*t3 + y3*t5;
+	tt.y_t   = (y1 - 3*y2*t3 - 5*y3*t5)*it;
+	tt.y_tt  = (-y1 + 12*y2*t3 + 30*y3*t5)*itpow[2];
+	tt.y_ttt = (2*y1 - 60*y2*t3 - 210*y3*t5)*itpow[3];
+
+	// The temperature factors of the fourth contribution
+	for(int k = 0; k < 10; ++k)
+	{
+		tt.q[k] = tt.q_t[k] = tt.q_tt[k] = tt.q_ttt[k] = 0;
+
+		for(int l = 0; l < 7; ++l)
+		{
+			const V c = A3zt.c[k][l];
+
+			tt.q[k]     += c * itpow[l];
+			tt.q_t[k]   -= c * l * itpow[l + 1];
+			tt.q_tt[k]  += c * l*(l + 1) * itpow[l + 2];
+			tt.q_ttt[k] -= c * l*(l + 1)*(l + 2) * itpow[l + 3];
+		}
+	}
+
+	// The temperature factors of the fifth contribution
+	for(int i = 0; i <= 3; ++i)
+	{
+		tt.tau[i]   = (t - V(ti[i]))/V(ti[i]);
+		tt.gauss[i] = exp(-V(beta[i])*tt.tau[i]*tt.tau[i]);
+	}
+
+	return tt;
+}
+
+/// Return the integer power x^n, with n non-negative, using products.
+template<typename Scalar>
+auto ipow(const Scalar& x, int n) -> Scalar
+{
+	Scalar res = 1;
+	for(int k = 0; k < n; ++k)
+		res *= x;
+	return res;
+}
+
+template<int order, typename Scalar>
+auto addWaterHelmholtzPropsHGK0(const TemperatureTerms<Scalar>& tt, WaterHelmholtzPropsBase<Scalar>& s) -> void
+{
+	s.helmholtz += tt.base;
+
+	if constexpr(order >= 1)
+		s.helmholtzT += tt.base_t;
+	if constexpr(order >= 2)
+		s.helmholtzTT += tt.base_tt;
+	if constexpr(order >= 3)
+		s.helmholtzTTT += tt.base_ttt;
+}
+
+template<int order, typename Scalar>
+auto addWaterHelmholtzPropsHGK1(const TemperatureTerms<Scalar>& tt, const Scalar& d, WaterHelmholtzPropsBase<Scalar>& s) -> void
+{
+	s.helmholtz += d * tt.b;
+
+	if constexpr(order >= 1)
+	{
+		s.helmholtzT += d * tt.b_t;
+		s.helmholtzD += tt.b;
+	}
+	if constexpr(order >= 2)
+	{
+		s.helmholtzTT += d * tt.b_tt;
+		s.helmholtzTD += tt.b_t;
+	}
+	if constexpr(order >= 3)
+	{
+		s.helmholtzTTT += d * tt.b_ttt;
+		s.helmholtzTTD += tt.b_tt;
+	}
+}
+
+template<int order, typename Scalar>
+auto addWaterHelmholtzPropsHGK2(const TemperatureTerms<Scalar>& tt, const Scalar& d, WaterHelmholtzPropsBase<Scalar>& s) -> void
+{
+	using V = ValueType<Scalar>;
+
+	const auto& t = tt.t;
+
+	const V c1 = -130.0/3.0;
+	const V c2 =  169.0/6.0;
+	const V c3 = -14.0;
+	const V A = A20;
+
+	const Scalar y = d * tt.y;
+	const Scalar x = 1/(1 - y);
+	const Scalar u = log(d * x);
+
+	const Scalar a = A * t * (u + c1*x  + c2*x*x + c3*y);
+
+	s.helmholtz += a;
+
+	if constexpr(order >= 1)
+	{
+		const auto y_r = tt.y;
+		const auto y_t = d * tt.y_t;
+
+		const auto x2  = x * x;
+		const auto x_r = y_r * x2;
+		const auto x_t = y_t * x2;
+
+		const auto u_r = x_r/x + 1/d;
+		const auto u_t = x_t/x;
+
+		const auto a_r = A * t * (u_r + c1*x_r + 2*c2*x*x_r + c3*y_r);
+		const auto a_t = A * t * (u_t + c1*x_t + 2*c2*x*x_t + c3*y_t) + a/t;
+
+		s.helmholtzD += a_r;
+		s.helmholtzT += a_t;
+
+		if constexpr(order >= 2)
+		{
+			const auto y_tt = d * tt.y_tt;
+			const auto y_rt = tt.y_t;
+
+			const auto x_rr = 2 * y_r * x_r * x;
+			const auto x_tt = y_tt * x2 + 2 * y_t * x_t * x;
+			const auto x_rt = y_rt * x2 + 2 * y_r * x_t * x;
+
+			const auto u_rr = x_rr/x - x_r*x_r/(x*x) - 1/(d*d);
+			const auto u_rt = x_rt/x - x_r*x_t/(x*x);
+			const auto u_tt = x_tt/x - x_t*x_t/(x*x);
+
+			const auto a_rr = A * t * (u_rr + c1*x_rr + 2*c2*(x*x_rr + x_r*x_r));
+			const auto a_rt = A * t * (u_rt + c1*x_rt + 2*c2*(x*x_rt + x_r*x_t) + c3*y_rt) + a_r/t;
+			const auto a_tt = A * t * (u_tt + c1*x_tt + 2*c2*(x*x_tt + x_t*x_t) + c3*y_tt) + 2*(a_t/t - a/(t*t));
+
+			s.helmholtzDD += a_rr;
+			s.helmholtzTD += a_rt;
+			s.helmholtzTT += a_tt;
+
+			if constexpr(order >= 3)
+			{
+				const auto y_rtt = tt.y_tt;
+				const auto y_ttt = d * tt.y_ttt;
+
+				const auto x_rrr = 2*y_r*(x_rr*x + x_r*x_r);
+				const auto x_rrt = 2*y_rt*x_r + 2*y_r*(x_rt*x + x_r*x_t);
+				const auto x_rtt = y_rtt*x2 + 4*y_rt*x_t*x + 2*y_r*(x_tt*x + x_t*x_t);
+				const auto x_ttt = y_ttt*x2 + 4*y_tt*x_t*x + 2*y_t*(x_tt*x + x_t*x_t);
+
+				const auto u_rrr = x_rrr/x - 3*x_rr*x_r/(x*x) + 2*x_r*x_r*x_r/(x*x*x) + 2/(d*d*d);
+				const auto u_rrt = x_rrt/x - (2*x_rt*x_r + x_rr*x_t)/(x*x) + 2*x_r*x_r*x_t/(x*x*x);
+				const auto u_rtt = x_rtt/x - (2*x_rt*x_t + x_tt*x_r)/(x*x) + 2*x_t*x_t*x_r/(x*x*x);
+				const auto u_ttt = x_ttt/x - 3*x_tt*x_t/(x*x) + 2*x_t*x_t*x_t/(x*x*x);
+
+				s.helmholtzDDD += A * t * (u_rrr + c1*x_rrr + 2*c2*(3*x_r*x_rr + x*x_rrr));
+				s.helmholtzTDD += A * t * (u_rrt + c1*x_rrt + 2*c2*(x_t*x_rr + 2*x_r*x_rt + x*x_rrt)) + a_rr/t;
+				s.helmholtzTTD += A * t * (u_rtt + c1*x_rtt + 2*c2*(x_r*x_tt + 2*x_t*x_rt + x*x_rtt) + c3*y_rtt) + 2*(a_rt - a_r/t)/t;
+				s.helmholtzTTT += A * t * (u_ttt + c1*x_ttt + 2*c2*(3*x_t*x_tt + x*x_ttt) + c3*y_ttt) + 3*(a_tt - 2*a_t/t + a/(t*t))/t;
+			}
+		}
+	}
+}
+
+/// Add the fourth contribution, the sum of A3[i]*z^ki[i]/t^li[i], evaluated as a polynomial in z whose coefficients depend only on t.
+template<int order, typename Scalar>
+auto addWaterHelmholtzPropsHGK3(const TemperatureTerms<Scalar>& tt, const Scalar& d, WaterHelmholtzPropsBase<Scalar>& s) -> void
+{
+	using V = ValueType<Scalar>;
+
+	const V c = z0;
+
+	const Scalar z     =  1 - exp(-c * d);
+	const Scalar z_r   =  c * (1 - z);
+	const Scalar z_rr  = -c * z_r;
+	const Scalar z_rrr = -c * z_rr;
+
+	// The polynomials p = sum(q[k]*z^k), p_t = sum(q_t[k]*z^k), and so forth, and their derivatives with
+	// respect to z, evaluated together with Horner's method (p2 and p3 are the second and third derivatives
+	// with respect to z divided by 2 and 6 respectively)
+	Scalar p = tt.q[9], p1 = 0, p2 = 0, p3 = 0;
+	Scalar pt = tt.q_t[9], pt1 = 0, pt2 = 0;
+	Scalar ptt = tt.q_tt[9], ptt1 = 0;
+	Scalar pttt = tt.q_ttt[9];
+
+	for(int k = 8; k >= 0; --k)
+	{
+		if constexpr(order >= 3)
+		{
+			p3 = p3*z + p2;
+			pt2 = pt2*z + pt1;
+			ptt1 = ptt1*z + ptt;
+			pttt = pttt*z + tt.q_ttt[k];
+		}
+		if constexpr(order >= 2)
+		{
+			p2 = p2*z + p1;
+			pt1 = pt1*z + pt;
+			ptt = ptt*z + tt.q_tt[k];
+		}
+		if constexpr(order >= 1)
+		{
+			p1 = p1*z + p;
+			pt = pt*z + tt.q_t[k];
+		}
+		p = p*z + tt.q[k];
+	}
+
+	s.helmholtz += p;
+
+	if constexpr(order >= 1)
+	{
+		s.helmholtzD += p1*z_r;
+		s.helmholtzT += pt;
+	}
+	if constexpr(order >= 2)
+	{
+		s.helmholtzDD += 2*p2*z_r*z_r + p1*z_rr;
+		s.helmholtzTD += pt1*z_r;
+		s.helmholtzTT += ptt;
+	}
+	if constexpr(order >= 3)
+	{
+		s.helmholtzDDD += 6*p3*z_r*z_r*z_r + 6*p2*z_r*z_rr + p1*z_rrr;
+		s.helmholtzTDD += 2*pt2*z_r*z_r + pt1*z_rr;
+		s.helmholtzTTD += ptt1*z_r;
+		s.helmholtzTTT += pttt;
+	}
+}
+
+template<int order, typename Scalar>
+auto addWaterHelmholtzPropsHGK4(const TemperatureTerms<Scalar>& tt, const Scalar& d, WaterHelmholtzPropsBase<Scalar>& s) -> void
+{
+	using V = ValueType<Scalar>;
+
+	for(int i = 0; i <= 3; ++i)
+	{
+		const V alphai = alpha[i], betai = beta[i];
+		const V mii = mi[i], nii = ni[i];
+
+		const Scalar delta = (d - V(ri[i]))/V(ri[i]);
+		const Scalar tau   = tt.tau[i];
+		const V delta_r    = 1.0/ri[i];
+		const V tau_t      = 1.0/ti[i];
+
+		const Scalar delta_m = ipow(delta, mi[i]);
+		const Scalar delta_n = ipow(delta, ni[i]);
+
+		const Scalar theta = V(A4[i])*delta_n*exp(-alphai*delta_m)*tt.gauss[i];
+
+		s.helmholtz += theta;
+
+		if constexpr(order >= 1)
+		{
+			const auto psi = (nii - alphai*mii*delta_m)*delta_r/delta;
+
+			const auto theta_r =  psi*theta;
+			const auto theta_t = -2*betai*tau*tau_t*theta;
+
+			s.helmholtzD += theta_r;
+			s.helmholtzT += theta_t;
+
+			if constexpr(order >= 2)
+			{
+				const auto dr = delta_r/delta;
+
+				const auto psi_r = -(nii + alphai*mii*(mii - 1)*delta_m)*dr*dr;
+
+				const auto theta_rr = psi_r*theta + psi*theta_r;
+				const auto theta_tt = 2*betai*(2*betai*tau*tau - 1)*tau_t*tau_t*theta;
+				const auto theta_rt = -2*betai*tau*tau_t*theta_r;
+
+				s.helmholtzDD += theta_rr;
+				s.helmholtzTD += theta_rt;
+				s.helmholtzTT += theta_tt;
+
+				if constexpr(order >= 3)
+				{
+					const auto psi_rr = (2*nii - alphai*mii*(mii - 1)*(mii - 2)*delta_m)*dr*dr*dr;
+
+					s.helmholtzDDD +=  psi_rr*theta + 2*psi_r*theta_r + psi*theta_rr;
+					s.helmholtzTDD +=  psi_r*theta_r + psi*theta_rt;
+					s.helmholtzTTD +=  psi*theta_tt;
+					s.helmholtzTTT += -2*betai*(2*tau_t*tau_t*theta_t + tau*tau_t*theta_tt);
+				}
+			}
+		}
+	}
+}
+
+/// Calculate the Helmholtz free energy state of water using the Haar--Gallagher--Kell (1984) equation of state with partial derivatives up to a given order.
+/// The five contributions are accumulated directly in the result, which is then converted to dimensioned form with constant factors.
+template<int order, typename Scalar>
+auto calculateWaterHelmholtzPropsHGK(const TemperatureTerms<Scalar>& tt, const Scalar& D) -> WaterHelmholtzPropsBase<Scalar>
+{
+	static_assert(order >= 0 && order <= 3, "The order of the partial derivatives must be between 0 and 3.");
+
+	using V = ValueType<Scalar>;
+
+	// The dimensionless density
+	const Scalar r = D/V(referenceDensity);
+
+	WaterHelmholtzPropsBase<Scalar> res = {};
+
+	addWaterHelmholtzPropsHGK0<order>(tt, res);
+	addWaterHelmholtzPropsHGK1<order>(tt, r, res);
+	addWaterHelmholtzPropsHGK2<order>(tt, r, res);
+	addWaterHelmholtzPropsHGK3<order>(tt, r, res);
+	addWaterHelmholtzPropsHGK4<order>(tt, r, res);
+
+	// Convert the Helmholtz free energy of water and its derivatives to dimensioned form
+	res.helmholtz *= V(scale);
+
+	if constexpr(order >= 1)
+	{
+		res.helmholtzD *= V(scaleD);
+		res.helmholtzT *= V(scaleT);
+	}
+	if constexpr(order >= 2)
+	{
+		res.helmholtzDD *= V(scaleDD);
+		res.helmholtzTD *= V(scaleTD);
+		res.helmholtzTT *= V(scaleTT);
+	}
+	if constexpr(order >= 3)
+	{
+		res.helmholtzDDD *= V(scaleDDD);
+		res.helmholtzTDD *= V(scaleTDD);
+		res.helmholtzTTD *= V(scaleTTD);
+		res.helmholtzTTT *= V(scaleTTT);
+	}
+
+	return res;
+}
+
+template<int order, typename Scalar>
+auto calculateWaterHelmholtzPropsHGK(const Scalar& T, const Scalar& D) -> WaterHelmholtzPropsBase<Scalar>
+{
+	return calculateWaterHelmholtzPropsHGK<order>(calculateTemperatureTerms(T), D);
+}
+
+} // namespace hgk
+
+/// Calculate the Helmholtz free energy state of water using the Haar--Gallagher--Kell (1984) equation of state with a generic scalar type.
+/// The requirements on the scalar type are the same as those of @ref waterHelmholtzPropsWagnerPruss, with exp and log as the needed functions.
+/// @param T The temperature of water (in units of K)
+/// @param D The density of water (in units of kg/m3)
+/// @return The Helmholtz free energy state of water
+/// @see Fluidika::waterHelmholtzPropsHGK
+template<typename Scalar>
+auto waterHelmholtzPropsHGK(const Scalar& T, const Scalar& D) -> WaterHelmholtzPropsBase<Scalar>
+{
+    return hgk::calculateWaterHelmholtzPropsHGK<3>(T, D);
+}
+
+/// Calculate the Helmholtz free energy state of water using the Haar--Gallagher--Kell (1984) equation of state with a generic scalar type and partial derivatives up to a given order.
+/// @tparam order The highest order of the partial derivatives to be computed (0, 1, 2 or 3)
+/// @param T The temperature of water (in units of K)
+/// @param D The density of water (in units of kg/m3)
+/// @return The Helmholtz free energy state of water
+/// @see waterHelmholtzPropsHGK
+template<int order, typename Scalar>
+auto waterHelmholtzPropsHGKUpToOrder(const Scalar& T, const Scalar& D) -> WaterHelmholtzPropsBase<Scalar>
+{
+    return hgk::calculateWaterHelmholtzPropsHGK<order>(T, D);
+}
+
+#if FLUIDIKA_HAS_SIMD
+
+/// Calculate the Helmholtz free energy states of water using the Haar--Gallagher--Kell (1984) equation of state for many pairs of temperature and density in packs of a given SIMD type.
+/// @tparam Simd The type of the packs (e.g., RealSimd or FloatSimd)
+/// @param n The number of states to be evaluated
+/// @param T The array of temperatures of water (in units of K) with length *n*
+/// @param D The array of densities of water (in units of kg/m3) with length *n*
+/// @param[out] res The arrays of Helmholtz free energy properties of water, each with length *n*
+template<typename Simd>
+auto waterHelmholtzPropsHGKBatch(std::size_t n, const typename Simd::value_type* T, const typename Simd::value_type* D, const WaterHelmholtzPropsArraysBase<typename Simd::value_type>& res) -> void
+{
+    const auto width = Simd::size();
+
+    for(std::size_t k = 0; k < n; k += width)
+    {
+        // The number of states in this pack (the last pack may be partially filled, in which case its last state is repeated in the remaining lanes)
+        const auto m = n - k < width ? n - k : width;
+
+        const auto aux = hgk::calculateWaterHelmholtzPropsHGK<3>(load<Simd>(T + k, m), load<Simd>(D + k, m));
+
+        store(aux.helmholtz,    res.helmholtz    + k, m);
+        store(aux.helmholtzT,   res.helmholtzT   + k, m);
+        store(aux.helmholtzD,   res.helmholtzD   + k, m);
+        store(aux.helmholtzTT,  res.helmholtzTT  + k, m);
+        store(aux.helmholtzTD,  res.helmholtzTD  + k, m);
+        store(aux.helmholtzDD,  res.helmholtzDD  + k, m);
+        store(aux.helmholtzTTT, res.helmholtzTTT + k, m);
+        store(aux.helmholtzTTD, res.helmholtzTTD + k, m);
+        store(aux.helmholtzTDD, res.helmholtzTDD + k, m);
+        store(aux.helmholtzDDD, res.helmholtzDDD + k, m);
+    }
+}
+
+/// Calculate the thermodynamic properties of water using the Haar--Gallagher--Kell (1984) equation of state for many pairs of temperature and pressure in packs of a given SIMD type.
+/// @tparam Simd The type of the packs (e.g., RealSimd)
+/// @param n The number of states to be calculated
+/// @param T The array of temperatures of water (in units of K) with length *n*
+/// @param P The array of pressures of water (in units of Pa) with length *n*
+/// @param D0 The array of initial guesses for the density of water (in units of kg/m3) with length *n*
+/// @param[out] res The array of thermodynamic properties of water with length *n*
+/// @param[out] status The array of outcomes of the density calculations with length *n*, or nullptr if not needed
+/// @return The number of states whose density did not converge
+/// @see waterThermoPropsBatch
+template<typename Simd>
+auto waterThermoPropsHGKBatch(std::size_t n, const Real* T, const Real* P, const Real* D0, WaterThermoProps* res, WaterSolverStatus* status) -> std::size_t
+{
+    const auto terms = [](const Simd& T) { return hgk::calculateTemperatureTerms(T); };
+    const auto modeliter = [](const auto& tt, const Simd& D) { return hgk::calculateWaterHelmholtzPropsHGK<2>(tt, D); };
+    const auto model = [](const auto& tt, const Simd& D) { return hgk::calculateWaterHelmholtzPropsHGK<3>(tt, D); };
+    return waterThermoPropsBatch<Simd>(n, T, P, D0, res, status, terms, modeliter, model);
+}
+
+/// Calculate the densities of water using the Haar--Gallagher--Kell (1984) equation of state for many pairs of temperature and pressure in single-precision packs of a given SIMD type.
+/// @tparam Simd The type of the packs (e.g., FloatSimd)
+/// @param n The number of states to be calculated
+/// @param T The array of temperatures of water (in units of K) with length *n*
+/// @param P The array of pressures of water (in units of Pa) with length *n*
+/// @param D0 The array of initial guesses for the density of water (in units of kg/m3) with length *n*
+/// @param[out] D The array of densities of water (in units of kg/m3) with length *n*
+/// @param[out] status The array of outcomes of the density calculations with length *n*, or nullptr if not needed
+/// @return The number of states whose density did not converge
+/// @see waterDensitySinglePrecisionBatch
+template<typename Simd>
+auto waterDensityHGKBatch(std::size_t n, const Real* T, const Real* P, const Real* D0, Real* D, WaterSolverStatus* status) -> std::size_t
+{
+    const auto terms = [](const Simd& T) { return hgk::calculateTemperatureTerms(T); };
+    const auto modeliter = [](const auto& tt, const Simd& D) { return hgk::calculateWaterHelmholtzPropsHGK<2>(tt, D); };
+    return waterDensitySinglePrecisionBatch<Simd>(n, T, P, D0, D, status, terms, modeliter);
+}
+
+#endif
+
+// The double instantiations are compiled into the library
+extern template auto waterHelmholtzPropsHGK(const Real& T, const Real& D) -> WaterHelmholtzPropsBase<Real>;
+extern template auto waterHelmholtzPropsHGKUpToOrder<0>(const Real& T, const Real& D) -> WaterHelmholtzPropsBase<Real>;
+extern template auto waterHelmholtzPropsHGKUpToOrder<1>(const Real& T, const Real& D) -> WaterHelmholtzPropsBase<Real>;
+extern template auto waterHelmholtzPropsHGKUpToOrder<2>(const Real& T, const Real& D) -> WaterHelmholtzPropsBase<Real>;
+extern template auto waterHelmholtzPropsHGKUpToOrder<3>(const Real& T, const Real& D) -> WaterHelmholtzPropsBase<Real>;
+
+} // inline namespace FLUIDIKA_ISA_NAMESPACE
+} // namespace generic
+} // namespace Fluidika
@@ -18,119 +18,254 @@
 #include "Utils.hpp"
 
 // C++ includes
+#include <algorithm>
+#include <atomic>
 #include <cmath>
-using std::abs;
-using std::sqrt;
 
 // Fluidika includes
 #include <Fluidika/Common/Constants.hpp>
-#include <Fluidika/Common/Exception.hpp>
+#include <Fluidika/Water/ThermoModels/UtilsGeneric.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
+#include <Fluidika/Water/ThermoModels/WaterDensityLattice.hpp>
 #include <Fluidika/Water/WaterData.hpp>
 #include <Fluidika/Water/WaterProps.hpp>
 
 namespace Fluidika {
+namespace {
 
-auto waterThermoProps(const WaterHelmholtzPropsFunction& model, RealConstRef T, RealConstRef P, RealConstRef D0) -> WaterThermoProps
+/// The process-wide counters of the calculations of water density, and whether they are enabled.
+struct WaterSolverCountersAtomic
 {
-    // Auxiliary constants for the Newton's iterations
-    const auto max_iters = 100;
-    const auto tolerance = 1.0e-08;
+    std::atomic<bool> enabled{false};
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> iterations{0};
+    std::atomic<std::uint64_t> failures{0};
+    std::atomic<std::uint64_t> fallbacks{0};
+};
 
-    // Determine an adequate initial guess for (dimensionless) density based on the physical state of water
-    Real D = D0;
+/// Return the process-wide counters of the calculations of water density.
+auto counters() -> WaterSolverCountersAtomic&
+{
+    static WaterSolverCountersAtomic instance;
+    return instance;
+}
 
-    // The specific Helmholtz free energy properties of water
-    WaterHelmholtzProps h;
+/// Return the isothermal compressibility of saturated liquid water (in units of 1/Pa).
+/// This is a fit to the compressibility of the Wagner and Pruss (2002) equation of state along the saturation curve,
+/// within 6% of it from the triple point up to about 2 K below the critical temperature.
+auto waterCompressibilitySaturatedLiquid(RealConstRef T) -> Real
+{
+    const auto theta = std::max(1.0 - T/waterCriticalTemperature, 1.0e-4);
+    const auto lnk = -5.5284 - 1.3868*std::log(theta) - 0.8978*theta - 1.9821*theta*theta + 7.2446*theta*theta*theta;
+    return std::exp(lnk)/waterCriticalPressure;
+}
 
-    // Apply the Newton's method to the pressure-density equation
-    for(int i = 1; i <= max_iters; ++i)
-    {
-        h = model(T, D);
+/// Return an approximation for the density of liquid water below the critical temperature.
+/// The density of saturated liquid is extrapolated to the given pressure with the Tait equation, whose constant C = 0.0894
+/// gives the density of the Wagner and Pruss (2002) equation of state within 1% on average up to 1 GPa.
+auto waterDensityLiquidGuess(RealConstRef T, RealConstRef P) -> Real
+{
+    const auto C = 0.0894;
+    const auto Psat = waterPressureSaturatedStateWagnerPruss(T);
+    const auto Dsat = waterDensitySaturatedLiquidStateWagnerPruss(T);
+    const auto kappa = waterCompressibilitySaturatedLiquid(T);
+    const auto x = std::max(kappa*(P - Psat)/C, -0.5); // metastable liquid below the saturation pressure is limited to mild expansions
+    return Dsat/(1.0 - C*std::log1p(x));
+}
 
-        const auto f  = (D*D*h.helmholtzD - P)/waterCriticalPressure;
-        const auto df = (2*D*h.helmholtzD + D*D*h.helmholtzDD)/waterCriticalPressure;
+/// Return an approximation for the density of water vapor below the critical temperature.
+/// The compressibility factor Z = P/(DRT) is interpolated linearly in pressure between that of the ideal gas (Z = 1) at zero
+/// pressure and that of saturated vapor at the saturation pressure, as in the virial equation truncated after its second term.
+auto waterDensityVaporGuess(RealConstRef T, RealConstRef P) -> Real
+{
+    const auto R = universalGasConstant/waterMolarMass;
+    const auto Psat = waterPressureSaturatedStateWagnerPruss(T);
+    const auto Dsat = waterDensitySaturatedVaporStateWagnerPruss(T);
+    const auto Zsat = Psat/(Dsat*R*T);
+    const auto Z = std::max(1.0 - (1.0 - Zsat)*P/Psat, 0.5*Zsat); // metastable vapor above the saturation pressure is limited to mild compressions
+    return P/(Z*R*T);
+}
 
-        D = (D > f/df) ? D - f/df : P/(D*h.helmholtzD);
+/// Return the pressure up to which the density of metastable water vapor is calculated below the critical temperature (in units of Pa).
+/// This is a lower bound, Psat*(1 + theta*(0.4 + 5*theta)) with theta = 1 - T/Tc, for the pressures up to which Newton's method
+/// converges to metastable vapor with the Wagner and Pruss (2002) equation of state from the initial guess of @ref waterDensityVaporGuess,
+/// which are about 1.006, 1.13 and 1.6 times the saturation pressure at 642 K, 600 K and 500 K respectively, beyond which it diverges.
+auto waterPressureMetastableVaporLimit(RealConstRef T) -> Real
+{
+    const auto theta = 1.0 - T/waterCriticalTemperature;
+    return waterPressureSaturatedStateWagnerPruss(T) * (1.0 + theta*(0.4 + 5.0*theta));
+}
 
-        if(abs(f) < tolerance)
-            return waterThermoProps(T, D, h);
-    }
+/// Return an approximation for the density of water above the critical temperature using the Peng-Robinson equation of state.
+/// The parameters of the equation are those of water at its critical point, with acentric factor 0.3443, so that the cubic
+/// equation for the compressibility factor has a single real root above the critical temperature. The approximation deviates
+/// from the supercritical states in Table 13.2 of Wagner and Pruss (2002) by 2% on average and 22% at most (near the critical point).
+auto waterDensitySupercriticalGuess(RealConstRef T, RealConstRef P) -> Real
+{
+    const auto R = universalGasConstant/waterMolarMass;
+    const auto Tr = T/waterCriticalTemperature;
+    const auto Pr = P/waterCriticalPressure;
+    const auto omega = 0.3443;
+    const auto m = 0.37464 + 1.54226*omega - 0.26992*omega*omega;
+    const auto alpha = (1.0 + m*(1.0 - std::sqrt(Tr))) * (1.0 + m*(1.0 - std::sqrt(Tr)));
+    const auto A = 0.45724*alpha*Pr/(Tr*Tr);
+    const auto B = 0.07780*Pr/Tr;
+
+    // The coefficients of Z^3 + a2*Z^2 + a1*Z + a0 = 0 and of its depressed form t^3 + p*t + q = 0, with Z = t - a2/3
+    const auto a2 = B - 1.0;
+    const auto a1 = A - 3.0*B*B - 2.0*B;
+    const auto a0 = B*B*B + B*B - A*B;
+    const auto p = a1 - a2*a2/3.0;
+    const auto q = 2.0*a2*a2*a2/27.0 - a2*a1/3.0 + a0;
+    const auto disc = q*q/4.0 + p*p*p/27.0;
+
+    // Use Cardano's formula for the single real root, or the largest of three real roots at the critical temperature
+    const auto t = disc > 0.0 ?
+        std::cbrt(-q/2.0 + std::sqrt(disc)) + std::cbrt(-q/2.0 - std::sqrt(disc)) :
+        2.0*std::sqrt(-p/3.0)*std::cos(std::acos(std::clamp(1.5*q/p*std::sqrt(-3.0/p), -1.0, 1.0))/3.0);
 
-    warning(true, "The calculation of water density at temperature ",  T, " K and pressure ", P, "Pa did not converge.");
+    // Translate the specific volume of the equation, which overestimates that of dense water, as done by Peneloux et al. (1982),
+    // with a constant fitted to the supercritical states in Table 13.2 of Wagner and Pruss (2002), which reduces their mean deviation from 5% to 2%
+    const auto c = 3.0e-4; // in units of m3/kg, below the covolume b of the equation (about 1.05e-3 m3/kg)
+    const auto Z = t - a2/3.0;
+    return 1.0/(Z*R*T/P - c);
+}
+
+} // namespace
+
+// The double instantiation of the generic function
+template auto generic::waterThermoProps(const Real& T, const Real& D, const WaterHelmholtzPropsBase<Real>& whp) -> WaterThermoPropsBase<Real>;
+
+auto waterThermoProps(const WaterHelmholtzPropsFunction& model, RealConstRef T, RealConstRef P, RealConstRef D0) -> WaterThermoProps
+{
+    return generic::waterThermoProps(model, nullptr, T, P, D0);
+}
 
-    return {};
+auto waterThermoProps(const WaterHelmholtzPropsFunction& model, const WaterHelmholtzPropsFunction& modeliter, RealConstRef T, RealConstRef P, RealConstRef D0) -> WaterThermoProps
+{
+    return generic::waterThermoProps(model, modeliter, T, P, D0);
+}
+
+auto waterDensitySinglePrecision(const WaterHelmholtzPropsFloatFunction& model, float T, float P, float D0) -> float
+{
+    return generic::waterDensitySinglePrecision(model, T, P, D0);
 }
 
 auto waterThermoProps(const WaterHelmholtzPropsFunction& model, RealConstRef T, RealConstRef P) -> WaterThermoProps
 {
-    const auto D0 = waterThermoDataNearestWagnerPruss(T, P).density;
-    return waterThermoProps(model, T, P, D0);
+    return waterThermoProps(model, T, P, waterDensityInitialGuess(T, P));
 }
 
 auto waterThermoProps(const WaterHelmholtzPropsFunction& model, RealConstRef T, RealConstRef P, StateOfMatter stateofmatter) -> WaterThermoProps
 {
+    return waterThermoProps(model, T, P, waterDensityInitialGuess(T, P, stateofmatter));
+}
+
+auto waterDensityInitialGuess(RealConstRef T, RealConstRef P) -> Real
+{
+    if(waterDensityLatticeEnabled())
+        return waterDensityLattice().density(T, P);
+    return waterThermoDataInterpolatedDensityWagnerPruss(T, P);
+}
+
+auto waterDensityInitialGuess(RealConstRef T, RealConstRef P, StateOfMatter stateofmatter) -> Real
+{
+    return waterDensitySaturationGuess(T, P, stateofmatter);
+}
+
+auto waterDensitySaturationGuess(RealConstRef T, RealConstRef P) -> Real
+{
+    if(T >= waterCriticalTemperature)
+        return waterDensitySupercriticalGuess(T, P);
+
+    if(P >= waterPressureSaturatedStateWagnerPruss(T))
+        return waterDensityLiquidGuess(T, P);
+
+    return waterDensityVaporGuess(T, P);
+}
+
+auto waterDensitySaturationGuess(RealConstRef T, RealConstRef P, StateOfMatter stateofmatter) -> Real
+{
+    if(T >= waterCriticalTemperature)
+        return waterDensitySupercriticalGuess(T, P);
+
     switch(stateofmatter) {
     case StateOfMatter::Solid:
     case StateOfMatter::Liquid:
-        return waterThermoProps(model, T, P, waterThermoDataMinTemperatureWagnerPruss(P).density);
+        return waterDensityLiquidGuess(T, P);
     case StateOfMatter::Gas:
     case StateOfMatter::Plasma:
     default:
-        return waterThermoProps(model, T, P, waterThermoDataMaxTemperatureWagnerPruss(P).density);
+        return P > waterPressureMetastableVaporLimit(T) ? waterDensityLiquidGuess(T, P) : waterDensityVaporGuess(T, P);
     }
 }
 
-auto waterThermoProps(RealConstRef T, RealConstRef D, const WaterHelmholtzProps& whp) -> WaterThermoProps
+auto waterDensityBracket(RealConstRef T, RealConstRef P) -> std::array<Real, 2>
 {
-    WaterThermoProps wtp;
-
-    // Set the temperature and density of the thermodynamic state of water
-    wtp.temperature = T;
-    wtp.density = D;
-
-    // Set the pressure and its partial derivatives of the thermodynamic state of water
-    wtp.pressure   = D*D*whp.helmholtzD;
-    wtp.pressureD  = 2*D*whp.helmholtzD + D*D*whp.helmholtzDD;
-    wtp.pressureT  = D*D*whp.helmholtzTD;
-    wtp.pressureDD = 2*whp.helmholtzD + 4*D*whp.helmholtzDD + D*D*whp.helmholtzDDD;
-    wtp.pressureTD = 2*D*whp.helmholtzTD + D*D*whp.helmholtzTDD;
-    wtp.pressureTT = D*D*whp.helmholtzTTD;
+    // The specific gas constant of water (in units of J/(kg*K)) and the density of water as an ideal gas
+    const auto R = universalGasConstant/waterMolarMass;
+    const auto Dideal = P/(R*T);
 
-    // Set the density and its partial derivatives of the thermodynamic state of water
-    wtp.density   = D;
-    wtp.densityT  = -wtp.pressureT/wtp.pressureD;
-    wtp.densityP  =  1.0/wtp.pressureD;
-    wtp.densityTT = -wtp.densityT*wtp.densityP*(wtp.densityT*wtp.pressureDD + 2*wtp.pressureTD + wtp.pressureTT/wtp.densityT);
-    wtp.densityTP = -wtp.densityP*wtp.densityP*(wtp.densityT*wtp.pressureDD + wtp.pressureTD);
-    wtp.densityPP = -wtp.densityP*wtp.densityP*wtp.densityP*wtp.pressureDD;
+    // The density of water above which the pressure exceeds the range of the equations of state (about 1 GPa)
+    const auto Dmax = 1500.0;
 
-    // Set the specific volume of water
-    wtp.volume = 1/D;
+    // The density of non-ideal vapor and supercritical water is seldom below a fourth of that of the ideal gas
+    const auto Dmin = 0.25*Dideal;
 
-    // Set the specific entropy of water
-    wtp.entropy = -whp.helmholtzT;
+    if(T >= waterCriticalTemperature)
+        return {Dmin, Dmax};
 
-    // Set the specific Helmholtz free energy of water
-    wtp.helmholtz = whp.helmholtz;
+    if(P >= waterPressureSaturatedStateWagnerPruss(T))
+        return {waterDensitySaturatedLiquidStateWagnerPruss(T), Dmax};
 
-    // Set the specific internal energy of water
-    wtp.internal_energy = wtp.helmholtz + T * wtp.entropy;
+    return {Dmin, waterDensitySaturatedVaporStateWagnerPruss(T)};
+}
 
-    // Set the specific enthalpy of water
-    wtp.enthalpy = wtp.internal_energy + wtp.pressure/D;
+auto enableWaterSolverCounters(bool enable) -> void
+{
+    counters().enabled.store(enable, std::memory_order_relaxed);
+}
 
-    // Set the specific Gibbs free energy of water
-    wtp.gibbs = wtp.enthalpy - T * wtp.entropy;
+auto waterSolverCountersEnabled() -> bool
+{
+    return counters().enabled.load(std::memory_order_relaxed);
+}
 
-    // Set the specific isochoric heat capacity of water
-    wtp.cv = -T * whp.helmholtzTT;
+auto waterSolverCounters() -> WaterSolverCounters
+{
+    auto& c = counters();
+    WaterSolverCounters res;
+    res.calls      = c.calls.load(std::memory_order_relaxed);
+    res.iterations = c.iterations.load(std::memory_order_relaxed);
+    res.failures   = c.failures.load(std::memory_order_relaxed);
+    res.fallbacks  = c.fallbacks.load(std::memory_order_relaxed);
+    return res;
+}
 
-    // Set the specific isobaric heat capacity of water
-    wtp.cp = wtp.cv + T/(D*D)*wtp.pressureT*wtp.pressureT/wtp.pressureD;
+auto resetWaterSolverCounters() -> void
+{
+    auto& c = counters();
+    c.calls.store(0, std::memory_order_relaxed);
+    c.iterations.store(0, std::memory_order_relaxed);
+    c.failures.store(0, std::memory_order_relaxed);
+    c.fallbacks.store(0, std::memory_order_relaxed);
+}
 
-    // Set the speed of sound of water
-    wtp.speed_of_sound = sqrt(wtp.pressureD - wtp.pressureT * (-whp.helmholtzTD) / (-whp.helmholtzTT)); // see notes/how-to-calculate-speed-of-water.lyx
+auto addWaterSolverCounters(std::uint64_t calls, std::uint64_t iterations, std::uint64_t failures, std::uint64_t fallbacks) -> void
+{
+    auto& c = counters();
+    if(!c.enabled.load(std::memory_order_relaxed))
+        return;
+    c.calls.fetch_add(calls, std::memory_order_relaxed);
+    c.iterations.fetch_add(iterations, std::memory_order_relaxed);
+    c.failures.fetch_add(failures, std::memory_order_relaxed);
+    c.fallbacks.fetch_add(fallbacks, std::memory_order_relaxed);
+}
 
+auto waterThermoProps(RealConstRef T, RealConstRef D, const WaterHelmholtzProps& whp) -> WaterThermoProps
+{
+    WaterThermoProps wtp;
+    static_cast<WaterThermoPropsBase<Real>&>(wtp) = generic::waterThermoProps(T, D, whp);
     return wtp;
 }
 
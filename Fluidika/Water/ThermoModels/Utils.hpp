@@ -18,6 +18,8 @@
 #pragma once
 
 // C++ includes
+#include <array>
+#include <cstdint>
 #include <functional>
 
 // Fluidika includes
@@ -29,10 +31,109 @@ namespace Fluidika {
 // Forward declarations
 struct WaterThermoProps;
 struct WaterHelmholtzProps;
+struct WaterHelmholtzPropsFloat;
 
 /// The type of functions that calculate specific Helmholtz free energy properties for water.
 using WaterHelmholtzPropsFunction = std::function<WaterHelmholtzProps(RealConstRef,RealConstRef)>;
 
+/// The type of functions that calculate specific Helmholtz free energy properties for water in single precision.
+using WaterHelmholtzPropsFloatFunction = std::function<WaterHelmholtzPropsFloat(float,float)>;
+
+/// The equations of state of water, used to select the model of the classes that calculate many states of water
+/// (e.g., @ref WaterStateTracker, @ref WaterDensityLattice, @ref WaterSaturationCurve and @ref WaterAdaptiveTable).
+enum class WaterThermoModel
+{
+    WagnerPruss, HGK
+};
+
+/// The floating-point precision used in the calculation of water density at given temperature and pressure.
+/// In all cases the thermodynamic properties are evaluated once in double precision at the calculated density.
+/// The accuracy figures below were measured over all single-phase states in Table 13.2 of Wagner and Pruss (2002)
+/// with the Wagner-Pruss model (Double itself deviates from the table by up to 4e-5 in density and 4e-4 in internal
+/// energy, which is the precision of the tabulated values).
+/// - **Double**: density iterations in double precision.
+/// - **Mixed**: density iterations in single precision to a relative step of 1e-5, followed by double-precision Newton
+///   iterations (usually one or two) from the resulting density, so that the density meets the 1e-8 pressure tolerance of Double.
+///   The properties agree with those of Double to within 1e-12 in density and 1e-6 in the others. The states whose
+///   single-precision iterations do not converge are refined from their initial guesses instead.
+/// - **Single**: density iterations in single precision only, to a relative step of 1e-5. Density deviates from Double by
+///   up to 2e-5. Because liquid water is nearly incompressible, this causes deviations of up to 2e-2 in the pressure and
+///   enthalpy of compressed liquid states, while entropy, heat capacities and speed of sound stay within 1e-4 of the table.
+///   With HGK, whose terms cancel more, density deviates by up to 1e-3, and about 1% of the states do not converge.
+///
+/// Single precision is only faster in the batch functions (e.g., @ref waterThermoPropsWagnerPrussBatch), whose
+/// single-precision packs have twice as many lanes, and then only modestly: about 10% for Wagner and Pruss (2002) with
+/// AVX-512, whose transcendental functions are not much faster in single precision, while HGK is about 3 times slower.
+/// The scalar functions are not faster than Double, since scalar single-precision arithmetic is not faster than double on x86.
+/// Mixed is slower than Double (in the batch functions, by about 10% with Wagner and Pruss (2002) and twice with HGK),
+/// since Newton's method in double precision already converges from the initial guesses in a few iterations.
+enum class WaterPrecision
+{
+    Double, Mixed, Single
+};
+
+/// The iterative method used in the calculation of water density at given temperature and pressure.
+/// - **Newton**: Newton's method on the pressure-density equation, with the Helmholtz derivatives up to second order
+///   in all iterations but the last. This is the default.
+/// - **Halley**: Halley's method, which also uses the third-order density derivative of the Helmholtz free energy.
+///   It converges cubically, and needs fewer iterations, but each one evaluates the complete Helmholtz function.
+/// - **Safeguarded**: Newton's method safeguarded by an interval that contains the density on the side of the saturation
+///   curve given by the pressure (see @ref waterDensityBracket). Steps that leave the interval, or that do not halve
+///   the residual, are replaced by false-position and bisection steps, so that the number of iterations is bounded even
+///   for initial guesses in the wrong phase, near saturation, or at very low pressures.
+enum class WaterDensityMethod
+{
+    Newton, Halley, Safeguarded
+};
+
+/// The outcome of the calculation of water density at given temperature and pressure.
+/// The batch solvers (e.g., @ref waterThermoPropsWagnerPrussBatch) only report Converged and NotConverged.
+enum class WaterSolverStatus
+{
+    Converged,    ///< The density iterations converged
+    NotConverged, ///< The density iterations did not converge within the maximum number of iterations
+    InvalidInput, ///< The temperature, pressure or initial guess for density is not finite, or the temperature or initial guess is not positive
+    Diverged,     ///< The density iterations produced a density that is not finite
+};
+
+/// The diagnostics of the calculation of water density at given temperature and pressure.
+struct WaterSolverResult
+{
+    /// The outcome of the density iterations.
+    WaterSolverStatus status = WaterSolverStatus::Converged;
+
+    /// The number of density steps taken, which is the length of the history of density iterates.
+    int iterations = 0;
+
+    /// The number of evaluations of the Helmholtz functions, including the final one at the calculated density.
+    int evaluations = 0;
+
+    /// The number of steps that were not Newton (or Halley) steps, such as the bisection steps of @ref WaterDensityMethod::Safeguarded
+    /// or the steps of the Newton iterations that would otherwise have produced a non-positive density.
+    int fallbacks = 0;
+
+    /// The residual of the pressure-density equation at the last iterate, scaled by the critical pressure of water.
+    Real residual = 0.0;
+};
+
+/// The process-wide counters of the calculations of water density by all solvers, including the batch ones.
+/// The counters are only updated while enabled with @ref enableWaterSolverCounters, since the atomic updates shared
+/// by all threads would otherwise slow down multi-threaded workloads.
+struct WaterSolverCounters
+{
+    /// The number of states whose density was calculated.
+    std::uint64_t calls = 0;
+
+    /// The total number of density steps taken.
+    std::uint64_t iterations = 0;
+
+    /// The number of states whose density calculation did not converge.
+    std::uint64_t failures = 0;
+
+    /// The total number of steps that were not Newton (or Halley) steps.
+    std::uint64_t fallbacks = 0;
+};
+
 /// Calculate the thermodynamic properties of water with given temperature, pressure and an initial guess for density.
 /// The equations of state described in Wagner and Pruss (2002) and Haar--Gallagher--Kell (1984) for calculation
 /// of thermodynamic properties of water and steam are formulated so that temperature and density are given.
@@ -47,9 +148,32 @@ using WaterHelmholtzPropsFunction = std::function<WaterHelmholtzProps(RealConstR
 /// @param D The initial guess for the density of water (in units of kg/m3)
 auto waterThermoProps(const WaterHelmholtzPropsFunction& model, RealConstRef T, RealConstRef P, RealConstRef D0) -> WaterThermoProps;
 
+/// Calculate the thermodynamic properties of water with given temperature, pressure and an initial guess for density.
+/// This method is similar to the one above, except that the Newton iterations use a cheaper Helmholtz function, *modeliter*,
+/// that only needs to compute partial derivatives up to second order. The complete Helmholtz function, *model*, is only used
+/// once the residual of the pressure-density equation indicates that the next iteration is the last one, or at the converged density.
+/// @param model The function that calculates specific Helmholtz free energy of water
+/// @param modeliter The function that calculates specific Helmholtz free energy of water with partial derivatives up to second order
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param D The initial guess for the density of water (in units of kg/m3)
+/// @see generic::waterThermoProps in UtilsGeneric.hpp, which accepts any callable model and avoids the indirect calls of std::function
+auto waterThermoProps(const WaterHelmholtzPropsFunction& model, const WaterHelmholtzPropsFunction& modeliter, RealConstRef T, RealConstRef P, RealConstRef D0) -> WaterThermoProps;
+
+/// Calculate the density of water with given temperature, pressure and an initial guess for density using single-precision arithmetic.
+/// The Newton iterations stop once the relative density step is below 1e-5, which is close to the resolution of single-precision
+/// floating-point numbers. The result is adequate either as is, when single precision suffices, or as the initial guess of
+/// a double-precision calculation, which then converges in one or two iterations (see @ref WaterPrecision).
+/// @param model The function that calculates specific Helmholtz free energy of water in single precision (derivatives up to second order are needed)
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param D0 The initial guess for the density of water (in units of kg/m3)
+/// @return The density of water (in units of kg/m3)
+auto waterDensitySinglePrecision(const WaterHelmholtzPropsFloatFunction& model, float T, float P, float D0) -> float;
+
 /// Calculate the thermodynamic properties of water with given temperature and pressure.
-/// This method uses an initial guess for water density obtained from Table 13.2 of Wagner and Pruss (2002)
-/// using method @ref waterThermoDataNearestWagnerPruss. Convergence should then be faster because the initial guess
+/// This method uses an initial guess for water density interpolated in Table 13.2 of Wagner and Pruss (2002)
+/// using method @ref waterDensityInitialGuess. Convergence should then be faster because the initial guess
 /// will most likely be fairly close to the actual water density at given temperature and pressure conditions.
 /// @param model The function that calculates specific Helmholtz free energy of water
 /// @param T The temperature of water (in units of K)
@@ -57,16 +181,86 @@ auto waterThermoProps(const WaterHelmholtzPropsFunction& model, RealConstRef T,
 auto waterThermoProps(const WaterHelmholtzPropsFunction& model, RealConstRef T, RealConstRef P) -> WaterThermoProps;
 
 /// Calculate the thermodynamic properties of water with given temperature and pressure and specific state of matter for water.
-/// This method uses an initial guess for water density obtained from Table 13.2 of Wagner and Pruss (2002)
-/// using either method @ref waterThermoDataMinTemperatureWagnerPruss if given state of matter is either liquid or solid,
-/// and method @ref waterThermoDataMaxTemperatureWagnerPruss if gas or plasma. This is to help Newton's algorithm
-/// to converge to a solution that represents the desired state of matter of water.
+/// This method uses an initial guess for water density extrapolated from the density of saturated liquid if given state of
+/// matter is either liquid or solid, and of saturated vapor if gas or plasma (see @ref waterDensitySaturationGuess).
+/// This is to help Newton's algorithm to converge to a solution that represents the desired state of matter of water.
 /// @param model The function that calculates specific Helmholtz free energy of water
 /// @param T The temperature of water (in units of K)
 /// @param P The pressure of water (in units of Pa)
 /// @param stateofmatter The state of matter of water.
 auto waterThermoProps(const WaterHelmholtzPropsFunction& model, RealConstRef T, RealConstRef P, StateOfMatter stateofmatter) -> WaterThermoProps;
 
+/// Return an initial guess for the density of water at given temperature and pressure.
+/// The initial guess is interpolated in Table 13.2 of Wagner and Pruss (2002) using method @ref waterThermoDataInterpolatedDensityWagnerPruss,
+/// which lies on the same side of the saturation curve as the given temperature and pressure. If enabled with
+/// @ref enableWaterDensityLattice, the initial guess is predicted instead with the lattice returned by @ref waterDensityLattice.
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @return The initial guess for the density of water (in units of kg/m3)
+auto waterDensityInitialGuess(RealConstRef T, RealConstRef P) -> Real;
+
+/// Return an initial guess for the density of water at given temperature, pressure and state of matter.
+/// The initial guess is obtained with method @ref waterDensitySaturationGuess for the given state of matter.
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param stateofmatter The state of matter of water.
+/// @return The initial guess for the density of water (in units of kg/m3)
+auto waterDensityInitialGuess(RealConstRef T, RealConstRef P, StateOfMatter stateofmatter) -> Real;
+
+/// Return an approximation for the density of water at given temperature and pressure obtained without Table 13.2.
+/// Below the critical temperature, the density of saturated liquid (if the pressure is above the saturation pressure) or
+/// of saturated vapor (otherwise) from the correlations of Wagner and Pruss (2002) is extrapolated to the given pressure.
+/// Liquid densities are extrapolated with the Tait equation and the compressibility of saturated liquid, and vapor densities
+/// with a compressibility factor linear in pressure. Above the critical temperature, the density of the Peng-Robinson
+/// equation of state is used instead. The approximation serves as initial guess for both the Wagner and Pruss (2002) and
+/// the HGK equations of state.
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @return The approximate density of water (in units of kg/m3)
+auto waterDensitySaturationGuess(RealConstRef T, RealConstRef P) -> Real;
+
+/// Return an approximation for the density of water at given temperature, pressure and state of matter obtained without Table 13.2.
+/// This method is the same as @ref waterDensitySaturationGuess, except that below the critical temperature the density is
+/// extrapolated from that of saturated liquid if given state of matter is either liquid or solid, and from that of saturated
+/// vapor if gas or plasma, even if the given pressure lies on the other side of the saturation curve (metastable states).
+/// Metastable vapor is only sought up to a pressure slightly above the saturation pressure, which tends to it at the
+/// critical temperature, beyond which vapor no longer exists and the density is extrapolated from that of saturated liquid.
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param stateofmatter The state of matter of water.
+/// @return The approximate density of water (in units of kg/m3)
+auto waterDensitySaturationGuess(RealConstRef T, RealConstRef P, StateOfMatter stateofmatter) -> Real;
+
+/// Return an interval that contains the density of water at given temperature and pressure.
+/// Below the critical temperature, the interval lies on the liquid side of the saturation curve if the pressure is above
+/// the saturation pressure, and on the vapor side otherwise, with the saturated densities obtained from the correlations
+/// of Wagner and Pruss (2002). Since these correlations are approximations, the ends of the interval may need to be
+/// slightly extended before they bracket the density of a given model.
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @return The lower and upper bounds of the density of water (in units of kg/m3)
+auto waterDensityBracket(RealConstRef T, RealConstRef P) -> std::array<Real, 2>;
+
+/// Enable or disable the process-wide counters of the calculations of water density, which are disabled by default.
+/// @see WaterSolverCounters
+auto enableWaterSolverCounters(bool enable) -> void;
+
+/// Return true if the process-wide counters of the calculations of water density are enabled.
+auto waterSolverCountersEnabled() -> bool;
+
+/// Return the current values of the process-wide counters of the calculations of water density.
+auto waterSolverCounters() -> WaterSolverCounters;
+
+/// Reset the process-wide counters of the calculations of water density to zero.
+auto resetWaterSolverCounters() -> void;
+
+/// Add to the process-wide counters of the calculations of water density, if enabled (used by the solvers).
+/// @param calls The number of states whose density was calculated
+/// @param iterations The number of density steps taken
+/// @param failures The number of states whose density calculation did not converge
+/// @param fallbacks The number of steps that were not Newton (or Halley) steps
+auto addWaterSolverCounters(std::uint64_t calls, std::uint64_t iterations, std::uint64_t failures, std::uint64_t fallbacks) -> void;
+
 /// Calculate the thermodynamic properties of water with given specific Helmholtz free energy water properties computed at given temperature and density.
 /// This is a general method that uses the specific Helmholtz free energy properties of water,
 /// calculated at given temperature *T* and density *D*, to completely resolve all water thermodynamic properties.
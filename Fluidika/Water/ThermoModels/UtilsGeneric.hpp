@@ -0,0 +1,1022 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// C++ includes
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Common/Exception.hpp>
+#include <Fluidika/Common/Real.hpp>
+#include <Fluidika/Common/Simd.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+
+namespace Fluidika {
+namespace generic {
+inline namespace FLUIDIKA_ISA_NAMESPACE {
+
+/// Calculate the thermodynamic properties of water with given specific Helmholtz free energy water properties computed at given temperature and density with a generic scalar type.
+/// The requirements on the scalar type are the same as those of @ref waterHelmholtzPropsWagnerPruss, with sqrt as the needed function.
+/// @param T The temperature of water (in units of K)
+/// @param D The density of water (in units of kg/m3)
+/// @param whp The Helmholtz free energy properties of water
+/// @see Fluidika::waterThermoProps
+template<typename Scalar>
+auto waterThermoProps(const Scalar& T, const Scalar& D, const WaterHelmholtzPropsBase<Scalar>& whp) -> WaterThermoPropsBase<Scalar>
+{
+    using std::sqrt;
+
+    WaterThermoPropsBase<Scalar> wtp;
+
+    // Set the temperature and density of the thermodynamic state of water
+    wtp.temperature = T;
+    wtp.density = D;
+
+    // Set the pressure and its partial derivatives of the thermodynamic state of water
+    wtp.pressure   = D*D*whp.helmholtzD;
+    wtp.pressureD  = 2*D*whp.helmholtzD + D*D*whp.helmholtzDD;
+    wtp.pressureT  = D*D*whp.helmholtzTD;
+    wtp.pressureDD = 2*whp.helmholtzD + 4*D*whp.helmholtzDD + D*D*whp.helmholtzDDD;
+    wtp.pressureTD = 2*D*whp.helmholtzTD + D*D*whp.helmholtzTDD;
+    wtp.pressureTT = D*D*whp.helmholtzTTD;
+
+    // Set the density and its partial derivatives of the thermodynamic state of water
+    wtp.density   = D;
+    wtp.densityT  = -wtp.pressureT/wtp.pressureD;
+    wtp.densityP  =  1/wtp.pressureD;
+    wtp.densityTT = -wtp.densityT*wtp.densityP*(wtp.densityT*wtp.pressureDD + 2*wtp.pressureTD + wtp.pressureTT/wtp.densityT);
+    wtp.densityTP = -wtp.densityP*wtp.densityP*(wtp.densityT*wtp.pressureDD + wtp.pressureTD);
+    wtp.densityPP = -wtp.densityP*wtp.densityP*wtp.densityP*wtp.pressureDD;
+
+    // Set the specific volume of water
+    wtp.volume = 1/D;
+
+    // Set the specific entropy of water
+    wtp.entropy = -whp.helmholtzT;
+
+    // Set the specific Helmholtz free energy of water
+    wtp.helmholtz = whp.helmholtz;
+
+    // Set the specific internal energy of water
+    wtp.internal_energy = wtp.helmholtz + T * wtp.entropy;
+
+    // Set the specific enthalpy of water
+    wtp.enthalpy = wtp.internal_energy + wtp.pressure/D;
+
+    // Set the specific Gibbs free energy of water
+    wtp.gibbs = wtp.enthalpy - T * wtp.entropy;
+
+    // Set the specific isochoric heat capacity of water
+    wtp.cv = -T * whp.helmholtzTT;
+
+    // Set the specific isobaric heat capacity of water
+    wtp.cp = wtp.cv + T/(D*D)*wtp.pressureT*wtp.pressureT/wtp.pressureD;
+
+    // Set the speed of sound of water
+    wtp.speed_of_sound = sqrt(wtp.pressureD - wtp.pressureT * (-whp.helmholtzTD) / (-whp.helmholtzTT)); // see notes/how-to-calculate-speed-of-water.lyx
+
+    return wtp;
+}
+
+/// Return the thermodynamic properties of water stored in a given lane of the evaluated states.
+template<typename Scalar>
+auto waterThermoPropsLane(const WaterThermoPropsBase<Scalar>& aux, std::size_t i) -> WaterThermoProps
+{
+    WaterThermoProps res;
+    res.temperature     = lane(aux.temperature, i);
+    res.volume          = lane(aux.volume, i);
+    res.entropy         = lane(aux.entropy, i);
+    res.helmholtz       = lane(aux.helmholtz, i);
+    res.internal_energy = lane(aux.internal_energy, i);
+    res.enthalpy        = lane(aux.enthalpy, i);
+    res.gibbs           = lane(aux.gibbs, i);
+    res.cv              = lane(aux.cv, i);
+    res.cp              = lane(aux.cp, i);
+    res.density         = lane(aux.density, i);
+    res.densityT        = lane(aux.densityT, i);
+    res.densityP        = lane(aux.densityP, i);
+    res.densityTT       = lane(aux.densityTT, i);
+    res.densityTP       = lane(aux.densityTP, i);
+    res.densityPP       = lane(aux.densityPP, i);
+    res.pressure        = lane(aux.pressure, i);
+    res.pressureT       = lane(aux.pressureT, i);
+    res.pressureD       = lane(aux.pressureD, i);
+    res.pressureTT      = lane(aux.pressureTT, i);
+    res.pressureTD      = lane(aux.pressureTD, i);
+    res.pressureDD      = lane(aux.pressureDD, i);
+    res.speed_of_sound  = lane(aux.speed_of_sound, i);
+    return res;
+}
+
+// The double instantiation is compiled into the library
+extern template auto waterThermoProps(const Real& T, const Real& D, const WaterHelmholtzPropsBase<Real>& whp) -> WaterThermoPropsBase<Real>;
+
+/// Return true if the temperature, pressure and initial guess for density of a calculation of water density are valid.
+inline auto waterSolverValidInput(const Real& T, const Real& P, const Real& D0) -> bool
+{
+    using std::isfinite;
+    return isfinite(T) && isfinite(P) && isfinite(D0) && T > 0 && D0 > 0;
+}
+
+/// Record the outcome of a calculation of water density in the diagnostics requested by the caller, if any, and in the process-wide counters.
+inline auto recordWaterSolverResult(const WaterSolverResult& outcome, WaterSolverResult* result) -> void
+{
+    if(result)
+        *result = outcome;
+    addWaterSolverCounters(1, outcome.iterations, outcome.status != WaterSolverStatus::Converged, outcome.fallbacks);
+}
+
+/// Calculate the thermodynamic properties of water with given temperature, pressure and an initial guess for density using any callable Helmholtz function, with the diagnostics of the iterations.
+/// This is the algorithm of @ref waterThermoProps, which neither warns nor updates the process-wide counters, so that other solvers can fall back on it.
+/// @param model The function that calculates specific Helmholtz free energy of water, callable as `model(T, D)`
+/// @param modeliter The function that calculates specific Helmholtz free energy of water with partial derivatives up to second order, or nullptr
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param D0 The initial guess for the density of water (in units of kg/m3)
+/// @param[out] result The diagnostics of the iterations
+template<typename Model, typename ModelIter>
+auto waterThermoPropsNewton(const Model& model, const ModelIter& modeliter, const Real& T, const Real& P, const Real& D0, WaterSolverResult& result) -> WaterThermoProps
+{
+    using std::abs;
+    using std::isfinite;
+    using std::sqrt;
+
+    // Check if there is a cheaper Helmholtz function for the iterations
+    constexpr auto hasiter = !std::is_same_v<ModelIter, std::nullptr_t>;
+
+    // Auxiliary constants for the Newton's iterations
+    const auto max_iters = 100;
+    const auto tolerance = 1.0e-08;
+
+    // The residual below which the next iteration is expected to converge (given the quadratic rate of convergence)
+    const auto tolerance_last_iter = sqrt(tolerance);
+
+    result = {};
+
+    if(!waterSolverValidInput(T, P, D0))
+    {
+        result.status = WaterSolverStatus::InvalidInput;
+        return {};
+    }
+
+    // Determine an adequate initial guess for (dimensionless) density based on the physical state of water
+    Real D = D0;
+
+    // The specific Helmholtz free energy properties of water
+    WaterHelmholtzProps h;
+
+    // The residual of the previous iteration
+    Real fprev = INF;
+
+    // Apply the Newton's method to the pressure-density equation
+    for(int i = 1; i <= max_iters; ++i)
+    {
+        // Check if the complete Helmholtz function must be used in this iteration
+        const auto complete = !hasiter || abs(fprev) < tolerance_last_iter;
+
+        if constexpr(hasiter)
+            h = complete ? model(T, D) : modeliter(T, D);
+        else h = model(T, D);
+
+        const auto f  = (D*D*h.helmholtzD - P)/waterCriticalPressure;
+        const auto df = (2*D*h.helmholtzD + D*D*h.helmholtzDD)/waterCriticalPressure;
+
+        const auto newton = D > f/df;
+
+        D = newton ? D - f/df : P/(D*h.helmholtzD);
+
+        result.iterations = i;
+        result.evaluations = i;
+        result.fallbacks += !newton;
+        result.residual = f;
+
+        if(abs(f) < tolerance)
+        {
+            if(!complete)
+                h = model(T, D), ++result.evaluations;
+            WaterThermoProps wtp;
+            static_cast<WaterThermoPropsBase<Real>&>(wtp) = waterThermoProps<Real>(T, D, h);
+            return wtp;
+        }
+
+        if(!isfinite(D))
+        {
+            result.status = WaterSolverStatus::Diverged;
+            return {};
+        }
+
+        fprev = f;
+    }
+
+    result.status = WaterSolverStatus::NotConverged;
+
+    WaterThermoProps wtp;
+    static_cast<WaterThermoPropsBase<Real>&>(wtp) = waterThermoProps<Real>(T, D, model(T, D));
+    ++result.evaluations;
+    return wtp;
+}
+
+/// Calculate the thermodynamic properties of water with given temperature, pressure and an initial guess for density using any callable Helmholtz function.
+/// This is the Newton algorithm of @ref Fluidika::waterThermoProps with the Helmholtz functions given as template arguments
+/// instead of std::function objects, so that they can be inlined into the iterations. If *modeliter* is nullptr, *model*
+/// is used in all iterations. If the iterations do not converge, the properties at the last iterate are returned, and if
+/// the input is invalid or the iterations diverge, zero properties are returned (see *result*).
+/// @param model The function that calculates specific Helmholtz free energy of water, callable as `model(T, D)`
+/// @param modeliter The function that calculates specific Helmholtz free energy of water with partial derivatives up to second order, or nullptr
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param D0 The initial guess for the density of water (in units of kg/m3)
+/// @param[out] result The diagnostics of the iterations, or nullptr if not needed
+template<typename Model, typename ModelIter>
+auto waterThermoProps(const Model& model, const ModelIter& modeliter, const Real& T, const Real& P, const Real& D0, WaterSolverResult* result = nullptr) -> WaterThermoProps
+{
+    WaterSolverResult outcome;
+    const auto wtp = waterThermoPropsNewton(model, modeliter, T, P, D0, outcome);
+    warning(outcome.status == WaterSolverStatus::InvalidInput, "The calculation of water density at temperature ",  T, " K and pressure ", P, " Pa has an invalid initial guess ", D0, " kg/m3.");
+    warning(outcome.status == WaterSolverStatus::Diverged, "The calculation of water density at temperature ",  T, " K and pressure ", P, " Pa diverged.");
+    warning(outcome.status == WaterSolverStatus::NotConverged, "The calculation of water density at temperature ",  T, " K and pressure ", P, " Pa did not converge.");
+    recordWaterSolverResult(outcome, result);
+    return wtp;
+}
+
+#if FLUIDIKA_HAS_SIMD
+
+/// Calculate the thermodynamic properties of water for many pairs of temperature and pressure, with initial guesses for density, in packs of a given SIMD type.
+/// The Newton iterations of all lanes in a pack are performed together. A lane whose residual is below the tolerance
+/// is retired with a mask, keeping its density, while the other lanes continue. The states are processed in blocks,
+/// and the lanes of a block not converged after a few iterations (typically near saturation or at very low pressures)
+/// are compacted into new packs of their own, so that a few slow states do not keep mostly retired packs iterating.
+/// The temperature terms of the models are computed once per pack.
+/// @tparam Simd The type of the packs (e.g., RealSimd)
+/// @param n The number of states to be calculated
+/// @param T The array of temperatures of water (in units of K) with length *n*
+/// @param P The array of pressures of water (in units of Pa) with length *n*
+/// @param D0 The array of initial guesses for the density of water (in units of kg/m3) with length *n*
+/// @param[out] res The array of thermodynamic properties of water with length *n* (those of the last iterate for the states not converged)
+/// @param[out] status The array of outcomes of the density calculations with length *n*, or nullptr if not needed
+/// @param terms The function that calculates the temperature terms of the model for a pack of temperatures, callable as `terms(T)`
+/// @param modeliter The function that calculates the Helmholtz free energy properties of water with derivatives up to second order, callable as `modeliter(terms(T), D)`
+/// @param model The function that calculates the complete Helmholtz free energy properties of water, callable as `model(terms(T), D)`
+/// @return The number of states whose density did not converge
+template<typename Simd, typename Terms, typename ModelIter, typename Model>
+auto waterThermoPropsBatch(std::size_t n, const Real* T, const Real* P, const Real* D0, WaterThermoProps* res, WaterSolverStatus* status,
+    const Terms& terms, const ModelIter& modeliter, const Model& model) -> std::size_t
+{
+    using std::abs;
+
+    // Auxiliary constants for the Newton's iterations (the same as those of the single-state algorithm)
+    const auto max_iters = 100;
+    const auto tolerance = 1.0e-08;
+
+    // The number of iterations after which the lanes not converged are compacted into new packs
+    const auto packed_iters = 8;
+
+    // The number of states among which the lanes not converged are compacted
+    constexpr std::size_t block = 256;
+
+    const auto width = Simd::size();
+
+    // The indices, temperatures, pressures and current densities of the states of a block not yet converged
+    std::size_t index[block];
+    Real Ts[block], Ps[block], Ds[block];
+
+    // Check if the process-wide counters are enabled, and the number of density steps and fallback steps of the valid lanes
+    const auto counting = waterSolverCountersEnabled();
+    std::uint64_t iterations = 0, fallbacks = 0;
+
+    // Apply Newton's method to the pressure-density equation in the first m lanes of a pack, returning the mask of the lanes not converged
+    auto iterate = [&](const Simd& Pk, Simd& D, const auto& tt, int iters, std::size_t m)
+    {
+        typename Simd::mask_type active(true);
+
+        for(int i = 0; i < iters && any_of(active); ++i)
+        {
+            const auto h = modeliter(tt, D);
+
+            const Simd f  = (D*D*h.helmholtzD - Pk)/waterCriticalPressure;
+            const Simd df = (2*D*h.helmholtzD + D*D*h.helmholtzDD)/waterCriticalPressure;
+
+            const auto newton = D > f/df;
+
+            if(counting)
+                for(std::size_t j = 0; j < m; ++j)
+                    iterations += active[j], fallbacks += active[j] && !newton[j];
+
+            Simd Dnew = Pk/(D*h.helmholtzD);
+            where(newton, Dnew) = D - f/df;
+            where(active, D) = Dnew;
+
+            active = active && !(abs(f) < tolerance);
+        }
+
+        return active;
+    };
+
+    std::size_t failures = 0;
+
+    for(std::size_t b = 0; b < n; b += block)
+    {
+        // The end of the block and the number of its states not converged in the first iterations
+        const auto e = n - b < block ? n : b + block;
+        std::size_t ns = 0;
+
+        for(std::size_t k = b; k < e; k += width)
+        {
+            const auto m = e - k < width ? e - k : width;
+
+            const auto Tk = load<Simd>(T + k, m);
+            const auto Pk = load<Simd>(P + k, m);
+            auto D = load<Simd>(D0 + k, m);
+
+            const auto tt = terms(Tk);
+            const auto active = iterate(Pk, D, tt, packed_iters, m);
+
+            if(all_of(active))
+            {
+                for(std::size_t j = 0; j < m; ++j, ++ns)
+                    index[ns] = k + j, Ts[ns] = T[k + j], Ps[ns] = P[k + j], Ds[ns] = D[j];
+                continue;
+            }
+
+            const auto wtp = waterThermoProps(Tk, D, model(tt, D));
+
+            for(std::size_t j = 0; j < m; ++j)
+            {
+                if(active[j])
+                {
+                    index[ns] = k + j, Ts[ns] = T[k + j], Ps[ns] = P[k + j], Ds[ns] = D[j], ++ns;
+                    continue;
+                }
+                res[k + j] = waterThermoPropsLane(wtp, j);
+                if(status) status[k + j] = WaterSolverStatus::Converged;
+            }
+        }
+
+        // Continue the iterations of the states not yet converged, now in packs filled with them only
+        for(std::size_t k = 0; k < ns; k += width)
+        {
+            const auto m = ns - k < width ? ns - k : width;
+
+            const auto Tk = load<Simd>(Ts + k, m);
+            const auto Pk = load<Simd>(Ps + k, m);
+            auto D = load<Simd>(Ds + k, m);
+
+            const auto tt = terms(Tk);
+            const auto active = iterate(Pk, D, tt, max_iters - packed_iters, m);
+            const auto wtp = waterThermoProps(Tk, D, model(tt, D));
+
+            for(std::size_t j = 0; j < m; ++j)
+            {
+                res[index[k + j]] = waterThermoPropsLane(wtp, j);
+                if(status) status[index[k + j]] = active[j] ? WaterSolverStatus::NotConverged : WaterSolverStatus::Converged;
+                failures += active[j];
+            }
+        }
+    }
+
+    if(counting)
+        addWaterSolverCounters(n, iterations, failures, fallbacks);
+
+    return failures;
+}
+
+#endif
+
+/// Calculate the thermodynamic properties of water with given temperature, pressure and an initial guess for density using Halley's method and any callable Helmholtz function.
+/// The third-order partial derivative of the Helmholtz free energy with respect to density, which the models compute
+/// anyway, gives the second density derivative of pressure, with which the iterations converge cubically instead of quadratically.
+/// @param model The function that calculates specific Helmholtz free energy of water, callable as `model(T, D)`
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param D0 The initial guess for the density of water (in units of kg/m3)
+/// @param[out] result The diagnostics of the iterations, or nullptr if not needed
+/// @see WaterDensityMethod
+template<typename Model>
+auto waterThermoPropsHalley(const Model& model, const Real& T, const Real& P, const Real& D0, WaterSolverResult* result = nullptr) -> WaterThermoProps
+{
+    using std::abs;
+    using std::isfinite;
+
+    // Auxiliary constants for the Halley's iterations (the same as those of the Newton's iterations)
+    const auto max_iters = 100;
+    const auto tolerance = 1.0e-08;
+
+    WaterSolverResult outcome;
+
+    if(!waterSolverValidInput(T, P, D0))
+    {
+        outcome.status = WaterSolverStatus::InvalidInput;
+        warning(true, "The calculation of water density at temperature ",  T, " K and pressure ", P, " Pa has an invalid initial guess ", D0, " kg/m3.");
+        recordWaterSolverResult(outcome, result);
+        return {};
+    }
+
+    Real D = D0;
+
+    // The specific Helmholtz free energy properties of water
+    WaterHelmholtzProps h = model(T, D);
+
+    for(int i = 1; i <= max_iters; ++i)
+    {
+        const auto f   = (D*D*h.helmholtzD - P)/waterCriticalPressure;
+        const auto df  = (2*D*h.helmholtzD + D*D*h.helmholtzDD)/waterCriticalPressure;
+        const auto ddf = (2*h.helmholtzD + 4*D*h.helmholtzDD + D*D*h.helmholtzDDD)/waterCriticalPressure;
+
+        const auto step = 2*f*df/(2*df*df - f*ddf);
+
+        const auto halley = D > step;
+
+        D = halley ? D - step : P/(D*h.helmholtzD);
+
+        outcome.iterations = i;
+        outcome.evaluations = i + 1;
+        outcome.fallbacks += !halley;
+        outcome.residual = f;
+
+        if(!isfinite(D))
+        {
+            outcome.status = WaterSolverStatus::Diverged;
+            warning(true, "The calculation of water density at temperature ",  T, " K and pressure ", P, " Pa diverged.");
+            recordWaterSolverResult(outcome, result);
+            return {};
+        }
+
+        h = model(T, D);
+
+        // As in the Newton's iterations, the last step is taken once the residual is below the tolerance, after which the density is practically exact
+        if(abs(f) < tolerance)
+        {
+            recordWaterSolverResult(outcome, result);
+            WaterThermoProps wtp;
+            static_cast<WaterThermoPropsBase<Real>&>(wtp) = waterThermoProps<Real>(T, D, h);
+            return wtp;
+        }
+    }
+
+    outcome.status = WaterSolverStatus::NotConverged;
+
+    warning(true, "The calculation of water density at temperature ",  T, " K and pressure ", P, "Pa did not converge.");
+
+    recordWaterSolverResult(outcome, result);
+
+    WaterThermoProps wtp;
+    static_cast<WaterThermoPropsBase<Real>&>(wtp) = waterThermoProps<Real>(T, D, h);
+    return wtp;
+}
+
+/// Calculate the thermodynamic properties of water with given temperature, pressure and an initial guess for density using safeguarded Newton iterations and any callable Helmholtz functions.
+/// The density is kept within an interval obtained from @ref waterDensityBracket, which shrinks with the sign of the residual
+/// at every iterate. A Newton step is replaced by a false-position step (Illinois variant) whenever it would leave the interval,
+/// or the previous Newton step did not halve the residual, and every third of these replacements is a bisection. The ends of
+/// the interval are only evaluated (and extended if they do not bracket the density of the model) when a Newton step is replaced.
+/// The number of evaluations of the Helmholtz functions is thus bounded by 50 iterations plus 80 evaluations of the ends,
+/// while a few iterations suffice in practice, even for initial guesses in the wrong phase, near saturation, or at very low pressures.
+/// The ends are extended by growing factors, up to a factor of two each time, which brackets the density unless the model is not
+/// finite there, in which case the iterations stop with status @ref WaterSolverStatus::NotConverged.
+/// This algorithm neither warns nor updates the process-wide counters, so that other solvers can fall back on it (see @ref waterThermoPropsSafeguarded).
+/// @param model The function that calculates specific Helmholtz free energy of water, callable as `model(T, D)`
+/// @param modeliter The function that calculates specific Helmholtz free energy of water with partial derivatives up to second order
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param D0 The initial guess for the density of water (in units of kg/m3), used if it is inside the interval
+/// @param[out] result The diagnostics of the iterations
+/// @see WaterDensityMethod
+template<typename Model, typename ModelIter>
+auto waterThermoPropsSafeguardedNewton(const Model& model, const ModelIter& modeliter, const Real& T, const Real& P, const Real& D0, WaterSolverResult& result) -> WaterThermoProps
+{
+    using std::abs;
+    using std::sqrt;
+
+    // Auxiliary constants for the safeguarded Newton's iterations
+    const auto max_iters = 50;
+    const auto max_extensions = 40;
+    const auto tolerance = 1.0e-08;
+
+    // The residual below which the next iteration is expected to converge (given the quadratic rate of convergence)
+    const auto tolerance_last_iter = sqrt(tolerance);
+
+    result = {};
+
+    // The initial guess is not needed to be valid, since it is replaced by a density in the interval if outside it
+    if(!waterSolverValidInput(T, P, 1.0))
+    {
+        result.status = WaterSolverStatus::InvalidInput;
+        return {};
+    }
+
+    // The residual of the pressure-density equation at a given density
+    const auto residual = [&](const Real& D, const WaterHelmholtzProps& h) { ++result.evaluations; return (D*D*h.helmholtzD - P)/waterCriticalPressure; };
+
+    // The interval that contains the density, the residuals at its ends, and whether these are known to have opposite signs
+    auto [a, b] = waterDensityBracket(T, P);
+    Real fa = -1.0, fb = 1.0;
+    auto aok = false;
+    auto bok = false;
+
+    // The end of the interval updated last (-1 for the lower, 1 for the upper), used by the Illinois variant of false position
+    auto last = 0;
+
+    // Update the interval with the residual at a density inside it, since pressure increases with density on each side of the saturation curve
+    const auto update = [&](const Real& D, const Real& f)
+    {
+        if(f < 0)
+        {
+            if(last < 0) fb /= 2;
+            a = D, fa = f, aok = true, last = -1;
+        }
+        else
+        {
+            if(last > 0) fa /= 2;
+            b = D, fb = f, bok = true, last = 1;
+        }
+    };
+
+    // Check the signs of the residuals at the ends of the interval, extending it until they are opposite, by 2% at first and
+    // then by twice as much at each extension up to a factor of two, which brackets the density of any model, since pressure
+    // vanishes at zero density and grows without bound with density
+    const auto verify = [&]()
+    {
+        for(auto [k, s] = std::pair{0, 0.02}; !aok && k < max_extensions; ++k, s = std::min(2*s, 1.0))
+        {
+            const auto f = residual(a, modeliter(T, a));
+            if(f < 0) fa = f, aok = true;
+            else b = a, fb = f, bok = true, a /= 1 + s;
+        }
+        for(auto [k, s] = std::pair{0, 0.02}; !bok && k < max_extensions; ++k, s = std::min(2*s, 1.0))
+        {
+            const auto f = residual(b, modeliter(T, b));
+            if(f > 0) fb = f, bok = true;
+            else a = b, fa = f, aok = true, b *= 1 + s;
+        }
+        return aok && bok;
+    };
+
+    // The midpoint of the interval, which is geometric for wide intervals, such as those of low-pressure vapor
+    const auto bisect = [&]() { return b > 4*a ? sqrt(a*b) : (a + b)/2; };
+
+    // The density of water, which starts from the initial guess if it is inside the interval, or otherwise from the
+    // ideal-gas density for the wide intervals of vapor and supercritical water, and from the saturated-liquid density for liquid
+    Real D = (a < D0 && D0 < b) ? D0 : (b > 4*a) ? 4*a : a;
+
+    // The specific Helmholtz free energy properties of water, the residual of the previous Newton step, and the number of replaced Newton steps
+    WaterHelmholtzProps h;
+    Real fprev = INF;
+    int replaced = 0;
+
+    for(int i = 1; i <= max_iters; ++i)
+    {
+        // Check if the complete Helmholtz function must be used in this iteration
+        const auto complete = abs(fprev) < tolerance_last_iter;
+
+        h = complete ? model(T, D) : modeliter(T, D);
+
+        const auto f  = residual(D, h);
+        const auto df = (2*D*h.helmholtzD + D*D*h.helmholtzDD)/waterCriticalPressure;
+
+        result.iterations = i;
+        result.residual = f;
+
+        if(abs(f) < tolerance)
+        {
+            if(df > 0) D -= f/df;
+            ++result.evaluations;
+            WaterThermoProps wtp;
+            static_cast<WaterThermoPropsBase<Real>&>(wtp) = waterThermoProps<Real>(T, D, model(T, D));
+            return wtp;
+        }
+
+        update(D, f);
+
+        const auto Dnewton = D - f/df;
+
+        if(df > 0 && a < Dnewton && Dnewton < b && abs(f) < 0.5*abs(fprev))
+        {
+            D = Dnewton;
+            fprev = f;
+            continue;
+        }
+
+        if(!verify())
+            break;
+
+        D = (++replaced % 3 == 0) ? bisect() : (a*fb - b*fa)/(fb - fa);
+        fprev = INF;
+        ++result.fallbacks;
+    }
+
+    result.status = WaterSolverStatus::NotConverged;
+
+    ++result.evaluations;
+
+    WaterThermoProps wtp;
+    static_cast<WaterThermoPropsBase<Real>&>(wtp) = waterThermoProps<Real>(T, D, model(T, D));
+    return wtp;
+}
+
+/// Calculate the thermodynamic properties of water with given temperature, pressure and an initial guess for density using safeguarded Newton iterations and any callable Helmholtz functions, recorded in the process-wide counters.
+/// This is the algorithm of @ref waterThermoPropsSafeguardedNewton.
+/// @param model The function that calculates specific Helmholtz free energy of water, callable as `model(T, D)`
+/// @param modeliter The function that calculates specific Helmholtz free energy of water with partial derivatives up to second order
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param D0 The initial guess for the density of water (in units of kg/m3), used if it is inside the interval
+/// @param[out] result The diagnostics of the iterations, or nullptr if not needed
+/// @see WaterDensityMethod
+template<typename Model, typename ModelIter>
+auto waterThermoPropsSafeguarded(const Model& model, const ModelIter& modeliter, const Real& T, const Real& P, const Real& D0, WaterSolverResult* result = nullptr) -> WaterThermoProps
+{
+    WaterSolverResult outcome;
+    const auto wtp = waterThermoPropsSafeguardedNewton(model, modeliter, T, P, D0, outcome);
+    warning(outcome.status == WaterSolverStatus::InvalidInput, "The calculation of water density at temperature ",  T, " K and pressure ", P, " Pa has invalid input.");
+    warning(outcome.status == WaterSolverStatus::NotConverged, "The calculation of water density at temperature ",  T, " K and pressure ", P, " Pa did not converge.");
+    recordWaterSolverResult(outcome, result);
+    return wtp;
+}
+
+/// The Newton step of the phase-equilibrium equations of water at saturation, and their residuals.
+struct WaterSaturationStep
+{
+    /// The step of the density of liquid water (in units of kg/m3)
+    Real dDl;
+
+    /// The step of the density of vapor water (in units of kg/m3)
+    Real dDv;
+
+    /// The difference between the pressures of liquid and vapor water (in units of Pa)
+    Real residualP;
+
+    /// The difference between the specific Gibbs free energies of liquid and vapor water (in units of J/kg)
+    Real residualG;
+};
+
+/// Calculate the Newton step of the phase-equilibrium equations of water at saturation, which equate the pressures and specific Gibbs free energies of liquid and vapor water.
+/// Since the density derivative of the specific Gibbs free energy is that of pressure divided by density, the 2x2 linear
+/// system of the Newton step has a closed-form solution, which only needs the Helmholtz derivatives up to second order.
+/// @param Dl The density of liquid water (in units of kg/m3)
+/// @param Dv The density of vapor water (in units of kg/m3)
+/// @param hl The Helmholtz free energy properties of liquid water
+/// @param hv The Helmholtz free energy properties of vapor water
+inline auto waterSaturationStep(const Real& Dl, const Real& Dv, const WaterHelmholtzProps& hl, const WaterHelmholtzProps& hv) -> WaterSaturationStep
+{
+    const auto Pl  = Dl*Dl*hl.helmholtzD;
+    const auto Pv  = Dv*Dv*hv.helmholtzD;
+    const auto PDl = 2*Dl*hl.helmholtzD + Dl*Dl*hl.helmholtzDD;
+    const auto PDv = 2*Dv*hv.helmholtzD + Dv*Dv*hv.helmholtzDD;
+
+    WaterSaturationStep step;
+    step.residualP = Pl - Pv;
+    step.residualG = (hl.helmholtz + Pl/Dl) - (hv.helmholtz + Pv/Dv);
+
+    const auto dV = 1/Dl - 1/Dv;
+    step.dDl = (step.residualP/Dv - step.residualG)/(PDl*dV);
+    step.dDv = (step.residualP/Dl - step.residualG)/(PDv*dV);
+
+    return step;
+}
+
+/// Calculate the properties of water at saturation with given temperature and the Helmholtz free energy properties of saturated liquid and vapor water.
+/// The derivative of the saturation pressure is given by the Clausius-Clapeyron equation, and those of the saturated
+/// densities by the changes of density with temperature and pressure along the saturation curve.
+/// @param T The temperature of water (in units of K)
+/// @param Dl The density of saturated liquid water (in units of kg/m3)
+/// @param Dv The density of saturated vapor water (in units of kg/m3)
+/// @param hl The Helmholtz free energy properties of saturated liquid water
+/// @param hv The Helmholtz free energy properties of saturated vapor water
+inline auto waterSaturationProps(const Real& T, const Real& Dl, const Real& Dv, const WaterHelmholtzProps& hl, const WaterHelmholtzProps& hv) -> WaterSaturationProps
+{
+    const auto PDl = 2*Dl*hl.helmholtzD + Dl*Dl*hl.helmholtzDD;
+    const auto PDv = 2*Dv*hv.helmholtzD + Dv*Dv*hv.helmholtzDD;
+    const auto PTl = Dl*Dl*hl.helmholtzTD;
+    const auto PTv = Dv*Dv*hv.helmholtzTD;
+
+    WaterSaturationProps res;
+    res.temperature     = T;
+    res.pressure        = Dv*Dv*hv.helmholtzD; // the pressure of vapor water, which is free of the cancellations of that of liquid water
+    res.pressureT       = (hl.helmholtzT - hv.helmholtzT)/(1/Dv - 1/Dl);
+    res.density_liquid  = Dl;
+    res.density_liquidT = (res.pressureT - PTl)/PDl;
+    res.density_vapor   = Dv;
+    res.density_vaporT  = (res.pressureT - PTv)/PDv;
+    return res;
+}
+
+/// Return true if the temperature and initial guesses for the saturated densities of a calculation of water at saturation are valid.
+inline auto waterSaturationValidInput(const Real& T, const Real& Dl0, const Real& Dv0) -> bool
+{
+    using std::isfinite;
+    return isfinite(T) && isfinite(Dl0) && T > 0 && T < waterCriticalTemperature && Dv0 > 0 && Dl0 > Dv0;
+}
+
+/// Apply a Newton step to the densities of saturated liquid and vapor water, halving it until liquid water is denser than vapor water.
+/// @return True if the step was shortened
+inline auto waterSaturationApplyStep(const WaterSaturationStep& step, Real& Dl, Real& Dv) -> bool
+{
+    auto t = 1.0;
+    while(t > 1e-6 && !(Dv + t*step.dDv > 0 && Dl + t*step.dDl > Dv + t*step.dDv))
+        t /= 2;
+    Dl += t*step.dDl;
+    Dv += t*step.dDv;
+    return t < 1.0;
+}
+
+/// Calculate the properties of water at saturation with given temperature and initial guesses for the saturated densities using any callable Helmholtz function, with the diagnostics of the iterations.
+/// This is the algorithm of @ref waterSaturationProps, which neither warns about failures nor updates the process-wide counters, so that other solvers can retry it.
+/// @param model The function that calculates specific Helmholtz free energy of water with partial derivatives up to second order, callable as `model(T, D)`
+/// @param T The temperature of water (in units of K), which must be below the critical temperature
+/// @param Dl0 The initial guess for the density of saturated liquid water (in units of kg/m3)
+/// @param Dv0 The initial guess for the density of saturated vapor water (in units of kg/m3)
+/// @param[out] result The diagnostics of the iterations
+template<typename Model>
+auto waterSaturationPropsNewton(const Model& model, const Real& T, const Real& Dl0, const Real& Dv0, WaterSolverResult& result) -> WaterSaturationProps
+{
+    using std::abs;
+    using std::isfinite;
+    using std::max;
+
+    // Auxiliary constants for the Newton's iterations
+    const auto max_iters = 100;
+    const auto tolerance = 1.0e-10;
+
+    // The relative step below which steps that no longer decrease are attributed to round-off errors, which limit the accuracy close to the critical point
+    const auto tolerance_roundoff = 1.0e-06;
+
+    result = {};
+
+    if(!waterSaturationValidInput(T, Dl0, Dv0))
+    {
+        result.status = WaterSolverStatus::InvalidInput;
+        return {};
+    }
+
+    Real Dl = Dl0;
+    Real Dv = Dv0;
+
+    // The relative step of the previous iteration
+    Real prev = INF;
+
+    for(int i = 1; i <= max_iters; ++i)
+    {
+        const auto step = waterSaturationStep(Dl, Dv, model(T, Dl), model(T, Dv));
+
+        result.iterations = i;
+        result.evaluations += 2;
+        result.residual = step.residualP/waterCriticalPressure;
+        result.fallbacks += waterSaturationApplyStep(step, Dl, Dv);
+
+        if(!isfinite(Dl) || !isfinite(Dv))
+        {
+            result.status = WaterSolverStatus::Diverged;
+            return {};
+        }
+
+        const auto rel = max(abs(step.dDl)/Dl, abs(step.dDv)/Dv);
+
+        if(rel < tolerance || (rel < tolerance_roundoff && rel >= prev))
+        {
+            // Converging to a single phase means that the initial guesses were too close to each other
+            if(Dl - Dv < tolerance_roundoff*Dl)
+                break;
+            result.evaluations += 2;
+            return waterSaturationProps(T, Dl, Dv, model(T, Dl), model(T, Dv));
+        }
+
+        prev = rel;
+    }
+
+    result.status = WaterSolverStatus::NotConverged;
+    result.evaluations += 2;
+    return waterSaturationProps(T, Dl, Dv, model(T, Dl), model(T, Dv));
+}
+
+/// Calculate the properties of water at saturation with given temperature and initial guesses for the saturated densities using any callable Helmholtz function.
+/// The densities of liquid and vapor water are calculated with Newton's method on the phase-equilibrium equations, which
+/// equate the pressures and the specific Gibbs free energies of both phases (see @ref waterSaturationStep). The iterations
+/// stop once the relative steps of both densities are below 1e-10, or, close to the critical point, once they stop decreasing
+/// because of round-off errors. Steps that would make vapor water denser than liquid water are shortened, and convergence to
+/// a single phase (equal densities) is reported as not converged. If the iterations do not converge, the properties at the
+/// last iterate are returned, and if the input is invalid or the iterations diverge, zero properties are returned.
+/// @param model The function that calculates specific Helmholtz free energy of water with partial derivatives up to second order, callable as `model(T, D)`
+/// @param T The temperature of water (in units of K), which must be below the critical temperature
+/// @param Dl0 The initial guess for the density of saturated liquid water (in units of kg/m3)
+/// @param Dv0 The initial guess for the density of saturated vapor water (in units of kg/m3)
+/// @param[out] result The diagnostics of the iterations, or nullptr if not needed
+template<typename Model>
+auto waterSaturationProps(const Model& model, const Real& T, const Real& Dl0, const Real& Dv0, WaterSolverResult* result = nullptr) -> WaterSaturationProps
+{
+    WaterSolverResult outcome;
+    const auto res = waterSaturationPropsNewton(model, T, Dl0, Dv0, outcome);
+    warning(outcome.status == WaterSolverStatus::InvalidInput, "The calculation of water at saturation at temperature ", T, " K has invalid input.");
+    warning(outcome.status == WaterSolverStatus::Diverged, "The calculation of water at saturation at temperature ", T, " K diverged.");
+    warning(outcome.status == WaterSolverStatus::NotConverged, "The calculation of water at saturation at temperature ", T, " K did not converge.");
+    recordWaterSolverResult(outcome, result);
+    return res;
+}
+
+/// Calculate the properties of water at saturation for many temperatures using any callable saturation solver.
+/// The initial guesses for the saturated densities of each temperature are extrapolated from the properties at the last
+/// temperature calculated, if it is within 5 K, with the derivatives along the saturation curve. Temperatures given in
+/// ascending or descending order, as those of tables and curves, then converge in one or two iterations, and also close to
+/// the critical point, where the initial guesses of the auxiliary correlations may lie inside the spinodal region of a
+/// model. If the iterations from the extrapolated densities do not converge, they are repeated from those of *guess*.
+/// @param n The number of temperatures
+/// @param T The array of temperatures of water (in units of K) with length *n*
+/// @param[out] res The array of properties of water at saturation with length *n*
+/// @param[out] status The array of outcomes of the calculations with length *n*, or nullptr if not needed
+/// @param solve The saturation solver, callable as `solve(T, Dl0, Dv0, result)` (see @ref waterSaturationPropsNewton)
+/// @param guess The function that returns the initial guesses for the saturated densities, callable as `guess(T)`
+/// @return The number of temperatures whose calculation did not converge
+template<typename Solve, typename Guess>
+auto waterSaturationPropsBatch(std::size_t n, const Real* T, WaterSaturationProps* res, WaterSolverStatus* status, const Solve& solve, const Guess& guess) -> std::size_t
+{
+    using std::abs;
+
+    // The largest difference of temperature across which the initial guesses are extrapolated (in units of K)
+    const auto continuation_range = 5.0;
+
+    std::size_t failures = 0;
+    std::uint64_t iterations = 0, fallbacks = 0;
+
+    // The last converged properties, and whether there are any
+    WaterSaturationProps last = {};
+    auto continued = false;
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        WaterSolverResult outcome;
+
+        const auto dT = T[i] - last.temperature;
+        const auto Dl0 = last.density_liquid + last.density_liquidT*dT;
+        const auto Dv0 = last.density_vapor + last.density_vaporT*dT;
+
+        if(continued && abs(dT) < continuation_range && waterSaturationValidInput(T[i], Dl0, Dv0))
+        {
+            res[i] = solve(T[i], Dl0, Dv0, outcome);
+            iterations += outcome.iterations;
+            fallbacks += outcome.fallbacks;
+        }
+        else outcome.status = WaterSolverStatus::NotConverged;
+
+        if(outcome.status != WaterSolverStatus::Converged)
+        {
+            const auto [Dl1, Dv1] = guess(T[i]);
+            res[i] = solve(T[i], Dl1, Dv1, outcome);
+            iterations += outcome.iterations;
+            fallbacks += outcome.fallbacks;
+        }
+
+        continued = outcome.status == WaterSolverStatus::Converged;
+
+        if(continued)
+            last = res[i];
+
+        failures += !continued;
+
+        if(status) status[i] = outcome.status;
+    }
+
+    addWaterSolverCounters(n, iterations, failures, fallbacks);
+
+    return failures;
+}
+
+/// Calculate the density of water with given temperature, pressure and an initial guess for density using single-precision arithmetic and any callable Helmholtz function.
+/// This is the algorithm of @ref Fluidika::waterDensitySinglePrecision with the Helmholtz function given as a template argument.
+/// @param model The function that calculates specific Helmholtz free energy of water in single precision, callable as `model(T, D)`
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param D0 The initial guess for the density of water (in units of kg/m3)
+/// @param[out] status The outcome of the iterations (either Converged or NotConverged), or nullptr if not needed
+/// @return The density of water (in units of kg/m3)
+template<typename Model>
+auto waterDensitySinglePrecision(const Model& model, float T, float P, float D0, WaterSolverStatus* status = nullptr) -> float
+{
+    using std::abs;
+
+    // Auxiliary constants for the Newton's iterations
+    const auto max_iters = 100;
+    const auto tolerance = 1.0e-05f;
+
+    float D = D0;
+
+    for(int i = 1; i <= max_iters; ++i)
+    {
+        const auto h = model(T, D);
+
+        const auto f  = D*D*h.helmholtzD - P;
+        const auto df = 2*D*h.helmholtzD + D*D*h.helmholtzDD;
+
+        const auto Dnew = (D > f/df) ? D - f/df : P/(D*h.helmholtzD);
+
+        if(abs(Dnew - D) < tolerance * D)
+        {
+            if(status) *status = WaterSolverStatus::Converged;
+            return Dnew;
+        }
+
+        D = Dnew;
+    }
+
+    warning(true, "The calculation of water density in single precision at temperature ",  T, " K and pressure ", P, "Pa did not converge.");
+
+    if(status) *status = WaterSolverStatus::NotConverged;
+
+    return D;
+}
+
+#if FLUIDIKA_HAS_SIMD
+
+/// Calculate the densities of water for many pairs of temperature and pressure, with initial guesses for density, in single-precision packs of a given SIMD type.
+/// This is the algorithm of @ref waterDensitySinglePrecision with the Newton iterations of all lanes in a pack performed
+/// together, and a lane whose relative density step is below the tolerance retired with a mask. With FloatSimd, the packs
+/// have twice as many lanes as those of RealSimd in @ref waterThermoPropsBatch. The temperature terms of the model are computed once per pack.
+/// @tparam Simd The type of the packs (e.g., FloatSimd)
+/// @param n The number of states to be calculated
+/// @param T The array of temperatures of water (in units of K) with length *n*
+/// @param P The array of pressures of water (in units of Pa) with length *n*
+/// @param D0 The array of initial guesses for the density of water (in units of kg/m3) with length *n*
+/// @param[out] D The array of densities of water (in units of kg/m3) with length *n* (those of the last iterate for the states not converged)
+/// @param[out] status The array of outcomes of the density calculations with length *n*, or nullptr if not needed
+/// @param terms The function that calculates the temperature terms of the model for a pack of temperatures, callable as `terms(T)`
+/// @param modeliter The function that calculates the Helmholtz free energy properties of water with derivatives up to second order, callable as `modeliter(terms(T), D)`
+/// @return The number of states whose density did not converge
+template<typename Simd, typename Terms, typename ModelIter>
+auto waterDensitySinglePrecisionBatch(std::size_t n, const Real* T, const Real* P, const Real* D0, Real* D, WaterSolverStatus* status,
+    const Terms& terms, const ModelIter& modeliter) -> std::size_t
+{
+    using std::abs;
+
+    // Auxiliary constants for the Newton's iterations (the same as those of the single-state algorithm)
+    const auto max_iters = 100;
+    const auto tolerance = 1.0e-05f;
+
+    const auto width = Simd::size();
+
+    std::size_t failures = 0;
+
+    for(std::size_t k = 0; k < n; k += width)
+    {
+        const auto m = n - k < width ? n - k : width;
+
+        const auto Tk = load<Simd>(T + k, m);
+        const auto Pk = load<Simd>(P + k, m);
+        auto Dk = load<Simd>(D0 + k, m);
+
+        const auto tt = terms(Tk);
+
+        typename Simd::mask_type active(true);
+
+        for(int i = 0; i < max_iters && any_of(active); ++i)
+        {
+            const auto h = modeliter(tt, Dk);
+
+            const Simd f  = Dk*Dk*h.helmholtzD - Pk;
+            const Simd df = 2*Dk*h.helmholtzD + Dk*Dk*h.helmholtzDD;
+
+            Simd Dnew = Pk/(Dk*h.helmholtzD);
+            where(Dk > f/df, Dnew) = Dk - f/df;
+
+            const auto converged = abs(Dnew - Dk) < tolerance*Dk;
+
+            where(active, Dk) = Dnew;
+
+            active = active && !converged;
+        }
+
+        for(std::size_t j = 0; j < m; ++j)
+        {
+            D[k + j] = Dk[j];
+            if(status) status[k + j] = active[j] ? WaterSolverStatus::NotConverged : WaterSolverStatus::Converged;
+            failures += active[j];
+        }
+    }
+
+    return failures;
+}
+
+#endif
+
+} // inline namespace FLUIDIKA_ISA_NAMESPACE
+} // namespace generic
+} // namespace Fluidika
@@ -15,12 +15,25 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with this library. If not, see <http://www.gnu.org/licenses/>.
 
+// C++ includes
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 // Catch includes
 #include <catch2/catch.hpp>
 
 // Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Common/CpuIsa.hpp>
+#include <Fluidika/Common/Dual.test.hxx>
+#include <Fluidika/Common/Simd.hpp>
+#include <Fluidika/Water/ThermoModels/BatchKernels.hpp>
 #include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/ThermoModels/UtilsGeneric.hpp>
 #include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPrussGeneric.hpp>
 #include <Fluidika/Water/WaterData.hpp>
 #include <Fluidika/Water/WaterProps.hpp>
 using namespace Fluidika;
@@ -62,6 +75,672 @@ TEST_CASE("Fluidika::WaterThermoModels::WagnerPruss", "[WagnerPruss]")
         }
     }
 
+    SECTION("when compared with the verification values of the IAPWS-95 release")
+    {
+        // The ideal-gas and residual parts of the dimensionless Helmholtz free energy and its partial
+        // derivatives at T = 500 K and D = 838.025 kg/m3 listed in Table 6.6 of the IAPWS-95 release
+        const auto phi    =  2.04797733 - 3.42693206;
+        const auto phi_d  =  0.384236747 - 0.364366650;
+        const auto phi_dd = -0.147637878 + 0.856063701;
+        const auto phi_t  =  9.04611106 - 5.81403435;
+        const auto phi_tt = -1.93249185 - 2.23440737;
+        const auto phi_dt =  0.0 - 1.12176915;
+
+        const auto T = 500.0;
+        const auto D = 838.025;
+        const auto R = 461.51805;
+        const auto Tcr = waterCriticalTemperature;
+        const auto Dcr = waterCriticalDensity;
+
+        const auto h = waterHelmholtzPropsWagnerPruss(T, D);
+
+        // The inverse of the scaling of the partial derivatives of phi from (delta, tau) to (D, T)
+        const auto tT = -Tcr/(T*T);
+        const auto tTT = 2*Tcr/(T*T*T);
+
+        const auto phi_t_calc  = (h.helmholtzT - R*phi)/(R*T*tT);
+        const auto phi_tt_calc = (h.helmholtzTT - 2*R*phi_t_calc*tT - R*T*phi_t_calc*tTT)/(R*T*tT*tT);
+        const auto phi_dt_calc = (h.helmholtzTD - R*phi_d/Dcr)/(R*T*tT/Dcr);
+
+        REQUIRE(h.helmholtz/(R*T) == Approx(phi).epsilon(1e-8));
+        REQUIRE(h.helmholtzD*Dcr/(R*T) == Approx(phi_d).epsilon(1e-7));
+        REQUIRE(h.helmholtzDD*Dcr*Dcr/(R*T) == Approx(phi_dd).epsilon(1e-8));
+        REQUIRE(phi_t_calc == Approx(phi_t).epsilon(1e-8));
+        REQUIRE(phi_tt_calc == Approx(phi_tt).epsilon(1e-8));
+        REQUIRE(phi_dt_calc == Approx(phi_dt).epsilon(1e-8));
+    }
+
+    SECTION("when arrays of temperature and density are given")
+    {
+        const auto& data = waterThermoDataSinglePhaseStateWagnerPruss();
+        const auto n = data.size() - 1; // use an odd number of states so that the last pack is partially filled
+
+        std::vector<Real> T(n), D(n);
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            T[i] = data[i].temperature;
+            D[i] = data[i].density;
+        }
+
+        std::vector<WaterHelmholtzProps> res(n);
+        waterHelmholtzPropsWagnerPrussBatch(n, T.data(), D.data(), res.data());
+
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            const auto expected = waterHelmholtzPropsWagnerPruss(T[i], D[i]);
+
+            REQUIRE(res[i].helmholtz    == Approx(expected.helmholtz).epsilon(1e-12));
+            REQUIRE(res[i].helmholtzT   == Approx(expected.helmholtzT).epsilon(1e-12));
+            REQUIRE(res[i].helmholtzD   == Approx(expected.helmholtzD).epsilon(1e-12));
+            REQUIRE(res[i].helmholtzTT  == Approx(expected.helmholtzTT).epsilon(1e-12));
+            REQUIRE(res[i].helmholtzTD  == Approx(expected.helmholtzTD).epsilon(1e-12));
+            REQUIRE(res[i].helmholtzDD  == Approx(expected.helmholtzDD).epsilon(1e-12));
+            REQUIRE(res[i].helmholtzTTT == Approx(expected.helmholtzTTT).epsilon(1e-12));
+            REQUIRE(res[i].helmholtzTTD == Approx(expected.helmholtzTTD).epsilon(1e-12));
+            REQUIRE(res[i].helmholtzTDD == Approx(expected.helmholtzTDD).epsilon(1e-12));
+            REQUIRE(res[i].helmholtzDDD == Approx(expected.helmholtzDDD).epsilon(1e-12));
+        }
+    }
+
+    SECTION("when the batch kernels compiled for the available instruction sets are used")
+    {
+        const auto& data = waterThermoDataSinglePhaseStateWagnerPruss();
+        const auto n = data.size() - 1; // use an odd number of states so that the last pack is partially filled
+
+        std::vector<Real> T(n), D(n), P(n);
+        std::vector<float> Tf(n), Df(n);
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            T[i] = Tf[i] = data[i].temperature;
+            D[i] = Df[i] = data[i].density;
+            P[i] = data[i].pressure;
+        }
+
+        const auto baseline = waterBatchKernelsBaseline();
+
+        REQUIRE(baseline != nullptr);
+        REQUIRE(waterBatchKernels(CpuIsa::Baseline) == baseline);
+
+        // The kernels used are those of the best available instruction set for which kernels were compiled (none without SIMD support)
+        const WaterBatchKernels* best = nullptr;
+        for(auto isa = cpuIsa(); !best; isa = static_cast<CpuIsa>(static_cast<int>(isa) - 1))
+            best = waterBatchKernels(isa);
+        REQUIRE(best == &waterBatchKernels());
+
+        std::vector<WaterHelmholtzProps> expected(n);
+        std::vector<WaterHelmholtzPropsFloat> expectedf(n);
+        std::vector<WaterThermoProps> expectedwtp(n);
+        baseline->wagnerPruss(n, T.data(), D.data(), expected.data());
+        baseline->wagnerPrussFloat(n, Tf.data(), Df.data(), expectedf.data());
+        baseline->wagnerPrussThermo(n, T.data(), P.data(), D.data(), expectedwtp.data(), nullptr);
+
+        // All variants must produce the same results as the baseline, bit for bit
+        for(auto isa : { CpuIsa::SSE42, CpuIsa::AVX2, CpuIsa::AVX512 })
+        {
+            const auto kernels = waterBatchKernels(isa);
+
+            if(kernels == nullptr)
+                continue;
+
+            INFO("isa: " << cpuIsaName(isa));
+
+            std::vector<WaterHelmholtzProps> res(n);
+            std::vector<WaterHelmholtzPropsFloat> resf(n);
+            std::vector<WaterThermoProps> reswtp(n);
+            kernels->wagnerPruss(n, T.data(), D.data(), res.data());
+            kernels->wagnerPrussFloat(n, Tf.data(), Df.data(), resf.data());
+            kernels->wagnerPrussThermo(n, T.data(), P.data(), D.data(), reswtp.data(), nullptr);
+
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                REQUIRE(res[i].helmholtz    == expected[i].helmholtz);
+                REQUIRE(res[i].helmholtzT   == expected[i].helmholtzT);
+                REQUIRE(res[i].helmholtzD   == expected[i].helmholtzD);
+                REQUIRE(res[i].helmholtzTT  == expected[i].helmholtzTT);
+                REQUIRE(res[i].helmholtzTD  == expected[i].helmholtzTD);
+                REQUIRE(res[i].helmholtzDD  == expected[i].helmholtzDD);
+                REQUIRE(res[i].helmholtzTTT == expected[i].helmholtzTTT);
+                REQUIRE(res[i].helmholtzTTD == expected[i].helmholtzTTD);
+                REQUIRE(res[i].helmholtzTDD == expected[i].helmholtzTDD);
+                REQUIRE(res[i].helmholtzDDD == expected[i].helmholtzDDD);
+
+                REQUIRE(resf[i].helmholtz    == expectedf[i].helmholtz);
+                REQUIRE(resf[i].helmholtzD   == expectedf[i].helmholtzD);
+                REQUIRE(resf[i].helmholtzTT  == expectedf[i].helmholtzTT);
+                REQUIRE(resf[i].helmholtzDDD == expectedf[i].helmholtzDDD);
+
+                REQUIRE(reswtp[i].density  == expectedwtp[i].density);
+                REQUIRE(reswtp[i].enthalpy == expectedwtp[i].enthalpy);
+                REQUIRE(reswtp[i].cp       == expectedwtp[i].cp);
+            }
+        }
+    }
+
+    SECTION("when only partial derivatives up to a given order are needed")
+    {
+        for(auto item : waterThermoDataSinglePhaseStateWagnerPruss())
+        {
+            const auto T = item.temperature;
+            const auto D = item.density;
+            const auto h  = waterHelmholtzPropsWagnerPruss(T, D);
+            const auto h0 = waterHelmholtzPropsWagnerPrussUpToOrder<0>(T, D);
+            const auto h1 = waterHelmholtzPropsWagnerPrussUpToOrder<1>(T, D);
+            const auto h2 = waterHelmholtzPropsWagnerPrussUpToOrder<2>(T, D);
+            const auto h3 = waterHelmholtzPropsWagnerPrussUpToOrder<3>(T, D);
+
+            REQUIRE(h0.helmholtz == Approx(h.helmholtz));
+            REQUIRE(h0.helmholtzT == 0.0);
+            REQUIRE(h0.helmholtzD == 0.0);
+
+            REQUIRE(h1.helmholtzT == Approx(h.helmholtzT));
+            REQUIRE(h1.helmholtzD == Approx(h.helmholtzD));
+            REQUIRE(h1.helmholtzTT == 0.0);
+            REQUIRE(h1.helmholtzTD == 0.0);
+            REQUIRE(h1.helmholtzDD == 0.0);
+
+            REQUIRE(h2.helmholtzTT == Approx(h.helmholtzTT));
+            REQUIRE(h2.helmholtzTD == Approx(h.helmholtzTD));
+            REQUIRE(h2.helmholtzDD == Approx(h.helmholtzDD));
+            REQUIRE(h2.helmholtzTTT == 0.0);
+            REQUIRE(h2.helmholtzTTD == 0.0);
+            REQUIRE(h2.helmholtzTDD == 0.0);
+            REQUIRE(h2.helmholtzDDD == 0.0);
+
+            REQUIRE(h3.helmholtzTTT == Approx(h.helmholtzTTT));
+            REQUIRE(h3.helmholtzTTD == Approx(h.helmholtzTTD));
+            REQUIRE(h3.helmholtzTDD == Approx(h.helmholtzTDD));
+            REQUIRE(h3.helmholtzDDD == Approx(h.helmholtzDDD));
+        }
+    }
+
+    SECTION("when many densities are evaluated at the same temperature")
+    {
+        for(auto item : waterThermoDataSinglePhaseStateWagnerPruss())
+        {
+            const auto T = item.temperature;
+            const WagnerPrussIsotherm isotherm(T);
+
+            REQUIRE(isotherm.temperature() == T);
+
+            for(auto factor : { 0.5, 1.0, 1.2 })
+            {
+                const auto D = item.density * factor;
+                const auto expected = waterHelmholtzPropsWagnerPruss(T, D);
+                const auto h = isotherm.evaluate(D);
+                const auto h2 = isotherm.evaluate<2>(D);
+
+                REQUIRE(h.helmholtz    == Approx(expected.helmholtz).epsilon(1e-12));
+                REQUIRE(h.helmholtzT   == Approx(expected.helmholtzT).epsilon(1e-12));
+                REQUIRE(h.helmholtzD   == Approx(expected.helmholtzD).epsilon(1e-12));
+                REQUIRE(h.helmholtzTT  == Approx(expected.helmholtzTT).epsilon(1e-12));
+                REQUIRE(h.helmholtzTD  == Approx(expected.helmholtzTD).epsilon(1e-12));
+                REQUIRE(h.helmholtzDD  == Approx(expected.helmholtzDD).epsilon(1e-12));
+                REQUIRE(h.helmholtzTTT == Approx(expected.helmholtzTTT).epsilon(1e-12));
+                REQUIRE(h.helmholtzTTD == Approx(expected.helmholtzTTD).epsilon(1e-12));
+                REQUIRE(h.helmholtzTDD == Approx(expected.helmholtzTDD).epsilon(1e-12));
+                REQUIRE(h.helmholtzDDD == Approx(expected.helmholtzDDD).epsilon(1e-12));
+
+                REQUIRE(h2.helmholtzDD  == Approx(expected.helmholtzDD).epsilon(1e-12));
+                REQUIRE(h2.helmholtzDDD == 0.0);
+            }
+        }
+    }
+
+    SECTION("when single-precision arithmetic is used")
+    {
+        const auto& data = waterThermoDataSinglePhaseStateWagnerPruss();
+        const auto n = data.size() - 1;
+
+        std::vector<float> T(n), D(n);
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            T[i] = data[i].temperature;
+            D[i] = data[i].density;
+        }
+
+        std::vector<WaterHelmholtzPropsFloat> res(n);
+        waterHelmholtzPropsWagnerPrussBatch(n, T.data(), D.data(), res.data());
+
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            const auto expected = waterHelmholtzPropsWagnerPrussFloat(T[i], D[i]);
+            const auto exact = waterHelmholtzPropsWagnerPruss(T[i], D[i]);
+
+            REQUIRE(res[i].helmholtz   == Approx(expected.helmholtz).epsilon(1e-5));
+            REQUIRE(res[i].helmholtzT  == Approx(expected.helmholtzT).epsilon(1e-5));
+            REQUIRE(res[i].helmholtzTT == Approx(expected.helmholtzTT).epsilon(1e-5));
+            REQUIRE(res[i].helmholtz   == Approx(exact.helmholtz).scale(1e3*kJ).epsilon(1e-5)); // compare in the scale of the specific energy changes of water (MJ/kg)
+        }
+
+        for(auto item : data)
+        {
+            const auto T = item.temperature;
+            const auto P = item.pressure;
+            const auto D = item.density * 1.2;
+            const auto expected = waterThermoPropsWagnerPruss(T, P, D);
+            const auto mixed = waterThermoPropsWagnerPruss(T, P, D, WaterPrecision::Mixed);
+            const auto single = waterThermoPropsWagnerPruss(T, P, D, WaterPrecision::Single);
+
+            // The double-precision refinement meets the tolerance of the pressure residual of the double-precision solver
+            REQUIRE(std::abs(mixed.pressure - P)/waterCriticalPressure < 1e-8);
+            REQUIRE(mixed.density == Approx(expected.density).epsilon(1e-12));
+            REQUIRE(mixed.enthalpy == Approx(expected.enthalpy).scale(kJ).epsilon(1e-6));
+            REQUIRE(mixed.cp == Approx(expected.cp).epsilon(1e-6));
+
+            REQUIRE(single.density == Approx(expected.density).epsilon(1e-4));
+            REQUIRE(single.entropy == approx(item.entropy).scale(kJ));
+            REQUIRE(single.cp == approx(item.cp).scale(kJ));
+            REQUIRE(single.speed_of_sound == approx(item.speed_of_sound));
+        }
+
+        // The densities of the batch calculation, in single-precision packs, agree with those of the single-state one within their tolerance
+        std::vector<Real> Ts, Ps, D0s;
+        for(auto item : data)
+            Ts.push_back(item.temperature), Ps.push_back(item.pressure), D0s.push_back(item.density * 1.2);
+
+        std::vector<WaterThermoProps> wtps(data.size());
+        std::vector<WaterSolverStatus> status(data.size());
+        waterThermoPropsWagnerPrussBatch(data.size(), Ts.data(), Ps.data(), D0s.data(), wtps.data(), status.data(), WaterPrecision::Single);
+
+        std::vector<WaterThermoProps> mixed(data.size());
+        std::vector<WaterSolverStatus> mixedstatus(data.size());
+        waterThermoPropsWagnerPrussBatch(data.size(), Ts.data(), Ps.data(), D0s.data(), mixed.data(), mixedstatus.data(), WaterPrecision::Mixed);
+
+        for(std::size_t i = 0; i < data.size(); ++i)
+        {
+            const auto single = waterThermoPropsWagnerPruss(Ts[i], Ps[i], D0s[i], WaterPrecision::Single);
+
+            REQUIRE(status[i] == WaterSolverStatus::Converged);
+            REQUIRE(wtps[i].density == Approx(single.density).epsilon(2e-5));
+            REQUIRE(wtps[i].cp == approx(data[i].cp).scale(kJ));
+
+            // The batch refinement in double precision meets the tolerance of the double-precision solver
+            REQUIRE(mixedstatus[i] == WaterSolverStatus::Converged);
+            REQUIRE(std::abs(mixed[i].pressure - Ps[i])/waterCriticalPressure < 1e-8);
+            REQUIRE(mixed[i].density == Approx(waterThermoPropsWagnerPruss(Ts[i], Ps[i], D0s[i]).density).epsilon(1e-12));
+        }
+    }
+
+    SECTION("when generic scalar types are used")
+    {
+        for(auto item : waterThermoDataSinglePhaseStateWagnerPruss())
+        {
+            const auto T = item.temperature;
+            const auto D = item.density;
+            const auto h = waterHelmholtzPropsWagnerPruss(T, D);
+            const auto wtp = waterThermoProps(T, D, h);
+
+            // The derivatives computed with dual numbers must match the analytical ones (compared in the natural scale of each quantity)
+            const auto hT = generic::waterHelmholtzPropsWagnerPruss(Dual(T, 1.0), Dual(D));
+            const auto hD = generic::waterHelmholtzPropsWagnerPruss(Dual(T), Dual(D, 1.0));
+            const auto R = 461.51805;
+
+            REQUIRE(hT.helmholtz.val    == Approx(h.helmholtz).epsilon(1e-12).scale(R*T));
+            REQUIRE(hT.helmholtz.grad   == Approx(h.helmholtzT).epsilon(1e-10).scale(R));
+            REQUIRE(hT.helmholtzD.grad  == Approx(h.helmholtzTD).epsilon(1e-10).scale(R/D));
+            REQUIRE(hT.helmholtzTT.grad == Approx(h.helmholtzTTT).epsilon(1e-10).scale(R/(T*T)));
+            REQUIRE(hD.helmholtz.grad   == Approx(h.helmholtzD).epsilon(1e-10).scale(R*T/D));
+            REQUIRE(hD.helmholtzD.grad  == Approx(h.helmholtzDD).epsilon(1e-10).scale(R*T/(D*D)));
+
+            const auto wD = generic::waterThermoProps(Dual(T), Dual(D, 1.0), hD);
+
+            REQUIRE(wD.pressure.val  == Approx(wtp.pressure).epsilon(1e-12).scale(R*T*D));
+            REQUIRE(wD.pressure.grad == Approx(wtp.pressureD).epsilon(1e-10).scale(R*T));
+
+            if(T < waterCriticalTemperature)
+            {
+                const auto Psat = generic::waterPressureSaturatedStateWagnerPruss(Dual(T, 1.0));
+                const auto dT = 1e-6 * T;
+                const auto dPsatdT = (waterPressureSaturatedStateWagnerPruss(T + dT) - waterPressureSaturatedStateWagnerPruss(T - dT))/(2*dT);
+
+                REQUIRE(Psat.val == Approx(waterPressureSaturatedStateWagnerPruss(T)).epsilon(1e-12));
+                REQUIRE(Psat.grad == Approx(dPsatdT).epsilon(1e-6));
+            }
+
+#if FLUIDIKA_HAS_SIMD
+            // Every lane of a SIMD pack must match the scalar evaluation
+            const auto hs = generic::waterHelmholtzPropsWagnerPruss(RealSimd(T), RealSimd(D));
+
+            for(std::size_t i = 0; i < RealSimd::size(); ++i)
+            {
+                REQUIRE(hs.helmholtz[i]    == Approx(h.helmholtz).epsilon(1e-12));
+                REQUIRE(hs.helmholtzDD[i]  == Approx(h.helmholtzDD).epsilon(1e-12));
+                REQUIRE(hs.helmholtzTTT[i] == Approx(h.helmholtzTTT).epsilon(1e-12));
+            }
+#endif
+        }
+    }
+
+    SECTION("when temperature and pressure are given, and Halley's method is used")
+    {
+        for(auto item : waterThermoDataSinglePhaseStateWagnerPruss())
+        {
+            const auto T = item.temperature;
+            const auto P = item.pressure;
+            const auto D = item.density * 1.2; // multiply density by 1.2 to ensure we don't start with an initial guess that is the exact solution
+            const auto wtp = waterThermoPropsWagnerPruss(T, P, D, WaterDensityMethod::Halley);
+
+            REQUIRE(wtp.density == Approx(waterThermoPropsWagnerPruss(T, P, D).density).epsilon(1e-12));
+            REQUIRE(wtp.pressure == approx(item.pressure).scale(MPa));
+            REQUIRE(wtp.density == approx(item.density));
+            REQUIRE(wtp.enthalpy == approx(item.enthalpy).scale(kJ));
+            REQUIRE(wtp.entropy == approx(item.entropy).scale(kJ));
+            REQUIRE(wtp.cp == approx(item.cp).scale(kJ));
+        }
+    }
+
+    SECTION("when the saturation correlations are used")
+    {
+        const auto& liquid = waterThermoDataSaturatedLiquidStateWagnerPruss();
+        const auto& vapor = waterThermoDataSaturatedVaporStateWagnerPruss();
+
+        for(std::size_t i = 0; i < liquid.size(); ++i)
+        {
+            const auto T = liquid[i].temperature;
+
+            if(T >= waterCriticalTemperature)
+                continue;
+
+            // The correlations deviate from Table 13.1 by up to 0.1% in density close to the critical point
+            REQUIRE(waterPressureSaturatedStateWagnerPruss(T) == Approx(liquid[i].pressure * MPa).epsilon(1e-3)); // the saturated states keep the pressures of Table 13.1 in MPa
+            REQUIRE(waterDensitySaturatedLiquidStateWagnerPruss(T) == Approx(liquid[i].density).epsilon(2e-3));
+            REQUIRE(waterDensitySaturatedVaporStateWagnerPruss(T) == Approx(vapor[i].density).epsilon(2e-3));
+        }
+    }
+
+    SECTION("when the saturation state is calculated")
+    {
+        const auto& liquid = waterThermoDataSaturatedLiquidStateWagnerPruss();
+        const auto& vapor = waterThermoDataSaturatedVaporStateWagnerPruss();
+
+        std::vector<Real> T;
+        for(std::size_t i = 0; i < liquid.size(); ++i)
+        {
+            if(liquid[i].temperature >= waterCriticalTemperature)
+                continue;
+
+            T.push_back(liquid[i].temperature);
+
+            WaterSolverResult result;
+            const auto sat = waterSaturationPropsWagnerPruss(T.back(), result);
+
+            REQUIRE(result.status == WaterSolverStatus::Converged);
+
+            // The saturation states agree with Table 13.1 to within its five significant digits
+            REQUIRE(sat.pressure == Approx(liquid[i].pressure * MPa).epsilon(5e-5).margin(0.5e-6 * MPa)); // the pressures in MPa have at most six decimal places
+            REQUIRE(sat.density_liquid == Approx(liquid[i].density).epsilon(5e-5));
+            REQUIRE(sat.density_vapor == Approx(vapor[i].density).epsilon(5e-5).margin(0.5e-5)); // the densities have at most five decimal places
+
+            // Both phases have the same pressure and Gibbs free energy
+            const auto wl = waterThermoProps(T.back(), sat.density_liquid, waterHelmholtzPropsWagnerPruss(T.back(), sat.density_liquid));
+            const auto wv = waterThermoProps(T.back(), sat.density_vapor, waterHelmholtzPropsWagnerPruss(T.back(), sat.density_vapor));
+
+            REQUIRE(wl.pressure == Approx(sat.pressure).epsilon(1e-8).margin(1e-2)); // the pressure of the liquid changes by about 2 MPa per kg/m3
+            REQUIRE(wv.pressure == Approx(sat.pressure).epsilon(1e-12));
+            REQUIRE(wl.gibbs == Approx(wv.gibbs).scale(kJ).epsilon(1e-9));
+
+            // The derivatives along the saturation curve agree with finite differences
+            const auto dT = 1e-4;
+            const auto sat1 = waterSaturationPropsWagnerPruss(T.back() - dT);
+            const auto sat2 = waterSaturationPropsWagnerPruss(T.back() + dT);
+
+            if(T.back() < waterCriticalTemperature - 1.0)
+            {
+                REQUIRE(sat.pressureT == Approx((sat2.pressure - sat1.pressure)/(2*dT)).epsilon(1e-6));
+                REQUIRE(sat.density_liquidT == Approx((sat2.density_liquid - sat1.density_liquid)/(2*dT)).epsilon(1e-4));
+                REQUIRE(sat.density_vaporT == Approx((sat2.density_vapor - sat1.density_vapor)/(2*dT)).epsilon(1e-4));
+            }
+        }
+
+        // The batch calculation agrees with the single-temperature one, and reports invalid temperatures
+        T.push_back(waterCriticalTemperature);
+        T.push_back(std::nan(""));
+
+        const auto n = T.size();
+
+        std::vector<WaterSaturationProps> res(n);
+        std::vector<WaterSolverStatus> status(n);
+        waterSaturationPropsWagnerPrussBatch(n, T.data(), res.data(), status.data());
+
+        for(std::size_t i = 0; i < n - 2; ++i)
+        {
+            const auto expected = waterSaturationPropsWagnerPruss(T[i]);
+
+            REQUIRE(status[i] == WaterSolverStatus::Converged);
+            REQUIRE(res[i].temperature == T[i]);
+            REQUIRE(res[i].pressure == Approx(expected.pressure).epsilon(1e-10));
+            REQUIRE(res[i].density_liquid == Approx(expected.density_liquid).epsilon(1e-10));
+            REQUIRE(res[i].density_vapor == Approx(expected.density_vapor).epsilon(1e-10));
+        }
+
+        REQUIRE(status[n - 2] == WaterSolverStatus::InvalidInput);
+        REQUIRE(status[n - 1] == WaterSolverStatus::InvalidInput);
+        REQUIRE(res[n - 2].pressure == 0.0);
+    }
+
+    SECTION("when temperature, pressure and state of matter are given")
+    {
+        for(auto item : waterThermoDataSinglePhaseStateWagnerPruss())
+        {
+            const auto T = item.temperature;
+            const auto P = item.pressure;
+
+            // Skip the states on the saturation curve, whose phase cannot be determined from temperature and pressure
+            if(T < waterCriticalTemperature && std::abs(P/waterPressureSaturatedStateWagnerPruss(T) - 1.0) < 1e-4)
+                continue;
+
+            const auto stateofmatter = item.density > waterCriticalDensity ? StateOfMatter::Liquid : StateOfMatter::Gas;
+
+            // The guesses from the saturation correlations deviate from Table 13.2 by up to 30% close to the critical point
+            REQUIRE(waterDensitySaturationGuess(T, P) == Approx(item.density).epsilon(0.3));
+            REQUIRE(waterDensitySaturationGuess(T, P, stateofmatter) == Approx(item.density).epsilon(0.3));
+
+            const auto wtp = waterThermoPropsWagnerPruss(T, P, stateofmatter);
+
+            REQUIRE(wtp.pressure == approx(item.pressure).scale(MPa));
+            REQUIRE(wtp.density == approx(item.density));
+        }
+
+        // The metastable states on the other side of the saturation curve are found when the state of matter is given
+        // (these no longer exist 5% away from the saturation pressure close to the critical point, beyond the spinodal curve)
+        for(auto T : { 300.0, 400.0, 500.0, 600.0 })
+        {
+            const auto Psat = waterPressureSaturatedStateWagnerPruss(T);
+
+            const auto vapor = waterThermoPropsWagnerPruss(T, 1.05 * Psat, StateOfMatter::Gas);
+            const auto liquid = waterThermoPropsWagnerPruss(T, 0.95 * Psat, StateOfMatter::Liquid);
+
+            REQUIRE(vapor.pressure == Approx(1.05 * Psat).epsilon(1e-8));
+            REQUIRE(vapor.density < waterCriticalDensity);
+            REQUIRE(liquid.pressure == Approx(0.95 * Psat).epsilon(1e-8));
+            REQUIRE(liquid.density > waterCriticalDensity);
+        }
+
+        // The liquid states far above the saturation pressure, where no metastable vapor exists, are found even if gas is given
+        for(auto [T, P] : { std::pair{ 366.0, 7.48e+06 }, std::pair{ 575.3, 5.68e+07 } })
+        {
+            const auto wtp = waterThermoPropsWagnerPruss(T, P, StateOfMatter::Gas);
+
+            REQUIRE(wtp.pressure == Approx(P).epsilon(1e-8));
+            REQUIRE(wtp.density == Approx(waterThermoPropsWagnerPruss(T, P).density).epsilon(1e-12));
+            REQUIRE(wtp.density > waterCriticalDensity);
+        }
+    }
+
+    SECTION("when temperature and pressure are given, and the safeguarded method is used")
+    {
+        for(auto item : waterThermoDataSinglePhaseStateWagnerPruss())
+        {
+            const auto T = item.temperature;
+            const auto P = item.pressure;
+
+            // Skip the states on the saturation curve, whose phase cannot be determined from temperature and pressure
+            if(T < waterCriticalTemperature && std::abs(P/waterPressureSaturatedStateWagnerPruss(T) - 1.0) < 1e-4)
+                continue;
+
+            const auto D = item.density > waterCriticalDensity ? 1.0 : 1000.0; // start with an initial guess in the wrong phase
+            const auto wtp = waterThermoPropsWagnerPruss(T, P, D, WaterDensityMethod::Safeguarded);
+
+            REQUIRE(wtp.pressure == approx(item.pressure).scale(MPa));
+            REQUIRE(wtp.density == approx(item.density));
+            REQUIRE(wtp.enthalpy == approx(item.enthalpy).scale(kJ));
+            REQUIRE(wtp.entropy == approx(item.entropy).scale(kJ));
+            REQUIRE(wtp.cp == approx(item.cp).scale(kJ));
+        }
+
+        // The density must remain in the phase given by the pressure close to saturation, whatever the initial guess
+        for(auto T : { 300.0, 400.0, 500.0, 600.0, 640.0 })
+        {
+            const auto Psat = waterPressureSaturatedStateWagnerPruss(T);
+
+            for(auto factor : { 0.99, 0.999, 1.001, 1.01 })
+            {
+                const auto P = factor * Psat;
+
+                for(auto D : { 1.0, 1000.0 })
+                {
+                    const auto wtp = waterThermoPropsWagnerPruss(T, P, D, WaterDensityMethod::Safeguarded);
+
+                    REQUIRE(wtp.pressure == Approx(P).epsilon(1e-8));
+                    REQUIRE((wtp.density > waterCriticalDensity) == (P > Psat));
+                }
+            }
+        }
+
+        // The interval is extended until it brackets the density of the model, even if this is far outside it, as for an ideal
+        // gas above the saturation pressure of water, whose density is about a thousandth of that of the initial interval
+        const auto R = universalGasConstant/waterMolarMass;
+        const auto T = 300.0;
+        const auto P = 1e+05;
+
+        const auto idealgas = [&](const Real& T, const Real& D)
+        {
+            WaterHelmholtzProps h;
+            h.helmholtz    = R*T*std::log(D);
+            h.helmholtzD   = R*T/D;
+            h.helmholtzDD  = -R*T/(D*D);
+            h.helmholtzDDD = 2*R*T/(D*D*D);
+            return h;
+        };
+
+        WaterSolverResult result;
+        const auto wtp = generic::waterThermoPropsSafeguarded(idealgas, idealgas, T, P, 1000.0, &result);
+
+        REQUIRE(result.status == WaterSolverStatus::Converged);
+        REQUIRE(result.evaluations < 50);
+        REQUIRE(wtp.density == Approx(P/(R*T)).epsilon(1e-8));
+    }
+
+    SECTION("when the diagnostics of the density iterations are requested")
+    {
+        resetWaterSolverCounters();
+        enableWaterSolverCounters(true);
+
+        std::uint64_t iterations = 0;
+        std::uint64_t fallbacks = 0;
+
+        for(auto item : waterThermoDataSinglePhaseStateWagnerPruss())
+        {
+            const auto T = item.temperature;
+            const auto P = item.pressure;
+            const auto D = item.density * 1.2; // multiply density by 1.2 to ensure we don't start with an initial guess that is the exact solution
+
+            for(auto method : { WaterDensityMethod::Newton, WaterDensityMethod::Halley, WaterDensityMethod::Safeguarded })
+            {
+                WaterSolverResult result;
+                const auto wtp = waterThermoPropsWagnerPruss(T, P, D, method, result);
+
+                REQUIRE(wtp.density == waterThermoPropsWagnerPruss(T, P, D, method).density);
+                REQUIRE(result.status == WaterSolverStatus::Converged);
+                REQUIRE(result.iterations > 0);
+                REQUIRE(result.evaluations >= result.iterations);
+                REQUIRE(result.fallbacks <= result.iterations);
+                REQUIRE(std::abs(result.residual) < 1e-8);
+
+                iterations += result.iterations;
+                fallbacks += result.fallbacks;
+            }
+        }
+
+        // The calls above without diagnostics are also counted
+        const auto n = waterThermoDataSinglePhaseStateWagnerPruss().size();
+        const auto counters = waterSolverCounters();
+
+        REQUIRE(counters.calls == 6*n);
+        REQUIRE(counters.iterations == 2*iterations);
+        REQUIRE(counters.fallbacks == 2*fallbacks);
+        REQUIRE(counters.failures == 0);
+
+        // An invalid initial guess is reported as such, and counted as a failure
+        WaterSolverResult result;
+        const auto wtp = waterThermoPropsWagnerPruss(300.0, 1e5, std::nan(""), WaterDensityMethod::Newton, result);
+
+        REQUIRE(result.status == WaterSolverStatus::InvalidInput);
+        REQUIRE(result.iterations == 0);
+        REQUIRE(wtp.density == 0.0);
+        REQUIRE(waterSolverCounters().failures == 1);
+
+        // The batch solvers are counted per state
+        const std::vector<Real> T = { 300.0, 400.0, 500.0 };
+        const std::vector<Real> P = { 1e5, 1e6, 1e7 };
+        std::vector<WaterThermoProps> res(T.size());
+
+        resetWaterSolverCounters();
+        waterThermoPropsWagnerPrussBatch(T.size(), T.data(), P.data(), res.data(), nullptr);
+
+        REQUIRE(waterSolverCounters().calls == T.size());
+        REQUIRE(waterSolverCounters().iterations >= T.size());
+
+        // The counters are not updated while disabled
+        enableWaterSolverCounters(false);
+        resetWaterSolverCounters();
+        waterThermoPropsWagnerPruss(300.0, 1e5);
+
+        REQUIRE(waterSolverCounters().calls == 0);
+    }
+
+    SECTION("when arrays of temperature and pressure are given")
+    {
+        const auto& data = waterThermoDataSinglePhaseStateWagnerPruss();
+        const auto n = data.size(); // the last state below has an invalid initial guess, for which the iterations cannot converge
+
+        std::vector<Real> T(n), P(n), D0(n);
+        for(std::size_t i = 0; i < n - 1; ++i)
+        {
+            T[i] = data[i].temperature;
+            P[i] = data[i].pressure;
+            D0[i] = data[i].density * 1.2; // multiply density by 1.2 to ensure we don't start with an initial guess that is the exact solution
+        }
+        T[n - 1] = 500.0, P[n - 1] = 1.0e+05, D0[n - 1] = std::nan("");
+
+        std::vector<WaterThermoProps> res(n);
+        std::vector<WaterSolverStatus> status(n);
+        waterThermoPropsWagnerPrussBatch(n, T.data(), P.data(), D0.data(), res.data(), status.data());
+
+        for(std::size_t i = 0; i < n - 1; ++i)
+        {
+            // The single-state algorithm evaluates the properties at the last iterate, so the results agree to within its tolerance
+            const auto expected = waterThermoPropsWagnerPruss(T[i], P[i], D0[i]);
+
+            REQUIRE(status[i] == WaterSolverStatus::Converged);
+            REQUIRE(res[i].temperature == expected.temperature);
+            REQUIRE(res[i].density == Approx(expected.density).epsilon(1e-10));
+            REQUIRE(res[i].pressure == Approx(P[i]).margin(1e-8 * waterCriticalPressure)); // the tolerance of the iterations
+            REQUIRE(res[i].enthalpy == Approx(expected.enthalpy).scale(kJ).epsilon(1e-6));
+            REQUIRE(res[i].entropy == Approx(expected.entropy).scale(kJ).epsilon(1e-6));
+            REQUIRE(res[i].cp == Approx(expected.cp).scale(kJ).epsilon(1e-6));
+            REQUIRE(res[i].speed_of_sound == Approx(expected.speed_of_sound).epsilon(1e-6));
+        }
+
+        REQUIRE(status[n - 1] == WaterSolverStatus::NotConverged);
+
+        // The initial guesses are optional
+        waterThermoPropsWagnerPrussBatch(n - 1, T.data(), P.data(), res.data(), nullptr);
+
+        for(std::size_t i = 0; i < n - 1; ++i)
+            REQUIRE(res[i].density == Approx(waterThermoPropsWagnerPruss(T[i], P[i]).density).epsilon(1e-10));
+    }
+
     SECTION("when temperature and pressure are given, and density is given as initial guess")
     {
         for(auto item : waterThermoDataSinglePhaseStateWagnerPruss())
@@ -0,0 +1,886 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// C++ includes
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+// Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Common/Real.hpp>
+#include <Fluidika/Common/Simd.hpp>
+#include <Fluidika/Water/ThermoModels/UtilsGeneric.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+
+namespace Fluidika {
+namespace generic {
+inline namespace FLUIDIKA_ISA_NAMESPACE {
+namespace wagnerpruss {
+
+using std::exp;
+using std::log;
+using std::pow;
+using std::sqrt;
+
+constexpr double no[] =
+{
+	0, -8.32044648201, 6.6832105268, 3.00632, 0.012436, 0.97315, 1.27950, 0.96956, 0.24873
+};
+
+constexpr double gammao[] =
+{
+    1.28728967, 3.53734222, 7.74073708, 9.24437796, 27.5075105
+};
+
+constexpr double c[] =
+{
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 3, 3, 3, 3, 4, 6, 6, 6, 6, 0, 0, 0
+};
+
+constexpr double d[] =
+{
+    0, 1, 1, 1, 2, 2, 3, 4, 1, 1, 1, 2, 2, 3, 4, 4, 5, 7, 9,
+    10, 11, 13, 15, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 7, 9, 9, 9,
+    9, 9, 10, 10, 12, 3, 4, 4, 5, 14, 3, 6, 6, 6, 3, 3, 3
+};
+
+
+constexpr double t[] =
+{
+    0, -0.5, 0.875, 1, 0.5, 0.75, 0.375, 1, 4, 6, 12, 1, 5, 4, 2, 13, 9, 3,
+    4, 11, 4, 13, 1, 7, 1, 9, 10, 10, 3, 7, 10, 10, 6, 10, 10, 1, 2, 3, 4,
+    8, 6, 9, 8, 16, 22, 23, 23, 10, 50, 44, 46, 50, 0, 1, 4
+};
+
+constexpr double n[] =
+{
+	 0,
+	 0.12533547935523e-01,
+	 0.78957634722828e+01,
+	-0.87803203303561e+01,
+	 0.31802509345418,
+	-0.26145533859358,
+	-0.78199751687981e-02,
+	 0.88089493102134e-02,
+	-0.66856572307965,
+	 0.20433810950965,
+	-0.66212605039687e-04,
+	-0.19232721156002,
+	-0.25709043003438,
+	 0.16074868486251,
+	-0.40092828925807e-01,
+	 0.39343422603254e-06,
+	-0.75941377088144e-05,
+	 0.56250979351888e-03,
+	-0.15608652257135e-04,
+	 0.11537996422951e-08,
+	 0.36582165144204e-06,
+	-0.13251180074668e-11,
+	-0.62639586912454e-09,
+	-0.10793600908932,
+	 0.17611491008752e-01,
+	 0.22132295167546,
+	-0.40247669763528,
+	 0.58083399985759,
+	 0.49969146990806e-02,
+	-0.31358700712549e-01,
+	-0.74315929710341,
+	 0.47807329915480,
+	 0.20527940895948e-01,
+	-0.13636435110343,
+	 0.14180634400617e-01,
+	 0.83326504880713e-02,
+	-0.29052336009585e-01,
+	 0.38615085574206e-01,
+	-0.20393486513704e-01,
+	-0.16554050063734e-02,
+	 0.19955571979541e-02,
+	 0.15870308324157e-03,
+	-0.16388568342530e-04,
+	 0.43613615723811e-01,
+	 0.34994005463765e-01,
+	-0.76788197844621e-01,
+	 0.22446277332006e-01,
+	-0.62689710414685e-04,
+	-0.55711118565645e-09,
+	-0.19905718354408,
+	 0.31777497330738,
+	-0.11841182425981,
+	-0.31306260323435e+02,
+	 0.31546140237781e+02,
+	-0.25213154341695e+04,
+	-0.14874640856724,
+	 0.31806110878444
+};
+
+constexpr double alpha[] = { 20, 20, 20 };
+
+constexpr double beta[] = { 150, 150, 250 };
+
+constexpr double gamma[] = { 1.21, 1.21, 1.25 };
+
+constexpr double epsilon[] = { 1, 1, 1 };
+
+constexpr double a[] = { 3.5, 3.5 };
+
+constexpr double b[] = { 0.85, 0.95 };
+
+constexpr double A[] = { 0.32, 0.32 };
+
+constexpr double B[] = { 0.2, 0.2 };
+
+constexpr double C[] = { 28, 32 };
+
+constexpr double F[] = { 700, 800 }; // D has been replaced by F to avoid conflicts
+
+constexpr double E[] = { 0.3, 0.3 };
+
+/// The dimensionless Helmholtz free energy of water and its partial derivatives with respect to delta and tau.
+template<typename Scalar>
+struct ReducedHelmholtzProps
+{
+    Scalar phi;
+    Scalar phi_d;
+    Scalar phi_t;
+    Scalar phi_dd;
+    Scalar phi_tt;
+    Scalar phi_dt;
+    Scalar phi_ddd;
+    Scalar phi_ttt;
+    Scalar phi_dtt;
+    Scalar phi_ddt;
+};
+
+/// The contributions to the Wagner and Pruss (2002) equation of state that depend only on temperature.
+/// Every exponent of tau in the residual part is either an integer or, in the first seven terms, an integer
+/// multiple of 1/8. The powers of tau below are built with products (plus three square roots for tau^(1/8)),
+/// so that each term indexes them at compile time instead of calling pow. The result differs from a pow-based
+/// evaluation only by rounding: relative to the natural scale of each quantity (e.g., R*T for the Helmholtz
+/// free energy, R*T/D for its density derivative), the differences stay below 1e-11 up to second-order
+/// derivatives and below 1e-10 for third-order ones, for temperatures in 250-1300 K and densities in 1e-4-1200 kg/m3.
+template<typename Scalar>
+struct TemperatureTerms
+{
+    /// The temperature of water (in units of K).
+    Scalar T;
+
+    /// The reduced inverse temperature tau = Tc/T.
+    Scalar tau;
+
+    /// The powers tau^k for k = 0, ..., 50.
+    Scalar taupow[51];
+
+    /// The powers tau^(k/8) for k = -8, ..., 8, stored at index k + 8.
+    Scalar taueighth[17];
+
+    /// The inverse powers 1/tau, 1/tau^2 and 1/tau^3.
+    Scalar itau, itau2, itau3;
+
+    /// The ideal-gas part of the dimensionless Helmholtz free energy without the log(delta) term, and its partial derivatives with respect to tau.
+    Scalar phio, phio_t, phio_tt, phio_ttt;
+
+    /// The factors exp(-beta*(tau - gamma)^2) of the Gaussian terms 52..54.
+    Scalar gauss[3];
+
+    /// The squared difference (tau - 1)^2 and the factors exp(-F*(tau - 1)^2) of the non-analytical terms 55..56.
+    Scalar tt, psit[2];
+};
+
+/// The contributions to the Wagner and Pruss (2002) equation of state that depend only on density.
+template<typename Scalar>
+struct DensityTerms
+{
+    /// The reduced density delta = D/Dc.
+    Scalar delta;
+
+    /// The powers delta^k for k = 0, ..., 15.
+    Scalar deltapow[16];
+
+    /// The exponentials exp(-delta^c) for c = 1, 2, 3, 4, 6, stored at index c (index 5 is not used).
+    Scalar expdelta[7];
+
+    /// The inverse powers 1/delta, 1/delta^2 and 1/delta^3.
+    Scalar idelta, idelta2, idelta3;
+};
+
+template<typename Scalar>
+auto calculateTemperatureTerms(const Scalar& T) -> TemperatureTerms<Scalar>
+{
+	using V = ValueType<Scalar>;
+
+	TemperatureTerms<Scalar> pt;
+
+	const Scalar tau = V(waterCriticalTemperature)/T;
+
+	pt.T = T;
+	pt.tau = tau;
+
+	pt.taupow[0] = 1;
+	for(int k = 1; k < 51; ++k)
+		pt.taupow[k] = pt.taupow[k - 1] * tau;
+
+	pt.itau  = 1/tau;
+	pt.itau2 = pt.itau * pt.itau;
+	pt.itau3 = pt.itau2 * pt.itau;
+
+	const Scalar tau2 = sqrt(tau);
+	const Scalar tau4 = sqrt(tau2);
+	const Scalar tau8 = sqrt(tau4);
+
+	pt.taueighth[8]  = 1;
+	pt.taueighth[9]  = tau8;
+	pt.taueighth[10] = tau4;
+	pt.taueighth[11] = tau4 * tau8;
+	pt.taueighth[12] = tau2;
+	pt.taueighth[13] = tau2 * tau8;
+	pt.taueighth[14] = tau2 * tau4;
+	pt.taueighth[15] = pt.taueighth[14] * tau8;
+	pt.taueighth[16] = tau;
+	for(int k = 0; k < 8; ++k)
+		pt.taueighth[k] = pt.taueighth[k + 8] * pt.itau;
+
+	pt.phio     = V(no[1]) + V(no[2])*tau + V(no[3])*log(tau);
+	pt.phio_t   = V(no[2]) + V(no[3])*pt.itau;
+	pt.phio_tt  = -V(no[3])*pt.itau2;
+	pt.phio_ttt = 2*V(no[3])*pt.itau3;
+
+	for(int i = 4; i <= 8; ++i)
+	{
+		const int j = i - 4;
+
+		const Scalar ee = exp(V(gammao[j]) * tau);
+		const Scalar ge = V(gammao[j])/(ee - 1);
+
+		pt.phio     += V(no[i]) * log(1 - 1/ee);
+		pt.phio_t   += V(no[i]) * ge;
+		pt.phio_tt  -= V(no[i]) * ee * ge*ge;
+		pt.phio_ttt += V(no[i]) * ee * (1 + ee) * ge*ge*ge;
+	}
+
+	for(int j = 0; j < 3; ++j)
+		pt.gauss[j] = exp(-V(beta[j])*(tau - V(gamma[j]))*(tau - V(gamma[j])));
+
+	pt.tt = (tau - 1)*(tau - 1);
+
+	for(int j = 0; j < 2; ++j)
+		pt.psit[j] = exp(-V(F[j])*pt.tt);
+
+	return pt;
+}
+
+template<typename Scalar>
+auto calculateDensityTerms(const Scalar& D) -> DensityTerms<Scalar>
+{
+	using V = ValueType<Scalar>;
+
+	DensityTerms<Scalar> pd;
+
+	const Scalar delta = D/V(waterCriticalDensity);
+
+	pd.delta = delta;
+
+	pd.deltapow[0] = 1;
+	for(int k = 1; k < 16; ++k)
+		pd.deltapow[k] = pd.deltapow[k - 1] * delta;
+
+	pd.idelta  = 1/delta;
+	pd.idelta2 = pd.idelta * pd.idelta;
+	pd.idelta3 = pd.idelta2 * pd.idelta;
+
+	pd.expdelta[0] = 1;
+	pd.expdelta[1] = exp(-pd.deltapow[1]);
+	pd.expdelta[2] = exp(-pd.deltapow[2]);
+	pd.expdelta[3] = exp(-pd.deltapow[3]);
+	pd.expdelta[4] = exp(-pd.deltapow[4]);
+	pd.expdelta[5] = 0;
+	pd.expdelta[6] = exp(-pd.deltapow[6]);
+
+	return pd;
+}
+
+/// Add the contribution of the i-th term in 1..7 of the residual part, n*delta^d*tau^t.
+template<int i, int order, typename Scalar>
+auto addResidualTermPolynomial(const TemperatureTerms<Scalar>& pt, const DensityTerms<Scalar>& pd, ReducedHelmholtzProps<Scalar>& h) -> void
+{
+	using V = ValueType<Scalar>;
+
+	constexpr V di = d[i];
+	constexpr V ti = t[i];
+	constexpr int kd = static_cast<int>(di);
+	constexpr int kt = static_cast<int>(8 * ti);
+
+	static_assert(kd == di && kt == 8 * ti && kt >= -8 && kt <= 8, "Unexpected exponent in the residual part of the Wagner-Pruss model.");
+
+	const Scalar A = V(n[i])*pd.deltapow[kd]*pt.taueighth[kt + 8];
+
+	h.phi += A;
+
+	if constexpr(order >= 1)
+	{
+		const auto A_d = di*pd.idelta * A;
+		const auto A_t = ti*pt.itau * A;
+
+		h.phi_d += A_d;
+		h.phi_t += A_t;
+
+		if constexpr(order >= 2)
+		{
+			const auto A_dd = (di - 1)*pd.idelta * A_d;
+			const auto A_tt = (ti - 1)*pt.itau * A_t;
+			const auto A_dt = ti*di*pt.itau*pd.idelta * A;
+
+			h.phi_dd += A_dd;
+			h.phi_tt += A_tt;
+			h.phi_dt += A_dt;
+
+			if constexpr(order >= 3)
+			{
+				h.phi_ddd += (di - 2)*pd.idelta * A_dd;
+				h.phi_ttt += (ti - 2)*pt.itau * A_tt;
+				h.phi_dtt += di*pd.idelta * A_tt;
+				h.phi_ddt += ti*pt.itau * A_dd;
+			}
+		}
+	}
+}
+
+/// Add the contribution of the i-th term in 8..51 of the residual part, n*delta^d*tau^t*exp(-delta^c).
+template<int i, int order, typename Scalar>
+auto addResidualTermExponential(const TemperatureTerms<Scalar>& pt, const DensityTerms<Scalar>& pd, ReducedHelmholtzProps<Scalar>& h) -> void
+{
+	using V = ValueType<Scalar>;
+
+	constexpr V ci = c[i];
+	constexpr V di = d[i];
+	constexpr V ti = t[i];
+	constexpr int kc = static_cast<int>(ci);
+	constexpr int kd = static_cast<int>(di);
+	constexpr int kt = static_cast<int>(ti);
+
+	static_assert(kc == ci && kd == di && kt == ti && kc != 5, "Unexpected exponent in the residual part of the Wagner-Pruss model.");
+
+	const auto dci = pd.deltapow[kc];
+
+	const Scalar B = V(n[i])*pd.deltapow[kd]*pt.taupow[kt]*pd.expdelta[kc];
+
+	h.phi += B;
+
+	if constexpr(order >= 1)
+	{
+		const auto B_d = (di - ci*dci)*pd.idelta * B;
+		const auto B_t =  ti*pt.itau * B;
+
+		h.phi_d += B_d;
+		h.phi_t += B_t;
+
+		if constexpr(order >= 2)
+		{
+			const auto aux = di - ci*dci - 1;
+
+			const auto B_dd = aux*pd.idelta * B_d - ci*ci*dci*pd.idelta2 * B;
+			const auto B_tt = (ti - 1)*pt.itau * B_t;
+			const auto B_dt =  ti*pt.itau * B_d;
+
+			h.phi_dd += B_dd;
+			h.phi_tt += B_tt;
+			h.phi_dt += B_dt;
+
+			if constexpr(order >= 3)
+			{
+				h.phi_ddd += aux*pd.idelta * B_dd - (aux + 2*ci*ci*dci)*pd.idelta2 * B_d - ci*ci*(ci - 2)*dci*pd.idelta3 * B;
+				h.phi_ttt += (ti - 2)*pt.itau * B_tt;
+				h.phi_dtt += (ti - 1)*pt.itau * B_dt;
+				h.phi_ddt += aux*pd.idelta * B_dt - ci*ci*dci*pd.idelta2 * B_t;
+			}
+		}
+	}
+}
+
+/// Add the contribution of the i-th term in 52..54 of the residual part, the Gaussian bell-shaped terms.
+template<int i, int order, typename Scalar>
+auto addResidualTermGaussian(const TemperatureTerms<Scalar>& pt, const DensityTerms<Scalar>& pd, ReducedHelmholtzProps<Scalar>& h) -> void
+{
+	using V = ValueType<Scalar>;
+
+	constexpr int j = i - 52;
+	constexpr V di = d[i];
+	constexpr V ti = t[i];
+	constexpr V alphaj = alpha[j];
+	constexpr V betaj = beta[j];
+	constexpr int kd = static_cast<int>(di);
+	constexpr int kt = static_cast<int>(ti);
+
+	static_assert(kd == di && kt == ti, "Unexpected exponent in the residual part of the Wagner-Pruss model.");
+
+	const Scalar de = pd.delta - V(epsilon[j]);
+	const Scalar tg = pt.tau - V(gamma[j]);
+
+	const Scalar C = V(n[i])*pd.deltapow[kd]*pt.taupow[kt]*exp(-alphaj*de*de)*pt.gauss[j];
+
+	h.phi += C;
+
+	if constexpr(order >= 1)
+	{
+		const auto aux1d = (di*pd.idelta - 2*alphaj*de);
+		const auto aux1t = (ti*pt.itau - 2*betaj*tg);
+
+		const auto C_d = aux1d * C;
+		const auto C_t = aux1t * C;
+
+		h.phi_d += C_d;
+		h.phi_t += C_t;
+
+		if constexpr(order >= 2)
+		{
+			const auto aux2d = (di*pd.idelta2 + 2*alphaj);
+			const auto aux2t = (ti*pt.itau2 + 2*betaj);
+
+			const auto C_dd = aux1d * C_d - aux2d * C;
+			const auto C_tt = aux1t * C_t - aux2t * C;
+			const auto C_dt = aux1d * aux1t * C;
+
+			h.phi_dd += C_dd;
+			h.phi_tt += C_tt;
+			h.phi_dt += C_dt;
+
+			if constexpr(order >= 3)
+			{
+				h.phi_ddd += aux1d * C_dd - 2*aux2d * C_d + 2*di*pd.idelta3 * C;
+				h.phi_ttt += aux1t * C_tt - 2*aux2t * C_t + 2*ti*pt.itau3 * C;
+				h.phi_dtt += aux1t * C_dt - aux2t * C_d;
+				h.phi_ddt += aux1d * C_dt - aux2d * C_t;
+			}
+		}
+	}
+}
+
+/// Add the contributions of the terms 1..54 of the residual part, unrolled at compile time.
+template<int order, typename Scalar, int... i, int... j, int... k>
+auto addResidualTerms(const TemperatureTerms<Scalar>& pt, const DensityTerms<Scalar>& pd, ReducedHelmholtzProps<Scalar>& h,
+	std::integer_sequence<int, i...>, std::integer_sequence<int, j...>, std::integer_sequence<int, k...>) -> void
+{
+	(addResidualTermPolynomial<i + 1, order>(pt, pd, h), ...);
+	(addResidualTermExponential<j + 8, order>(pt, pd, h), ...);
+	(addResidualTermGaussian<k + 52, order>(pt, pd, h), ...);
+}
+
+template<int order, typename Scalar>
+auto calculateWaterHelmholtzPropsWagnerPruss(const TemperatureTerms<Scalar>& pt, const Scalar& D) -> WaterHelmholtzPropsBase<Scalar>
+{
+	static_assert(order >= 0 && order <= 3, "The order of the partial derivatives must be between 0 and 3.");
+
+	using V = ValueType<Scalar>;
+
+	const auto pd = calculateDensityTerms(D);
+
+	const auto& T     = pt.T;
+	const auto& tau   = pt.tau;
+	const auto& delta = pd.delta;
+
+	// The dimensionless Helmholtz free energy and its partial derivatives (the ideal-gas part is accumulated first)
+	ReducedHelmholtzProps<Scalar> h = {};
+
+	h.phi = log(delta) + pt.phio;
+
+	if constexpr(order >= 1)
+	{
+		h.phi_d = pd.idelta;
+		h.phi_t = pt.phio_t;
+	}
+	if constexpr(order >= 2)
+	{
+		h.phi_dd = -pd.idelta2;
+		h.phi_tt = pt.phio_tt;
+	}
+	if constexpr(order >= 3)
+	{
+		h.phi_ddd = 2*pd.idelta3;
+		h.phi_ttt = pt.phio_ttt;
+	}
+
+	addResidualTerms<order>(pt, pd, h,
+		std::make_integer_sequence<int, 7>(),
+		std::make_integer_sequence<int, 44>(),
+		std::make_integer_sequence<int, 3>());
+
+	const auto dd = (delta - 1)*(delta - 1);
+
+	for(int i = 55; i <= 56; ++i)
+	{
+		const int j = i - 55;
+
+		const V ni = n[i], Aj = A[j], Bj = B[j], Cj = C[j], Fj = F[j], aj = a[j], bj = b[j];
+		const V Ej = E[j], Ej2 = 0.5/E[j], Ej1 = 1.0/E[j] - 1;
+
+		const auto theta    = (1 - tau) + Aj*pow(dd, Ej2);
+		const auto psi      = exp(-Cj*dd)*pt.psit[j];
+		const auto Delta    = theta*theta + Bj*pow(dd, aj);
+		const auto DeltaPow = pow(Delta, bj);
+
+		h.phi += ni*DeltaPow*delta*psi;
+
+		if constexpr(order >= 1)
+		{
+			const auto theta_d = (theta + tau - 1)/(delta - 1)/Ej;
+
+			const auto psi_d = -2*Cj*(delta - 1) * psi;
+			const auto psi_t = -2*Fj*(tau - 1) * psi;
+
+			const auto Delta_d = 2*(theta*theta_d + aj*(Delta - theta*theta)/(delta - 1));
+			const auto Delta_t = -2*theta;
+
+			const auto DeltaPow_d = bj*Delta_d/Delta * DeltaPow;
+			const auto DeltaPow_t = bj*Delta_t/Delta * DeltaPow;
+
+			h.phi_d += ni*(DeltaPow*(psi + delta*psi_d) + DeltaPow_d*delta*psi);
+			h.phi_t += ni*delta*(DeltaPow_t*psi + DeltaPow*psi_t);
+
+			if constexpr(order >= 2)
+			{
+				const auto theta_dd = Ej1 * theta_d/(delta - 1);
+
+				const auto psi_dd = -2*Cj*(psi + (delta - 1) * psi_d);
+				const auto psi_tt = -2*Fj*(psi + (tau - 1) * psi_t);
+				const auto psi_dt =  4*Cj*Fj*(delta - 1)*(tau - 1) * psi;
+
+				const auto Delta_dd = 2*(theta_d*theta_d + theta*theta_dd + aj * ((Delta_d - 2*theta*theta_d)/(delta - 1) - (Delta - theta*theta)/dd));
+				const auto Delta_tt = 2;
+				const auto Delta_dt = -2*theta_d;
+
+				const auto Delta_dr = Delta_d/Delta;
+				const auto Delta_tr = Delta_t/Delta;
+
+				const auto DeltaPow_dd = (bj*Delta_dd/Delta + bj*(bj - 1)*Delta_dr*Delta_dr) * DeltaPow;
+				const auto DeltaPow_tt = (bj*Delta_tt/Delta + bj*(bj - 1)*Delta_tr*Delta_tr) * DeltaPow;
+				const auto DeltaPow_dt = (bj*Delta_dt/Delta + bj*(bj - 1)*Delta_d*Delta_t/Delta/Delta) * DeltaPow;
+
+				h.phi_dd += ni*(DeltaPow*(2*psi_d + delta*psi_dd) + 2*DeltaPow_d*(psi + delta*psi_d) + DeltaPow_dd*delta*psi);
+				h.phi_tt += ni*delta*(DeltaPow_tt*psi + 2*DeltaPow_t*psi_t + DeltaPow*psi_tt);
+				h.phi_dt += ni*(DeltaPow*(psi_t + delta*psi_dt) + delta*DeltaPow_d*psi_t + DeltaPow_t*(psi + delta*psi_d) + DeltaPow_dt*delta*psi);
+
+				if constexpr(order >= 3)
+				{
+					const auto theta_ddd = Ej1 * (theta_dd/(delta - 1) - theta_d/dd);
+
+					const auto psi_ddd = -2*Cj*(2*psi_d + (delta - 1) * psi_dd);
+					const auto psi_ttt = -2*Fj*(2*psi_t + (tau - 1) * psi_tt);
+					const auto psi_dtt = -2*Fj*(psi_d + (tau - 1) * psi_dt);
+					const auto psi_ddt = -2*Cj*(psi_t + (delta - 1) * psi_dt);
+
+					const auto Delta_ddd = 2*(3*theta_d*theta_dd + theta*theta_ddd + aj * ((Delta_dd - 2*theta_d*theta_d - 2*theta*theta_dd)/(delta - 1) - 2*(Delta_d - 2*theta*theta_d)/dd + 2*(Delta - theta*theta)/(dd*(delta - 1))));
+					const auto Delta_ttt = 0;
+					const auto Delta_dtt = 0;
+					const auto Delta_ddt = -2*theta_dd;
+
+					const auto Delta3 = Delta*Delta*Delta;
+
+					const auto DeltaPow_ddd = (bj*Delta_ddd/Delta + 3*bj*(bj - 1)*Delta_d*Delta_dd/Delta/Delta + bj*(bj - 1)*(bj - 2)*Delta_dr*Delta_dr*Delta_dr) * DeltaPow;
+					const auto DeltaPow_ttt = (bj*Delta_ttt/Delta + 3*bj*(bj - 1)*Delta_t*Delta_tt/Delta/Delta + bj*(bj - 1)*(bj - 2)*Delta_tr*Delta_tr*Delta_tr) * DeltaPow;
+					const auto DeltaPow_dtt = (bj*Delta_dtt/Delta + bj*(bj - 1)*(Delta_d*Delta_tt + 2*Delta_t*Delta_dt)/Delta/Delta + bj*(bj - 1)*(bj - 2)*Delta_t*Delta_t*Delta_d/Delta3) * DeltaPow;
+					const auto DeltaPow_ddt = (bj*Delta_ddt/Delta + bj*(bj - 1)*(Delta_t*Delta_dd + 2*Delta_d*Delta_dt)/Delta/Delta + bj*(bj - 1)*(bj - 2)*Delta_d*Delta_d*Delta_t/Delta3) * DeltaPow;
+
+					h.phi_ddd += ni*(DeltaPow_ddd*delta*psi + 3*DeltaPow_dd*(psi + delta*psi_d) + 3*DeltaPow_d*(2*psi_d + delta*psi_dd) + DeltaPow*(3*psi_dd + delta*psi_ddd));
+					h.phi_ttt += ni*delta*(DeltaPow_ttt*psi + 3*DeltaPow_tt*psi_t + 3*DeltaPow_t*psi_tt + DeltaPow*psi_ttt);
+					h.phi_dtt += ni*(DeltaPow_tt*psi + 2*DeltaPow_t*psi_t + DeltaPow*psi_tt) + ni*delta*(DeltaPow_dtt*psi + DeltaPow_tt*psi_d + 2*DeltaPow_dt*psi_t + 2*DeltaPow_t*psi_dt + DeltaPow_d*psi_tt + DeltaPow*psi_dtt);
+					h.phi_ddt += ni*(DeltaPow_ddt*delta*psi + 2*DeltaPow_dt*(psi + delta*psi_d) + DeltaPow_dd*delta*psi_t + DeltaPow_t*(2*psi_d + delta*psi_dd) + 2*DeltaPow_d*(psi_t + delta*psi_dt) + DeltaPow*(2*psi_dt + delta*psi_ddt));
+				}
+			}
+		}
+	}
+
+	const V Tcr = waterCriticalTemperature;
+	const V Dcr = waterCriticalDensity;
+
+	// The specific gas constant in units of J/(kg*K)
+	const V R = 461.51805;
+
+	WaterHelmholtzPropsBase<Scalar> res = {};
+
+	res.helmholtz = R*T*h.phi;
+
+	if constexpr(order >= 1)
+	{
+		const auto tT = -Tcr/(T*T);
+		const auto dD =  1/Dcr;
+
+		const auto phiT = h.phi_t*tT;
+		const auto phiD = h.phi_d*dD;
+
+		res.helmholtzT = R*T*phiT + R*h.phi;
+		res.helmholtzD = R*T*phiD;
+
+		if constexpr(order >= 2)
+		{
+			const auto tTT = 2*Tcr/(T*T*T);
+
+			const auto phiTT = h.phi_tt*tT*tT + h.phi_t*tTT;
+			const auto phiTD = h.phi_dt*tT*dD;
+			const auto phiDD = h.phi_dd*dD*dD;
+
+			res.helmholtzTT = R*T*phiTT + 2*R*phiT;
+			res.helmholtzTD = R*T*phiTD + R*phiD;
+			res.helmholtzDD = R*T*phiDD;
+
+			if constexpr(order >= 3)
+			{
+				const auto tTTT = -6*Tcr/(T*T*T*T);
+
+				const auto phiTTT = h.phi_ttt*tT*tT*tT + 3*h.phi_tt*tT*tTT + h.phi_t*tTTT;
+				const auto phiTTD = h.phi_dtt*tT*tT*dD + h.phi_dt*tTT*dD;
+				const auto phiTDD = h.phi_ddt*tT*dD*dD;
+				const auto phiDDD = h.phi_ddd*dD*dD*dD;
+
+				res.helmholtzTTT = R*T*phiTTT + 3*R*phiTT;
+				res.helmholtzTTD = R*T*phiTTD + 2*R*phiTD;
+				res.helmholtzTDD = R*T*phiTDD + R*phiDD;
+				res.helmholtzDDD = R*T*phiDDD;
+			}
+		}
+	}
+
+	return res;
+}
+
+template<int order, typename Scalar>
+auto calculateWaterHelmholtzPropsWagnerPruss(const Scalar& T, const Scalar& D) -> WaterHelmholtzPropsBase<Scalar>
+{
+	return calculateWaterHelmholtzPropsWagnerPruss<order>(calculateTemperatureTerms(T), D);
+}
+
+/// Return the Helmholtz free energy properties of water stored in a given lane of the evaluated states.
+template<typename Result, typename Scalar>
+auto extract(const WaterHelmholtzPropsBase<Scalar>& aux, std::size_t i) -> Result
+{
+    Result res;
+    res.helmholtz    = lane(aux.helmholtz, i);
+    res.helmholtzT   = lane(aux.helmholtzT, i);
+    res.helmholtzD   = lane(aux.helmholtzD, i);
+    res.helmholtzTT  = lane(aux.helmholtzTT, i);
+    res.helmholtzTD  = lane(aux.helmholtzTD, i);
+    res.helmholtzDD  = lane(aux.helmholtzDD, i);
+    res.helmholtzTTT = lane(aux.helmholtzTTT, i);
+    res.helmholtzTTD = lane(aux.helmholtzTTD, i);
+    res.helmholtzTDD = lane(aux.helmholtzTDD, i);
+    res.helmholtzDDD = lane(aux.helmholtzDDD, i);
+    return res;
+}
+
+} // namespace wagnerpruss
+
+/// Calculate the Helmholtz free energy state of water using the Wagner and Pruss (2002) equation of state with a generic scalar type.
+/// The same code path serves scalar, vectorized and differentiated evaluations. The scalar type can be a floating-point type,
+/// a pack of floating-point values (e.g., RealSimd), or any other type with the arithmetic operators and the functions exp, log,
+/// sqrt and pow found by argument-dependent lookup (e.g., a dual number type for automatic differentiation). The coefficients
+/// of the model are converted to ValueType<Scalar> before use, so types whose values are not floating-point numbers (such as
+/// dual numbers) should specialize ValueTypeHelper to their underlying floating-point type.
+/// @param T The temperature of water (in units of K)
+/// @param D The density of water (in units of kg/m3)
+/// @return The Helmholtz free energy state of water
+/// @see Fluidika::waterHelmholtzPropsWagnerPruss
+template<typename Scalar>
+auto waterHelmholtzPropsWagnerPruss(const Scalar& T, const Scalar& D) -> WaterHelmholtzPropsBase<Scalar>
+{
+    return wagnerpruss::calculateWaterHelmholtzPropsWagnerPruss<3>(T, D);
+}
+
+/// Calculate the Helmholtz free energy state of water using the Wagner and Pruss (2002) equation of state with a generic scalar type and partial derivatives up to a given order.
+/// @tparam order The highest order of the partial derivatives to be computed (0, 1, 2 or 3)
+/// @param T The temperature of water (in units of K)
+/// @param D The density of water (in units of kg/m3)
+/// @return The Helmholtz free energy state of water
+/// @see waterHelmholtzPropsWagnerPruss
+template<int order, typename Scalar>
+auto waterHelmholtzPropsWagnerPrussUpToOrder(const Scalar& T, const Scalar& D) -> WaterHelmholtzPropsBase<Scalar>
+{
+    return wagnerpruss::calculateWaterHelmholtzPropsWagnerPruss<order>(T, D);
+}
+
+/// Calculate the saturated liquid density of water using the Wagner and Pruss (2002) correlation with a generic scalar type.
+/// @param T The temperature of water (in units of K)
+/// @return The saturated liquid density of water (in units of kg/m3)
+template<typename Scalar>
+auto waterDensitySaturatedLiquidStateWagnerPruss(const Scalar& T) -> Scalar
+{
+    using std::cbrt;
+    using V = ValueType<Scalar>;
+
+    const V b1 =  1.99274064;
+    const V b2 =  1.09965342;
+    const V b3 = -0.510839303;
+    const V b4 = -1.75493479;
+    const V b5 = -45.5170352;
+    const V b6 = -6.74694450e+05;
+
+    const V Tcr = waterCriticalTemperature;
+    const V Dcr = waterCriticalDensity;
+
+    const Scalar t     = 1 - T/Tcr;
+    const Scalar t13   = cbrt(t);
+    const Scalar t23   = t13 * t13;
+    const Scalar t53   = t13 * t23 * t23;
+    const Scalar t163  = t13 * t53 * t53 * t53;
+    const Scalar t433  = t163 * t163 * t53 * t * t;
+    const Scalar t1103 = t433 * t433 * t163 * t53 * t;
+
+    return Dcr * (1 + b1*t13 + b2*t23 + b3*t53 + b4*t163 + b5*t433 + b6*t1103);
+}
+
+/// Calculate the saturated vapor density of water using the Wagner and Pruss (2002) correlation with a generic scalar type.
+/// @param T The temperature of water (in units of K)
+/// @return The saturated vapor density of water (in units of kg/m3)
+template<typename Scalar>
+auto waterDensitySaturatedVaporStateWagnerPruss(const Scalar& T) -> Scalar
+{
+    using std::cbrt;
+    using std::exp;
+    using std::sqrt;
+    using V = ValueType<Scalar>;
+
+    const V c1 = -2.03150240;
+    const V c2 = -2.68302940;
+    const V c3 = -5.38626492;
+    const V c4 = -17.2991605;
+    const V c5 = -44.7586581;
+    const V c6 = -63.9201063;
+
+    const V Tcr = waterCriticalTemperature;
+    const V Dcr = waterCriticalDensity;
+
+    const Scalar t    = 1 - T/Tcr;
+    const Scalar t16  = sqrt(cbrt(t));
+    const Scalar t26  = t16 * t16;
+    const Scalar t46  = t26 * t26;
+    const Scalar t86  = t46 * t46;
+    const Scalar t186 = t86 * t86 * t26;
+    const Scalar t376 = t186 * t186 * t16;
+    const Scalar t716 = t376 * t186 * t86 * t86;
+
+    return Dcr * exp(c1*t26 + c2*t46 + c3*t86 + c4*t186 + c5*t376 + c6*t716);
+}
+
+/// Calculate the saturated pressure of water using the Wagner and Pruss (2002) correlation with a generic scalar type.
+/// @param T The temperature of water (in units of K)
+/// @return The saturated pressure of water (in units of Pa)
+template<typename Scalar>
+auto waterPressureSaturatedStateWagnerPruss(const Scalar& T) -> Scalar
+{
+    using std::exp;
+    using std::sqrt;
+    using V = ValueType<Scalar>;
+
+    const V a1 = -7.85951783;
+    const V a2 =  1.84408259;
+    const V a3 = -11.7866497;
+    const V a4 =  22.6807411;
+    const V a5 = -15.9618719;
+    const V a6 =  1.80122502;
+
+    const V Tcr = waterCriticalTemperature;
+    const V Pcr = waterCriticalPressure;
+
+    const Scalar t   = 1 - T/Tcr;
+    const Scalar t15 = t * sqrt(t);
+    const Scalar t30 = t15 * t15;
+    const Scalar t35 = t15 * t * t;
+    const Scalar t40 = t30 * t;
+    const Scalar t75 = t35 * t40;
+
+    return Pcr * exp(Tcr/T * (a1*t + a2*t15 + a3*t30 + a4*t35 + a5*t40 + a6*t75));
+}
+
+#if FLUIDIKA_HAS_SIMD
+
+/// Calculate the Helmholtz free energy states of water using the Wagner and Pruss (2002) equation of state for many pairs of temperature and density in packs of a given SIMD type.
+/// @tparam Simd The type of the packs (e.g., RealSimd or FloatSimd)
+/// @param n The number of states to be evaluated
+/// @param T The array of temperatures of water (in units of K) with length *n*
+/// @param D The array of densities of water (in units of kg/m3) with length *n*
+/// @param[out] res The array of Helmholtz free energy states of water with length *n*
+template<typename Simd, typename Result>
+auto waterHelmholtzPropsWagnerPrussBatch(std::size_t n, const typename Simd::value_type* T, const typename Simd::value_type* D, Result* res) -> void
+{
+    const auto width = Simd::size();
+
+    for(std::size_t k = 0; k < n; k += width)
+    {
+        // The number of states in this pack (the last pack may be partially filled, in which case its last state is repeated in the remaining lanes)
+        const auto m = n - k < width ? n - k : width;
+
+        const auto aux = wagnerpruss::calculateWaterHelmholtzPropsWagnerPruss<3>(load<Simd>(T + k, m), load<Simd>(D + k, m));
+
+        for(std::size_t i = 0; i < m; ++i)
+            res[k + i] = wagnerpruss::extract<Result>(aux, i);
+    }
+}
+
+/// Calculate the thermodynamic properties of water using the Wagner and Pruss (2002) equation of state for many pairs of temperature and pressure in packs of a given SIMD type.
+/// @tparam Simd The type of the packs (e.g., RealSimd)
+/// @param n The number of states to be calculated
+/// @param T The array of temperatures of water (in units of K) with length *n*
+/// @param P The array of pressures of water (in units of Pa) with length *n*
+/// @param D0 The array of initial guesses for the density of water (in units of kg/m3) with length *n*
+/// @param[out] res The array of thermodynamic properties of water with length *n*
+/// @param[out] status The array of outcomes of the density calculations with length *n*, or nullptr if not needed
+/// @return The number of states whose density did not converge
+/// @see waterThermoPropsBatch
+template<typename Simd>
+auto waterThermoPropsWagnerPrussBatch(std::size_t n, const Real* T, const Real* P, const Real* D0, WaterThermoProps* res, WaterSolverStatus* status) -> std::size_t
+{
+    const auto terms = [](const Simd& T) { return wagnerpruss::calculateTemperatureTerms(T); };
+    const auto modeliter = [](const auto& tt, const Simd& D) { return wagnerpruss::calculateWaterHelmholtzPropsWagnerPruss<2>(tt, D); };
+    const auto model = [](const auto& tt, const Simd& D) { return wagnerpruss::calculateWaterHelmholtzPropsWagnerPruss<3>(tt, D); };
+    return waterThermoPropsBatch<Simd>(n, T, P, D0, res, status, terms, modeliter, model);
+}
+
+/// Calculate the densities of water using the Wagner and Pruss (2002) equation of state for many pairs of temperature and pressure in single-precision packs of a given SIMD type.
+/// @tparam Simd The type of the packs (e.g., FloatSimd)
+/// @param n The number of states to be calculated
+/// @param T The array of temperatures of water (in units of K) with length *n*
+/// @param P The array of pressures of water (in units of Pa) with length *n*
+/// @param D0 The array of initial guesses for the density of water (in units of kg/m3) with length *n*
+/// @param[out] D The array of densities of water (in units of kg/m3) with length *n*
+/// @param[out] status The array of outcomes of the density calculations with length *n*, or nullptr if not needed
+/// @return The number of states whose density did not converge
+/// @see waterDensitySinglePrecisionBatch
+template<typename Simd>
+auto waterDensityWagnerPrussBatch(std::size_t n, const Real* T, const Real* P, const Real* D0, Real* D, WaterSolverStatus* status) -> std::size_t
+{
+    const auto terms = [](const Simd& T) { return wagnerpruss::calculateTemperatureTerms(T); };
+    const auto modeliter = [](const auto& tt, const Simd& D) { return wagnerpruss::calculateWaterHelmholtzPropsWagnerPruss<2>(tt, D); };
+    return waterDensitySinglePrecisionBatch<Simd>(n, T, P, D0, D, status, terms, modeliter);
+}
+
+#endif
+
+// The double instantiations are compiled into the library
+extern template auto waterHelmholtzPropsWagnerPruss(const Real& T, const Real& D) -> WaterHelmholtzPropsBase<Real>;
+extern template auto waterHelmholtzPropsWagnerPrussUpToOrder<0>(const Real& T, const Real& D) -> WaterHelmholtzPropsBase<Real>;
+extern template auto waterHelmholtzPropsWagnerPrussUpToOrder<1>(const Real& T, const Real& D) -> WaterHelmholtzPropsBase<Real>;
+extern template auto waterHelmholtzPropsWagnerPrussUpToOrder<2>(const Real& T, const Real& D) -> WaterHelmholtzPropsBase<Real>;
+extern template auto waterHelmholtzPropsWagnerPrussUpToOrder<3>(const Real& T, const Real& D) -> WaterHelmholtzPropsBase<Real>;
+extern template auto waterDensitySaturatedLiquidStateWagnerPruss(const Real& T) -> Real;
+extern template auto waterDensitySaturatedVaporStateWagnerPruss(const Real& T) -> Real;
+extern template auto waterPressureSaturatedStateWagnerPruss(const Real& T) -> Real;
+
+} // inline namespace FLUIDIKA_ISA_NAMESPACE
+} // namespace generic
+} // namespace Fluidika
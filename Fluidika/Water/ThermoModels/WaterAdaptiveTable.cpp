@@ -0,0 +1,624 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "WaterAdaptiveTable.hpp"
+
+// C++ includes
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Common/Exception.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/ThermoModels/WaterSaturationCurve.hpp>
+#include <Fluidika/Water/ThermoModels/WaterTableBuilder.hpp>
+#include <Fluidika/Water/ThermoModels/WaterTableFields.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+
+namespace Fluidika {
+
+namespace {
+
+using namespace internal;
+
+/// The number of properties interpolated in each cell of the table.
+constexpr auto num_fields = waterTableNumFields;
+
+/// The gap between the highest temperature of the liquid and vapor sheets and the critical temperature (in units of K).
+constexpr Real critical_gap = 1e-3;
+
+/// The relative difference from the saturation pressure within which states are calculated with the equation of state, which exceeds the error of the saturation curve.
+constexpr Real saturation_gap = 1e-7;
+
+/// The coefficients of the cubic polynomial in *t* that interpolates four values at *t* = 0, 1/3, 2/3 and 1.
+constexpr Real power_basis[4][4] = {
+    {  1.0,   0.0,   0.0,  0.0 },
+    { -5.5,   9.0,  -4.5,  1.0 },
+    {  9.0, -22.5,  18.0, -4.5 },
+    { -4.5,  13.5, -13.5,  4.5 },
+};
+
+/// The phases of water covered by the sheets of the table.
+enum class WaterAdaptiveSheetPhase
+{
+    Liquid, Vapor, Supercritical
+};
+
+/// The properties stored in the table at a point of a cell, which are NaN if the equation of state failed there.
+struct WaterAdaptiveSample
+{
+    /// The values of the properties (see @ref waterTableFields).
+    Real values[num_fields];
+};
+
+/// A node of a quadtree of the table, which is either subdivided into four children or a cell.
+struct WaterAdaptiveNode
+{
+    /// The index of the first of the four contiguous children of the node, or -1 if the node is a cell.
+    std::int32_t children = -1;
+
+    /// The index of the coefficients of the cell, or -1 if the node is subdivided or its properties are calculated with the equation of state.
+    std::int32_t cell = -1;
+};
+
+/// A cell of a quadtree of the table with the bicubic polynomials of its properties.
+struct WaterAdaptiveCell
+{
+    /// The coefficients of the polynomials by term x^i*y^j (at index 4*i + j) and then by property, so that the properties are evaluated together.
+    Real coefficients[16][num_fields];
+
+    /// Return the values of the properties at given coordinates within the cell, each from 0 to 1.
+    auto evaluate(RealConstRef x, RealConstRef y, Real* values) const -> void
+    {
+        const Real xs[4] = { 1.0, x, x*x, x*x*x };
+        const Real ys[4] = { 1.0, y, y*y, y*y*y };
+
+        std::fill(values, values + num_fields, 0.0);
+
+        for(std::size_t i = 0; i < 4; ++i)
+            for(std::size_t j = 0; j < 4; ++j)
+            {
+                const auto w = xs[i]*ys[j];
+                for(std::size_t k = 0; k < num_fields; ++k)
+                    values[k] += w*coefficients[4*i + j][k];
+            }
+    }
+};
+
+/// A cell of a quadtree of the table whose interpolation points are known and whose check points are yet to be calculated.
+struct WaterAdaptivePendingCell
+{
+    /// The index of the node of the cell in the quadtree.
+    std::size_t node;
+
+    /// The depth of the cell in the quadtree.
+    std::size_t depth;
+
+    /// The coordinates of the lower corner of the cell in the sheet, each from 0 to 1.
+    Real x0, y0;
+
+    /// The properties at the 4x4 interpolation points of the cell, by temperature and then by pressure.
+    WaterAdaptiveSample samples[4][4];
+};
+
+/// The outcome of the calculation of the check points of a cell of a quadtree of the table.
+struct WaterAdaptiveOutcome
+{
+    /// Whether the cell satisfies the tolerance, is subdivided, or is calculated with the equation of state.
+    enum { Interpolated, Subdivided, Unresolved } kind;
+
+    /// The coefficients of the polynomials of the cell if it satisfies the tolerance.
+    WaterAdaptiveCell cell;
+
+    /// The four children of the cell if it is subdivided, in the order of the children of its node.
+    std::vector<WaterAdaptivePendingCell> children;
+
+    /// The number of evaluations of the equation of state used for the cell.
+    std::size_t evaluations = 0;
+};
+
+/// A sheet of the table, made of a quadtree of cells over temperature and the scaled pressure coordinate of the sheet.
+struct WaterAdaptiveSheet
+{
+    /// The phase of water covered by the sheet.
+    WaterAdaptiveSheetPhase phase;
+
+    /// The lowest and highest temperatures of the sheet (in units of K).
+    Real Tmin, Tmax;
+
+    /// The nodes of the quadtree in breadth-first order, starting from its root.
+    std::vector<WaterAdaptiveNode> nodes;
+
+    /// The cells of the quadtree whose properties are interpolated.
+    std::vector<WaterAdaptiveCell> cells;
+
+    /// The number of cells of the quadtree whose properties are calculated with the equation of state.
+    std::size_t unresolved = 0;
+
+    /// The largest depth of the cells of the quadtree.
+    std::size_t depth = 0;
+
+    /// The number of evaluations of the equation of state used to construct the quadtree.
+    std::size_t evaluations = 0;
+
+    /// Construct a WaterAdaptiveSheet instance with an empty quadtree.
+    WaterAdaptiveSheet(WaterAdaptiveSheetPhase phase, RealConstRef Tmin, RealConstRef Tmax)
+    : phase(phase), Tmin(Tmin), Tmax(Tmax)
+    {}
+
+    /// Return the cell of the quadtree at given coordinates in the sheet, each from 0 to 1, which become the coordinates in the cell.
+    /// @return The cell, or null if its properties are calculated with the equation of state
+    auto find(Real& x, Real& y) const -> const WaterAdaptiveCell*
+    {
+        const auto* node = &nodes.front();
+        while(node->children >= 0)
+        {
+            x *= 2.0;
+            y *= 2.0;
+            const auto i = x >= 1.0 ? 1 : 0;
+            const auto j = y >= 1.0 ? 1 : 0;
+            x -= i;
+            y -= j;
+            node = &nodes[node->children + i + 2*j];
+        }
+        return node->cell >= 0 ? &cells[node->cell] : nullptr;
+    }
+};
+
+/// Return the properties of water calculated with the equation of state at a point of a sheet of the table.
+/// The density is calculated with Newton's method from an initial guess in the phase of the sheet, falling back on the safeguarded
+/// method if it does not converge to that phase (see @ref waterTableNodeProps).
+auto waterAdaptiveExactProps(WaterThermoModel model, WaterAdaptiveSheetPhase phase, RealConstRef T, RealConstRef P) -> WaterThermoProps
+{
+    const auto R = universalGasConstant/waterMolarMass;
+
+    const auto liquid = phase == WaterAdaptiveSheetPhase::Liquid;
+
+    // The initial guess for supercritical water is not valid for the densest states near the critical temperature
+    const auto Dsat = waterDensitySaturationGuess(T, P, liquid ? StateOfMatter::Liquid : StateOfMatter::Gas);
+    const auto D0 = std::isfinite(Dsat) && Dsat > 0.0 ? Dsat : P/(R*T);
+
+    WaterThermoProps wtp;
+    withWaterIsotherm(model, T, [&](const auto& helmholtz, const auto& helmholtziter) { wtp = waterTableNodeProps(helmholtz, helmholtziter, T, P, D0, liquid); });
+    return wtp;
+}
+
+} // namespace
+
+struct WaterAdaptiveTable::Impl
+{
+    /// The options used to construct the table.
+    WaterAdaptiveTableOptions options;
+
+    /// The saturation curve of the equation of state, whose pressures bound the liquid and vapor sheets.
+    const WaterSaturationCurve* curve;
+
+    /// The liquid, vapor and supercritical sheets of the table.
+    std::vector<WaterAdaptiveSheet> sheets;
+
+    /// The pressure coordinate of the lowest and highest pressures of the table.
+    Real umin, umax;
+
+    /// The specific gas constant of the ideal-gas limit of the equation of state (in units of J/(kg*K)), whose terms in log(P) are removed from the stored properties.
+    Real gasconstant;
+
+    /// Construct a WaterAdaptiveTable::Impl instance.
+    Impl(const WaterAdaptiveTableOptions& options)
+    : options(options), curve(&waterSaturationCurve(options.model))
+    {
+        const auto Tc = waterCriticalTemperature;
+
+        error(!(options.Tmin < Tc - critical_gap && options.Tmax > Tc),
+            "The temperatures of an adaptive water table must range from below to above the critical temperature of water.");
+        error(!(options.Pmin > 0.0 && options.Pmax > waterCriticalPressure),
+            "The pressures of an adaptive water table must be positive and range above the critical pressure of water.");
+        error(!(options.Pmin < curve->pressure(options.Tmin)),
+            "The lowest pressure of an adaptive water table must be below the saturation pressure of water at its lowest temperature.");
+        error(!(options.tolerance > 0.0 && options.min_depth <= options.max_depth && options.max_depth <= 15),
+            "The tolerance of an adaptive water table must be positive, and its maximum depth at least its minimum depth and at most 15.");
+
+        // The ideal-gas limit of the equation of state, whose gas constant differs slightly from that of the molar mass of water
+        const auto ideal = waterAdaptiveExactProps(options.model, WaterAdaptiveSheetPhase::Supercritical, 1000.0, 1.0);
+        gasconstant = ideal.pressure/(ideal.density*ideal.temperature);
+
+        umin = waterTableCoordinate(options.Pmin);
+        umax = waterTableCoordinate(options.Pmax);
+
+        sheets.emplace_back(WaterAdaptiveSheetPhase::Liquid, options.Tmin, Tc - critical_gap);
+        sheets.emplace_back(WaterAdaptiveSheetPhase::Vapor, options.Tmin, Tc - critical_gap);
+        sheets.emplace_back(WaterAdaptiveSheetPhase::Supercritical, Tc, options.Tmax);
+
+        for(auto& sheet : sheets)
+            build(sheet);
+    }
+
+    /// Return the pressure coordinate of the lowest and highest pressures of a sheet at given temperature.
+    auto coordinateRange(const WaterAdaptiveSheet& sheet, RealConstRef T) const -> std::array<Real, 2>
+    {
+        switch(sheet.phase) {
+        case WaterAdaptiveSheetPhase::Liquid: return { waterTableCoordinate(curve->pressure(T)), umax };
+        case WaterAdaptiveSheetPhase::Vapor: return { umin, waterTableCoordinate(curve->pressure(T)) };
+        default: return { umin, umax };
+        }
+    }
+
+    /// Calculate the properties stored in the table at given coordinates in a sheet with the equation of state.
+    auto sample(const WaterAdaptiveSheet& sheet, RealConstRef x, RealConstRef y) const -> WaterAdaptiveSample
+    {
+        const auto T = sheet.Tmin + x*(sheet.Tmax - sheet.Tmin);
+        const auto Ts = sheet.phase == WaterAdaptiveSheetPhase::Supercritical ? std::max(T, waterCriticalTemperature + 1e-6) : T; // avoid the single-phase boundary at the critical temperature
+        const auto [ua, ub] = coordinateRange(sheet, T);
+        const auto P = std::exp(ua + y*(ub - ua)) - waterTablePressureShift;
+
+        WaterAdaptiveSample res;
+        std::fill(std::begin(res.values), std::end(res.values), std::numeric_limits<Real>::quiet_NaN());
+
+        const auto wtp = waterAdaptiveExactProps(options.model, sheet.phase, Ts, P);
+        if(std::isfinite(wtp.density) && wtp.density > 0.0)
+            waterTableFields(sheet.phase == WaterAdaptiveSheetPhase::Liquid, wtp, res.values, gasconstant);
+
+        return res;
+    }
+
+    /// Calculate the check points of a cell of a sheet, and decide whether the cell is interpolated, subdivided, or calculated with the equation of state.
+    auto check(const WaterAdaptiveSheet& sheet, const WaterAdaptivePendingCell& pending) const -> WaterAdaptiveOutcome
+    {
+        const auto R = universalGasConstant/waterMolarMass;
+        const auto h = std::ldexp(1.0, -static_cast<int>(pending.depth)); // the size of the cell in the sheet
+
+        WaterAdaptiveOutcome outcome;
+
+        // The grid of 7x7 points of the cell, whose even points are the interpolation points and whose odd points are the check points
+        WaterAdaptiveSample grid[7][7];
+
+        const auto calculate = [&](std::size_t i, std::size_t j)
+        {
+            grid[i][j] = sample(sheet, pending.x0 + h*i/6, pending.y0 + h*j/6);
+            ++outcome.evaluations;
+        };
+
+        for(std::size_t i = 0; i < 4; ++i)
+            for(std::size_t j = 0; j < 4; ++j)
+                grid[2*i][2*j] = pending.samples[i][j];
+
+        for(std::size_t i = 1; i < 7; i += 2)
+            for(std::size_t j = 1; j < 7; j += 2)
+                calculate(i, j);
+
+        // The coefficients of the polynomials, from the values at the interpolation points along each direction
+        auto& cell = outcome.cell;
+        for(std::size_t k = 0; k < num_fields; ++k)
+        {
+            Real temp[4][4] = {};
+            for(std::size_t a = 0; a < 4; ++a)
+                for(std::size_t j = 0; j < 4; ++j)
+                    for(std::size_t i = 0; i < 4; ++i)
+                        temp[a][j] += power_basis[a][i] * grid[2*i][2*j].values[k];
+
+            for(std::size_t a = 0; a < 4; ++a)
+                for(std::size_t b = 0; b < 4; ++b)
+                {
+                    auto& coefficient = cell.coefficients[4*a + b][k];
+                    coefficient = 0.0;
+                    for(std::size_t j = 0; j < 4; ++j)
+                        coefficient += power_basis[b][j] * temp[a][j];
+                }
+        }
+
+        // The largest error at the check points, which is NaN if the equation of state failed at any point
+        Real maxerror = 0.0;
+        for(std::size_t i = 1; i < 7; i += 2)
+            for(std::size_t j = 1; j < 7; j += 2)
+            {
+                const auto T = sheet.Tmin + (pending.x0 + h*i/6)*(sheet.Tmax - sheet.Tmin);
+                const auto& expected = grid[i][j].values;
+
+                Real values[num_fields];
+                cell.evaluate(i/6.0, j/6.0, values);
+
+                const Real scales[num_fields] = { 1.0, R*T, R, std::abs(expected[3]), 1.0, 1.0, 1.0, 1.0, 1.0 };
+
+                for(std::size_t k = 0; k < num_fields; ++k)
+                {
+                    const auto scale = k < 4 ? scales[k] : std::max(std::abs(expected[k]), 1.0);
+                    maxerror = std::max(maxerror, std::abs(values[k] - expected[k])/scale);
+                    if(std::isnan(values[k] - expected[k]))
+                        maxerror = std::numeric_limits<Real>::quiet_NaN();
+                }
+            }
+
+        const auto accurate = maxerror <= options.tolerance;
+
+        if(accurate && pending.depth >= options.min_depth)
+        {
+            outcome.kind = WaterAdaptiveOutcome::Interpolated;
+            return outcome;
+        }
+
+        if(pending.depth >= options.max_depth)
+        {
+            outcome.kind = WaterAdaptiveOutcome::Unresolved;
+            return outcome;
+        }
+
+        // The points of the grid that are neither interpolation nor check points, needed for the interpolation points of the children
+        for(std::size_t i = 0; i < 7; ++i)
+            for(std::size_t j = (i + 1) % 2; j < 7; j += 2)
+                calculate(i, j);
+
+        outcome.kind = WaterAdaptiveOutcome::Subdivided;
+        outcome.children.resize(4);
+
+        for(std::size_t c = 0; c < 4; ++c)
+        {
+            const auto a = c % 2, b = c / 2;
+            auto& child = outcome.children[c];
+            child.depth = pending.depth + 1;
+            child.x0 = pending.x0 + 0.5*h*a;
+            child.y0 = pending.y0 + 0.5*h*b;
+            for(std::size_t i = 0; i < 4; ++i)
+                for(std::size_t j = 0; j < 4; ++j)
+                    child.samples[i][j] = grid[3*a + i][3*b + j];
+        }
+
+        return outcome;
+    }
+
+    /// Construct the quadtree of a sheet, subdividing the cells of each depth in parallel.
+    auto build(WaterAdaptiveSheet& sheet) -> void
+    {
+        std::vector<WaterAdaptivePendingCell> pending(1);
+        pending[0].node = 0;
+        pending[0].depth = 0;
+        pending[0].x0 = pending[0].y0 = 0.0;
+        for(std::size_t i = 0; i < 4; ++i)
+            for(std::size_t j = 0; j < 4; ++j)
+                pending[0].samples[i][j] = sample(sheet, i/3.0, j/3.0);
+
+        sheet.nodes.resize(1);
+        sheet.evaluations = 16;
+
+        while(!pending.empty())
+        {
+            std::vector<WaterAdaptiveOutcome> outcomes(pending.size());
+            waterTableParallelFor(pending.size(), options.threads, [&](std::size_t c) { outcomes[c] = check(sheet, pending[c]); });
+
+            // The children of the subdivided cells are appended in order, so that the quadtree is stored in breadth-first order
+            std::vector<WaterAdaptivePendingCell> children;
+
+            for(std::size_t c = 0; c < pending.size(); ++c)
+            {
+                auto& node = sheet.nodes[pending[c].node];
+                auto& outcome = outcomes[c];
+
+                sheet.evaluations += outcome.evaluations;
+
+                switch(outcome.kind) {
+                case WaterAdaptiveOutcome::Interpolated:
+                    node.cell = static_cast<std::int32_t>(sheet.cells.size());
+                    sheet.cells.push_back(outcome.cell);
+                    sheet.depth = std::max(sheet.depth, pending[c].depth);
+                    break;
+                case WaterAdaptiveOutcome::Unresolved:
+                    ++sheet.unresolved;
+                    sheet.depth = std::max(sheet.depth, pending[c].depth);
+                    break;
+                default:
+                    node.children = static_cast<std::int32_t>(sheet.nodes.size());
+                    for(auto& child : outcome.children)
+                    {
+                        child.node = sheet.nodes.size();
+                        sheet.nodes.emplace_back();
+                        children.push_back(child);
+                    }
+                }
+            }
+
+            pending = std::move(children);
+        }
+
+        sheet.nodes.shrink_to_fit();
+        sheet.cells.shrink_to_fit();
+    }
+
+    /// The result of the look-up of a state in the table.
+    struct Lookup
+    {
+        /// The sheet of the state, or null if the state is outside the table.
+        const WaterAdaptiveSheet* sheet = nullptr;
+
+        /// The cell of the state, or null if its properties are calculated with the equation of state.
+        const WaterAdaptiveCell* cell = nullptr;
+
+        /// The coordinates of the state in its cell.
+        Real x = 0.0, y = 0.0;
+    };
+
+    /// Return the sheet and cell of the table that contain a state of given temperature and pressure.
+    auto find(RealConstRef T, RealConstRef P) const -> Lookup
+    {
+        const auto Tc = waterCriticalTemperature;
+
+        Lookup res;
+
+        if(!(T >= options.Tmin && T <= options.Tmax && P >= options.Pmin && P <= options.Pmax))
+            return res;
+
+        if(T > Tc - critical_gap && T < Tc)
+            return res;
+
+        const auto u = waterTableCoordinate(P);
+
+        if(T >= Tc)
+        {
+            res.sheet = &sheets[2];
+            res.y = (u - umin)/(umax - umin);
+        }
+        else
+        {
+            const auto Psat = curve->pressure(T);
+
+            if(std::abs(P/Psat - 1.0) < saturation_gap)
+                return res;
+
+            const auto usat = waterTableCoordinate(Psat);
+
+            if(P > Psat)
+            {
+                res.sheet = &sheets[0];
+                res.y = (u - usat)/(umax - usat);
+            }
+            else
+            {
+                res.sheet = &sheets[1];
+                res.y = (u - umin)/(usat - umin);
+            }
+        }
+
+        const auto& sheet = *res.sheet;
+        res.x = std::min(std::max((T - sheet.Tmin)/(sheet.Tmax - sheet.Tmin), 0.0), 1.0);
+        res.y = std::min(std::max(res.y, 0.0), 1.0);
+        res.cell = sheet.find(res.x, res.y);
+
+        return res;
+    }
+
+    /// Return the thermodynamic properties of water interpolated in a cell of the table.
+    auto interpolate(const Lookup& lookup, RealConstRef T, RealConstRef P) const -> WaterThermoProps
+    {
+        Real values[num_fields];
+        lookup.cell->evaluate(lookup.x, lookup.y, values);
+        return waterTableProps(lookup.sheet->phase == WaterAdaptiveSheetPhase::Liquid, T, P, values, gasconstant);
+    }
+};
+
+WaterAdaptiveTable::WaterAdaptiveTable(const WaterAdaptiveTableOptions& options)
+: pimpl(new Impl(options))
+{}
+
+WaterAdaptiveTable::WaterAdaptiveTable(const WaterAdaptiveTable& other)
+: pimpl(new Impl(*other.pimpl))
+{}
+
+WaterAdaptiveTable::~WaterAdaptiveTable()
+{}
+
+auto WaterAdaptiveTable::operator=(WaterAdaptiveTable other) -> WaterAdaptiveTable&
+{
+    pimpl = std::move(other.pimpl);
+    return *this;
+}
+
+auto WaterAdaptiveTable::options() const -> const WaterAdaptiveTableOptions&
+{
+    return pimpl->options;
+}
+
+auto WaterAdaptiveTable::nodes() const -> std::size_t
+{
+    std::size_t res = 0;
+    for(const auto& sheet : pimpl->sheets)
+        res += sheet.nodes.size();
+    return res;
+}
+
+auto WaterAdaptiveTable::cells() const -> std::size_t
+{
+    std::size_t res = 0;
+    for(const auto& sheet : pimpl->sheets)
+        res += sheet.cells.size();
+    return res;
+}
+
+auto WaterAdaptiveTable::unresolvedCells() const -> std::size_t
+{
+    std::size_t res = 0;
+    for(const auto& sheet : pimpl->sheets)
+        res += sheet.unresolved;
+    return res;
+}
+
+auto WaterAdaptiveTable::depth() const -> std::size_t
+{
+    std::size_t res = 0;
+    for(const auto& sheet : pimpl->sheets)
+        res = std::max(res, sheet.depth);
+    return res;
+}
+
+auto WaterAdaptiveTable::evaluations() const -> std::size_t
+{
+    std::size_t res = 0;
+    for(const auto& sheet : pimpl->sheets)
+        res += sheet.evaluations;
+    return res;
+}
+
+auto WaterAdaptiveTable::memoryUsage() const -> std::size_t
+{
+    std::size_t res = sizeof(Impl);
+    for(const auto& sheet : pimpl->sheets)
+        res += sizeof(WaterAdaptiveSheet) + sheet.nodes.capacity() * sizeof(WaterAdaptiveNode) + sheet.cells.capacity() * sizeof(WaterAdaptiveCell);
+    return res;
+}
+
+auto WaterAdaptiveTable::contains(RealConstRef T, RealConstRef P) const -> bool
+{
+    return pimpl->find(T, P).cell != nullptr;
+}
+
+auto WaterAdaptiveTable::props(RealConstRef T, RealConstRef P) const -> WaterThermoProps
+{
+    const auto lookup = pimpl->find(T, P);
+
+    if(!lookup.cell)
+        return pimpl->options.model == WaterThermoModel::HGK ? waterThermoPropsHGK(T, P) : waterThermoPropsWagnerPruss(T, P);
+
+    return pimpl->interpolate(lookup, T, P);
+}
+
+auto WaterAdaptiveTable::props(RealConstRef T, RealConstRef P, StateOfMatter stateofmatter) const -> WaterThermoProps
+{
+    const auto lookup = pimpl->find(T, P);
+
+    const auto liquid = stateofmatter == StateOfMatter::Liquid || stateofmatter == StateOfMatter::Solid;
+    const auto metastable = lookup.sheet && ((lookup.sheet->phase == WaterAdaptiveSheetPhase::Liquid && !liquid) || (lookup.sheet->phase == WaterAdaptiveSheetPhase::Vapor && liquid));
+
+    if(!lookup.cell || metastable)
+        return pimpl->options.model == WaterThermoModel::HGK ? waterThermoPropsHGK(T, P, stateofmatter) : waterThermoPropsWagnerPruss(T, P, stateofmatter);
+
+    return pimpl->interpolate(lookup, T, P);
+}
+
+auto waterAdaptiveTable(WaterThermoModel model) -> const WaterAdaptiveTable&
+{
+    if(model == WaterThermoModel::HGK)
+    {
+        static const WaterAdaptiveTable table({ WaterThermoModel::HGK });
+        return table;
+    }
+
+    static const WaterAdaptiveTable table({ WaterThermoModel::WagnerPruss });
+    return table;
+}
+
+} // namespace Fluidika
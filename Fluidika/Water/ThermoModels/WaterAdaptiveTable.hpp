@@ -0,0 +1,166 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// C++ includes
+#include <cstddef>
+#include <memory>
+
+// Fluidika includes
+#include <Fluidika/Common/Real.hpp>
+#include <Fluidika/Common/StateOfMatter.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+
+namespace Fluidika {
+
+// Forward declarations
+struct WaterThermoProps;
+
+/// The options for the construction of a @ref WaterAdaptiveTable.
+struct WaterAdaptiveTableOptions
+{
+    /// The equation of state of water used to calculate the properties of the table
+    WaterThermoModel model = WaterThermoModel::WagnerPruss;
+
+    /// The lowest temperature of the table (in units of K)
+    Real Tmin = 273.16;
+
+    /// The highest temperature of the table (in units of K)
+    Real Tmax = 1273.0;
+
+    /// The lowest pressure of the table (in units of Pa), which must be below the saturation pressure at the lowest temperature
+    Real Pmin = 100.0;
+
+    /// The highest pressure of the table (in units of Pa)
+    Real Pmax = 1.0e+09;
+
+    /// The largest error of the interpolated properties at the check points of each cell (see @ref WaterAdaptiveTable)
+    Real tolerance = 1e-6;
+
+    /// The depth down to which all cells are subdivided, regardless of their errors
+    std::size_t min_depth = 3;
+
+    /// The depth beyond which cells are not subdivided, and whose properties are calculated with the equation of state if their errors exceed the tolerance
+    std::size_t max_depth = 12;
+
+    /// The number of threads used to construct the table, or zero to use all hardware threads
+    std::size_t threads = 0;
+};
+
+/// Used to calculate the thermodynamic properties of water with an adaptive table of an equation of state of water.
+/// The table is made of three sheets, one per phase: liquid and vapor below the critical temperature, and supercritical water
+/// above it. Each sheet spans a rectangle of temperature and of a pressure coordinate, log(P + 1 MPa), scaled at each
+/// temperature between its lowest and highest pressures in the sheet, which are the saturation pressures of the liquid and
+/// vapor sheets, so that no cell crosses the saturation curve. The saturation pressure is that of @ref waterSaturationCurve.
+///
+/// Each sheet is a quadtree of cells, which are recursively subdivided into four until the bicubic polynomials that interpolate
+/// the properties of water at 4x4 uniformly spaced points of the cell agree with the equation of state at the 3x3 check
+/// points between them to within the tolerance. The properties are the density, the Helmholtz free energy, the entropy, the
+/// isochoric heat capacity and the first and second partial derivatives of pressure, transformed so that they vary slowly
+/// as in @ref WaterSplineTable, from which all other properties are calculated consistently. The errors are relative in
+/// density and isochoric heat capacity, and taken with respect to R*T, R, and the values for an ideal gas for the Helmholtz
+/// free energy, entropy, and partial derivatives of pressure. The interpolation points of the four cells of a subdivided cell
+/// are among its 7x7 interpolation and check points, so that checking a cell costs nine evaluations of the equation of state
+/// and subdividing it 24 more. The cells that do not satisfy the tolerance at the maximum depth, which are close to the critical
+/// point, are calculated with the equation of state, as are the states outside the table, those within a relative 1e-7 of the
+/// saturation pressure, and those between the highest temperature of the liquid and vapor sheets, 1e-3 K below the critical
+/// temperature, and the critical temperature.
+///
+/// The quadtrees are flattened into arrays of nodes in breadth-first order, in which the four children of a node are
+/// contiguous, and the coefficients of the polynomials of the cells are stored contiguously in another array, so that a
+/// look-up descends through a few nodes of 8 bytes and then reads the 1152 bytes of a single cell.
+///
+/// With the default options, the table of Wagner and Pruss (2002) has 38747 nodes, of which 26642 are interpolated cells and
+/// 2419 are calculated with the equation of state, uses 31 MB, and is constructed with 581235 evaluations of the equation of
+/// state in about 3 s on a single thread (that of HGK is about as large, and constructed in about 1 s). Its density, energies,
+/// entropy, heat capacities and speed of sound agree with the equation of state within 1e-6 (relative), its first derivatives
+/// within 2e-6, and its second derivatives of density within 3e-5, while only about 3e-5 of the states in the table are
+/// calculated with the equation of state. A look-up takes about 200 ns, which is 10-15 times faster than the equation of
+/// state of Wagner and Pruss (2002) and about 5 times faster than that of HGK.
+///
+/// The phase of a state below the critical temperature is that of the saturation curve of the equation of state, which for HGK
+/// may differ from that of @ref waterThermoPropsHGK between the saturation pressures of HGK and Wagner and Pruss (2002),
+/// whose initial guess for density follows the latter.
+/// @see waterAdaptiveTable
+class WaterAdaptiveTable
+{
+public:
+    /// Construct a WaterAdaptiveTable instance.
+    /// @param options The options for the construction of the table
+    explicit WaterAdaptiveTable(const WaterAdaptiveTableOptions& options = {});
+
+    /// Construct a copy of a WaterAdaptiveTable instance.
+    WaterAdaptiveTable(const WaterAdaptiveTable& other);
+
+    /// Destroy this WaterAdaptiveTable instance.
+    ~WaterAdaptiveTable();
+
+    /// Assign a copy of a WaterAdaptiveTable instance to this.
+    auto operator=(WaterAdaptiveTable other) -> WaterAdaptiveTable&;
+
+    /// Return the options used to construct the table.
+    auto options() const -> const WaterAdaptiveTableOptions&;
+
+    /// Return the number of nodes of the quadtrees of the table, including their cells.
+    auto nodes() const -> std::size_t;
+
+    /// Return the number of cells of the table whose properties are interpolated.
+    auto cells() const -> std::size_t;
+
+    /// Return the number of cells of the table whose properties are calculated with the equation of state.
+    auto unresolvedCells() const -> std::size_t;
+
+    /// Return the largest depth of the cells of the table.
+    auto depth() const -> std::size_t;
+
+    /// Return the number of evaluations of the equation of state used to construct the table.
+    auto evaluations() const -> std::size_t;
+
+    /// Return the memory used by the nodes and cells of the table (in units of bytes).
+    auto memoryUsage() const -> std::size_t;
+
+    /// Return true if the properties of water at given temperature and pressure are interpolated in the table.
+    /// @param T The temperature of water (in units of K)
+    /// @param P The pressure of water (in units of Pa)
+    auto contains(RealConstRef T, RealConstRef P) const -> bool;
+
+    /// Calculate the thermodynamic properties of water at given temperature and pressure.
+    /// @param T The temperature of water (in units of K)
+    /// @param P The pressure of water (in units of Pa)
+    auto props(RealConstRef T, RealConstRef P) const -> WaterThermoProps;
+
+    /// Calculate the thermodynamic properties of water at given temperature and pressure and specific state of matter for water.
+    /// Metastable states, whose state of matter is not that of the side of the saturation curve of given pressure, are
+    /// calculated with the equation of state as for states outside the table.
+    /// @param T The temperature of water (in units of K)
+    /// @param P The pressure of water (in units of Pa)
+    /// @param stateofmatter The state of matter of water
+    auto props(RealConstRef T, RealConstRef P, StateOfMatter stateofmatter) const -> WaterThermoProps;
+
+private:
+    struct Impl;
+
+    std::unique_ptr<Impl> pimpl;
+};
+
+/// Return the adaptive table of thermodynamic properties of water of a given equation of state using the default options.
+/// The table of each model is constructed on the first call, once even if several threads call this method at the same time.
+/// @param model The equation of state of water
+auto waterAdaptiveTable(WaterThermoModel model = WaterThermoModel::WagnerPruss) -> const WaterAdaptiveTable&;
+
+} // namespace Fluidika
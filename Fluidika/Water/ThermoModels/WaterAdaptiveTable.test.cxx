@@ -0,0 +1,209 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+// C++ includes
+#include <utility>
+
+// Catch includes
+#include <catch2/catch.hpp>
+
+// Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Water/ThermoModels/HGK.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
+#include <Fluidika/Water/ThermoModels/WaterAdaptiveTable.hpp>
+#include <Fluidika/Water/ThermoModels/WaterSaturationCurve.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+using namespace Fluidika;
+
+TEST_CASE("Fluidika::WaterThermoModels::WaterAdaptiveTable", "[WaterAdaptiveTable]")
+{
+    // A smaller and coarser table than the default one, which is constructed faster (and only once for all sections)
+    WaterAdaptiveTableOptions options;
+    options.Tmax = 900.0;
+    options.Pmax = 1e+08;
+    options.tolerance = 1e-5;
+    options.max_depth = 9;
+    options.threads = 2;
+
+    static const WaterAdaptiveTable table(options);
+
+    const auto R = universalGasConstant/waterMolarMass;
+
+    SECTION("when the table is constructed")
+    {
+        REQUIRE(table.options().Tmax == 900.0);
+        REQUIRE(table.depth() >= options.min_depth);
+        REQUIRE(table.depth() <= options.max_depth);
+
+        // The three quadtrees have a root each, and the nodes of the subdivided nodes have four children each
+        REQUIRE((table.nodes() - 3) % 4 == 0);
+        REQUIRE(table.nodes() > table.cells() + table.unresolvedCells());
+        REQUIRE(table.unresolvedCells() > 0);
+        REQUIRE(table.unresolvedCells() < table.cells());
+        REQUIRE(table.memoryUsage() > table.cells() * 144 * sizeof(Real));
+        REQUIRE(table.evaluations() > 9 * (table.cells() + table.unresolvedCells()));
+
+        REQUIRE(table.contains(300.0, 1e+05));
+        REQUIRE(table.contains(800.0, 5e+07));
+        REQUIRE_FALSE(table.contains(1000.0, 1e+05));
+        REQUIRE_FALSE(table.contains(300.0, 2e+08));
+        REQUIRE_FALSE(table.contains(300.0, 50.0));
+        REQUIRE_FALSE(table.contains(waterCriticalTemperature, waterCriticalPressure));
+        REQUIRE_FALSE(table.contains(waterCriticalTemperature - 5e-4, 5e+07));
+
+        WaterAdaptiveTableOptions invalid;
+        invalid.Tmax = 600.0;
+        REQUIRE_THROWS(WaterAdaptiveTable(invalid));
+
+        invalid = {};
+        invalid.Pmin = 1e+04;
+        REQUIRE_THROWS(WaterAdaptiveTable(invalid));
+
+        invalid = {};
+        invalid.min_depth = 5;
+        invalid.max_depth = 4;
+        REQUIRE_THROWS(WaterAdaptiveTable(invalid));
+    }
+
+    SECTION("when states in the table are interpolated")
+    {
+        for(auto T = 275.3; T < 900.0; T += 13.7)
+        {
+            for(auto P = 137.0; P < 1e+08; P *= 2.13)
+            {
+                if(!table.contains(T, P))
+                    continue;
+
+                const auto expected = waterThermoPropsWagnerPruss(T, P);
+                const auto wtp = table.props(T, P);
+
+                REQUIRE(wtp.temperature == T);
+                REQUIRE(wtp.pressure == Approx(P).epsilon(1e-14));
+                REQUIRE(wtp.density == Approx(expected.density).epsilon(2e-5));
+                REQUIRE(wtp.entropy == Approx(expected.entropy).epsilon(1e-5).margin(1e-5*R));
+                REQUIRE(wtp.enthalpy == Approx(expected.enthalpy).epsilon(1e-5).margin(1e-5*R*T));
+                REQUIRE(wtp.cv == Approx(expected.cv).epsilon(2e-5));
+                REQUIRE(wtp.cp == Approx(expected.cp).epsilon(5e-5));
+                REQUIRE(wtp.speed_of_sound == Approx(expected.speed_of_sound).epsilon(5e-5));
+                REQUIRE(wtp.densityP == Approx(expected.densityP).epsilon(5e-5));
+            }
+        }
+    }
+
+    SECTION("when states next to the saturation curve are interpolated")
+    {
+        for(auto T : { 300.0, 450.0, 600.0 })
+        {
+            const auto sat = waterSaturationPropsWagnerPruss(T);
+
+            REQUIRE(table.props(T, sat.pressure*(1 + 1e-6)).density == Approx(sat.density_liquid).epsilon(1e-5));
+            REQUIRE(table.props(T, sat.pressure*(1 - 1e-6)).density == Approx(sat.density_vapor).epsilon(1e-5));
+
+            // The states closer to the saturation curve than its interpolation error are calculated with the equation of state
+            REQUIRE_FALSE(table.contains(T, sat.pressure*(1 + 1e-8)));
+            REQUIRE(table.props(T, sat.pressure*(1 - 1e-8)).density == waterThermoPropsWagnerPruss(T, sat.pressure*(1 - 1e-8)).density);
+        }
+    }
+
+    SECTION("when states outside the table are calculated")
+    {
+        // The states outside the table, or in its unresolved cells around the critical point, are calculated with the equation of state
+        for(auto [T, P] : { std::pair{ 1000.0, 1e+05 }, std::pair{ 300.0, 2e+08 }, std::pair{ 300.0, 50.0 }, std::pair{ 647.2, 2.21e+07 } })
+        {
+            REQUIRE_FALSE(table.contains(T, P));
+            REQUIRE(table.props(T, P).density == waterThermoPropsWagnerPruss(T, P).density);
+            REQUIRE(table.props(T, P).cp == waterThermoPropsWagnerPruss(T, P).cp);
+        }
+    }
+
+    SECTION("when the state of matter of water is given")
+    {
+        // Liquid water at 400 K and 1 bar is metastable, since its saturation pressure is about 2.5 bar
+        const auto T = 400.0;
+        const auto P = 1e+05;
+
+        REQUIRE(table.props(T, P, StateOfMatter::Gas).density == table.props(T, P).density);
+        REQUIRE(table.props(T, P, StateOfMatter::Liquid).density == waterThermoPropsWagnerPruss(T, P, StateOfMatter::Liquid).density);
+        REQUIRE(table.props(T, P, StateOfMatter::Liquid).density > 900.0);
+        REQUIRE(table.props(T, 1e+07, StateOfMatter::Liquid).density == table.props(T, 1e+07).density);
+    }
+
+    SECTION("when a table of the HGK equation of state is constructed")
+    {
+        options.model = WaterThermoModel::HGK;
+
+        const WaterAdaptiveTable hgk(options);
+
+        REQUIRE(hgk.options().model == WaterThermoModel::HGK);
+
+        const auto& curve = waterSaturationCurve(WaterThermoModel::HGK);
+
+        for(auto T = 281.7; T < 900.0; T += 29.3)
+        {
+            for(auto P = 213.0; P < 1e+08; P *= 3.7)
+            {
+                if(!hgk.contains(T, P))
+                    continue;
+
+                // The phase of the states is that of the saturation curve of HGK
+                const auto stateofmatter = T < waterCriticalTemperature && P < curve.pressure(T) ? StateOfMatter::Gas : StateOfMatter::Liquid;
+                const auto expected = T < waterCriticalTemperature ? waterThermoPropsHGK(T, P, stateofmatter) : waterThermoPropsHGK(T, P);
+                const auto wtp = hgk.props(T, P);
+
+                REQUIRE(wtp.density == Approx(expected.density).epsilon(2e-5));
+                REQUIRE(wtp.enthalpy == Approx(expected.enthalpy).epsilon(1e-5).margin(1e-5*R*T));
+                REQUIRE(wtp.cp == Approx(expected.cp).epsilon(5e-5));
+            }
+        }
+
+        REQUIRE(hgk.props(1000.0, 1e+05).density == waterThermoPropsHGK(1000.0, 1e+05).density);
+    }
+
+    SECTION("when a table is copied")
+    {
+        // Copies of the table interpolate the same properties
+        WaterAdaptiveTable copy = table;
+        REQUIRE(copy.nodes() == table.nodes());
+        REQUIRE(copy.cells() == table.cells());
+        REQUIRE(copy.props(500.0, 1e+04).entropy == table.props(500.0, 1e+04).entropy);
+
+        WaterAdaptiveTableOptions coarse = options;
+        coarse.tolerance = 1e-3;
+        copy = WaterAdaptiveTable(coarse);
+        REQUIRE(copy.cells() < table.cells());
+        REQUIRE(copy.props(500.0, 1e+04).density == Approx(table.props(500.0, 1e+04).density).epsilon(1e-3));
+    }
+
+    SECTION("when a table is constructed with the solver counters enabled")
+    {
+        // The states calculated with the equation of state during the construction are not counted
+        WaterAdaptiveTableOptions coarse = options;
+        coarse.tolerance = 1e-3;
+
+        resetWaterSolverCounters();
+        enableWaterSolverCounters(true);
+        const WaterAdaptiveTable coarsetable(coarse);
+        const auto counters = waterSolverCounters();
+        enableWaterSolverCounters(false);
+        resetWaterSolverCounters();
+
+        REQUIRE(coarsetable.evaluations() > 0);
+        REQUIRE(counters.calls == 0);
+    }
+}
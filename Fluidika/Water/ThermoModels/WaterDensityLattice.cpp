@@ -0,0 +1,302 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "WaterDensityLattice.hpp"
+
+// C++ includes
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+// Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Common/Exception.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
+#include <Fluidika/Water/ThermoModels/WaterTableBuilder.hpp>
+#include <Fluidika/Water/WaterData.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+
+namespace Fluidika {
+
+namespace {
+
+using namespace internal;
+
+/// The number of nodes along each side of the square tiles of a sheet.
+constexpr std::size_t tile_size = 4;
+
+/// The range of the logarithm of pressure in the vapor sheet, below the saturation pressure (six orders of magnitude).
+const auto vapor_log_pressure_range = 6.0*std::log(10.0);
+
+/// The nodes of a square tile of a sheet, stored in a cache line.
+struct alignas(64) WaterDensityTile
+{
+    float values[tile_size][tile_size];
+};
+
+/// The phases of water covered by the sheets of the lattice.
+enum class WaterDensitySheetPhase
+{
+    Liquid, Vapor, Supercritical
+};
+
+/// A sheet of the lattice, uniform in temperature and in the logarithm of pressure.
+/// The nodes store the logarithm of density in the liquid sheet, and the logarithm of D*T/P (which is constant for an
+/// ideal gas) in the vapor and supercritical sheets, both of which vary slowly along the temperatures and pressures of the sheet.
+struct WaterDensitySheet
+{
+    /// The phase of water covered by the sheet.
+    WaterDensitySheetPhase phase;
+
+    /// The lowest temperature of the sheet (in units of K)
+    Real Tmin;
+
+    /// The spacing between the temperatures of the sheet (in units of K)
+    Real dT;
+
+    /// The number of temperatures of the sheet.
+    std::size_t nT;
+
+    /// The number of pressures of the sheet at each temperature.
+    std::size_t nP;
+
+    /// The number of tiles along the pressures of the sheet.
+    std::size_t ntilesP;
+
+    /// The logarithm of the lowest and highest pressures of the lattice.
+    Real lnPmin, lnPmax;
+
+    /// The tiles of nodes of the sheet.
+    std::vector<WaterDensityTile> tiles;
+
+    /// Construct a WaterDensitySheet object.
+    WaterDensitySheet(WaterDensitySheetPhase phase, RealConstRef Tmin, RealConstRef Tmax, const WaterDensityLatticeOptions& options)
+    : phase(phase), Tmin(Tmin)
+    {
+        nT = std::max<std::size_t>(std::ceil((Tmax - Tmin)/options.temperature_step), 1) + 1;
+        nP = std::max<std::size_t>(options.pressure_points, 2);
+        dT = (Tmax - Tmin)/(nT - 1);
+        ntilesP = (nP + tile_size - 1)/tile_size;
+        lnPmin = std::log(options.Pmin);
+        lnPmax = std::log(options.Pmax);
+        tiles.resize((nT + tile_size - 1)/tile_size * ntilesP);
+    }
+
+    /// Return the value stored at a node of the sheet.
+    auto node(std::size_t i, std::size_t j) -> float&
+    {
+        return tiles[i/tile_size*ntilesP + j/tile_size].values[i%tile_size][j%tile_size];
+    }
+
+    /// Return the value stored at a node of the sheet.
+    auto node(std::size_t i, std::size_t j) const -> float
+    {
+        return tiles[i/tile_size*ntilesP + j/tile_size].values[i%tile_size][j%tile_size];
+    }
+
+    /// Return the logarithm of the lowest and highest pressures of the sheet at given temperature.
+    /// @param lnPsat The logarithm of the saturation pressure at the temperature (not used in the supercritical sheet)
+    auto logPressureRange(RealConstRef lnPsat) const -> std::array<Real, 2>
+    {
+        switch(phase) {
+        case WaterDensitySheetPhase::Liquid: return {lnPsat, std::max(lnPmax, lnPsat + 1.0)};
+        case WaterDensitySheetPhase::Vapor: return {lnPsat - vapor_log_pressure_range, lnPsat};
+        default: return {lnPmin, lnPmax};
+        }
+    }
+
+    /// Return the density of water corresponding to a value stored in the sheet.
+    auto density(RealConstRef value, RealConstRef T, RealConstRef P) const -> Real
+    {
+        return phase == WaterDensitySheetPhase::Liquid ? std::exp(value) : std::exp(value)*P/T;
+    }
+
+    /// Return the value stored in the sheet corresponding to a density of water.
+    auto value(RealConstRef D, RealConstRef T, RealConstRef P) const -> Real
+    {
+        return phase == WaterDensitySheetPhase::Liquid ? std::log(D) : std::log(D*T/P);
+    }
+
+    /// Return the predicted density of water at given temperature and pressure, interpolated bilinearly among the nodes of the sheet.
+    auto predict(RealConstRef T, RealConstRef P, RealConstRef lnPsat) const -> Real
+    {
+        const auto [lnPa, lnPb] = logPressureRange(lnPsat);
+        const auto x = std::min(std::max((T - Tmin)/dT, 0.0), nT - 1.0);
+        const auto y = std::min(std::max((std::log(P) - lnPa)/(lnPb - lnPa)*(nP - 1), 0.0), nP - 1.0);
+        const auto i = std::min<std::size_t>(x, nT - 2);
+        const auto j = std::min<std::size_t>(y, nP - 2);
+        const auto wx = x - i;
+        const auto wy = y - j;
+        const auto v0 = node(i, j) + wy*(node(i, j + 1) - node(i, j));
+        const auto v1 = node(i + 1, j) + wy*(node(i + 1, j + 1) - node(i + 1, j));
+        return density(v0 + wx*(v1 - v0), T, P);
+    }
+
+    /// Calculate the nodes of the sheet at a temperature using given Helmholtz functions of water at that temperature.
+    template<typename Model, typename ModelIter>
+    auto calculate(std::size_t i, const Model& model, const ModelIter& modeliter) -> void
+    {
+        // Avoid the single-phase boundary of the sheets at the critical temperature
+        const auto T = phase == WaterDensitySheetPhase::Supercritical ?
+            std::max(Tmin + i*dT, waterCriticalTemperature + 1e-6) :
+            std::min(Tmin + i*dT, waterCriticalTemperature - 1e-6);
+
+        const auto Psat = phase == WaterDensitySheetPhase::Supercritical ? 0.0 : waterPressureSaturatedStateWagnerPruss(T);
+        const auto [lnPa, lnPb] = logPressureRange(Psat > 0.0 ? std::log(Psat) : 0.0);
+
+        // The densities along the pressures start next to the saturation curve for liquid, and from the lowest pressure otherwise,
+        // so that the liquid densities start on the liquid side, and the vapor and supercritical densities from an almost ideal gas
+        const auto liquid = phase == WaterDensitySheetPhase::Liquid;
+        const auto R = universalGasConstant/waterMolarMass;
+
+        Real D = 0.0, Pprev = 0.0;
+
+        for(std::size_t j = 0; j < nP; ++j)
+        {
+            auto P = std::exp(lnPa + (lnPb - lnPa)*j/(nP - 1));
+            if(phase == WaterDensitySheetPhase::Vapor)
+                P = std::min(P, Psat*(1.0 - 1e-9)); // keep the last pressure on the vapor side of the saturation curve
+
+            const auto D0 = j == 0 ?
+                (liquid ? waterDensitySaturatedLiquidStateWagnerPruss(T) : P/(R*T)) :
+                (liquid ? D : D*P/Pprev);
+
+            D = waterTableNodeProps(model, modeliter, T, P, D0, liquid).density;
+            Pprev = P;
+
+            node(i, j) = value(D, T, P);
+        }
+    }
+};
+
+/// Whether the lattice is used in the initial guesses for density.
+std::atomic<bool> lattice_enabled{false};
+
+} // namespace
+
+struct WaterDensityLattice::Impl
+{
+    /// The equation of state of water.
+    WaterThermoModel model;
+
+    /// The options used to construct the lattice.
+    WaterDensityLatticeOptions options;
+
+    /// The liquid, vapor and supercritical sheets of the lattice.
+    std::vector<WaterDensitySheet> sheets;
+
+    /// Construct a WaterDensityLattice::Impl instance.
+    Impl(WaterThermoModel model, const WaterDensityLatticeOptions& options)
+    : model(model), options(options)
+    {
+        error(!(options.Tmin < waterCriticalTemperature && options.Tmax > waterCriticalTemperature),
+            "The temperatures of a water density lattice must range from below to above the critical temperature of water.");
+        error(!(options.Pmin > 0.0 && options.Pmax > options.Pmin && options.temperature_step > 0.0),
+            "The pressures of a water density lattice must be positive and increasing, and its temperature step positive.");
+
+        const auto Tc = waterCriticalTemperature;
+        sheets.emplace_back(WaterDensitySheetPhase::Liquid, options.Tmin, Tc, options);
+        sheets.emplace_back(WaterDensitySheetPhase::Vapor, options.Tmin, Tc, options);
+        sheets.emplace_back(WaterDensitySheetPhase::Supercritical, Tc, options.Tmax, options);
+
+        // The columns of nodes at each temperature of each sheet are calculated independently
+        waterTableCalculateColumns(sheets, options.threads, [&](WaterDensitySheet& sheet, std::size_t i)
+        {
+            withWaterIsotherm(model, sheet.Tmin + i*sheet.dT, [&](const auto& helmholtz, const auto& helmholtziter) { sheet.calculate(i, helmholtz, helmholtziter); });
+        });
+    }
+};
+
+WaterDensityLattice::WaterDensityLattice(WaterThermoModel model, const WaterDensityLatticeOptions& options)
+: pimpl(new Impl(model, options))
+{}
+
+WaterDensityLattice::WaterDensityLattice(const WaterDensityLattice& other)
+: pimpl(new Impl(*other.pimpl))
+{}
+
+WaterDensityLattice::~WaterDensityLattice()
+{}
+
+auto WaterDensityLattice::operator=(WaterDensityLattice other) -> WaterDensityLattice&
+{
+    pimpl = std::move(other.pimpl);
+    return *this;
+}
+
+auto WaterDensityLattice::model() const -> WaterThermoModel
+{
+    return pimpl->model;
+}
+
+auto WaterDensityLattice::options() const -> const WaterDensityLatticeOptions&
+{
+    return pimpl->options;
+}
+
+auto WaterDensityLattice::size() const -> std::size_t
+{
+    std::size_t res = 0;
+    for(const auto& sheet : pimpl->sheets)
+        res += sheet.nT * sheet.nP;
+    return res;
+}
+
+auto WaterDensityLattice::memoryUsage() const -> std::size_t
+{
+    std::size_t res = sizeof(Impl);
+    for(const auto& sheet : pimpl->sheets)
+        res += sizeof(WaterDensitySheet) + sheet.tiles.capacity() * sizeof(WaterDensityTile);
+    return res;
+}
+
+auto WaterDensityLattice::density(RealConstRef T, RealConstRef P) const -> Real
+{
+    const auto& sheets = pimpl->sheets;
+
+    // The nodes cannot be located for states whose logarithm of pressure is not finite, which are left to the interpolation in Table 13.2
+    if(!(std::isfinite(T) && std::isfinite(P) && T > 0.0 && P > 0.0))
+        return waterThermoDataInterpolatedDensityWagnerPruss(T, P);
+
+    if(T >= waterCriticalTemperature)
+        return sheets[2].predict(T, P, 0.0);
+
+    const auto Psat = waterPressureSaturatedStateWagnerPruss(T);
+    const auto& sheet = P >= Psat ? sheets[0] : sheets[1];
+    return sheet.predict(T, P, std::log(Psat));
+}
+
+auto enableWaterDensityLattice(bool enable) -> void
+{
+    lattice_enabled.store(enable, std::memory_order_relaxed);
+}
+
+auto waterDensityLatticeEnabled() -> bool
+{
+    return lattice_enabled.load(std::memory_order_relaxed);
+}
+
+auto waterDensityLattice() -> const WaterDensityLattice&
+{
+    static const WaterDensityLattice lattice;
+    return lattice;
+}
+
+} // namespace Fluidika
@@ -0,0 +1,123 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// C++ includes
+#include <cstddef>
+#include <memory>
+
+// Fluidika includes
+#include <Fluidika/Common/Real.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+
+namespace Fluidika {
+
+/// The options for the construction of a @ref WaterDensityLattice.
+struct WaterDensityLatticeOptions
+{
+    /// The lowest temperature of the lattice (in units of K)
+    Real Tmin = 250.0;
+
+    /// The highest temperature of the lattice (in units of K)
+    Real Tmax = 1273.0;
+
+    /// The lowest pressure of the lattice above the critical temperature (in units of Pa)
+    Real Pmin = 100.0;
+
+    /// The highest pressure of the lattice (in units of Pa)
+    Real Pmax = 1.0e+09;
+
+    /// The largest spacing between the temperatures of the lattice (in units of K)
+    Real temperature_step = 1.0;
+
+    /// The number of pressures of the lattice at each temperature of each of its sheets
+    std::size_t pressure_points = 512;
+
+    /// The number of threads used to construct the lattice, or zero to use all hardware threads
+    std::size_t threads = 0;
+};
+
+/// Used to predict the density of water from a dense lattice of densities calculated with an equation of state.
+/// The lattice is made of three sheets of nodes, uniform in temperature and in the logarithm of pressure, with one sheet
+/// per phase: liquid and vapor below the critical temperature, and supercritical water above it. The pressures of the
+/// liquid and vapor sheets range from and up to the saturation pressure respectively, so that each lies entirely on its
+/// side of the saturation curve and no prediction ever interpolates between liquid and vapor densities. The vapor sheet
+/// covers six orders of magnitude of pressure below the saturation pressure, below which water vapor is an ideal gas.
+///
+/// The density at each node is calculated with the Newton iterations, started from the density at the previous node of
+/// the same temperature. The temperatures are divided among several threads. Predictions interpolate the nodes bilinearly
+/// and are usually within 1e-4 of the density of the equation of state (except close to the critical point), so that
+/// most calculations started from them need a single Newton correction. The nodes are stored in single precision, in
+/// square tiles of 4x4 nodes that fit a cache line, so that the four nodes around most states are in the same cache line.
+/// @see waterDensityLattice, enableWaterDensityLattice
+class WaterDensityLattice
+{
+public:
+    /// Construct a WaterDensityLattice instance.
+    /// @param model The equation of state of water
+    /// @param options The options for the construction of the lattice
+    explicit WaterDensityLattice(WaterThermoModel model = WaterThermoModel::WagnerPruss, const WaterDensityLatticeOptions& options = {});
+
+    /// Construct a copy of a WaterDensityLattice instance.
+    WaterDensityLattice(const WaterDensityLattice& other);
+
+    /// Destroy this WaterDensityLattice instance.
+    ~WaterDensityLattice();
+
+    /// Assign a copy of a WaterDensityLattice instance to this.
+    auto operator=(WaterDensityLattice other) -> WaterDensityLattice&;
+
+    /// Return the equation of state of water used to calculate the densities of the lattice.
+    auto model() const -> WaterThermoModel;
+
+    /// Return the options used to construct the lattice.
+    auto options() const -> const WaterDensityLatticeOptions&;
+
+    /// Return the number of nodes of the lattice in all its sheets.
+    auto size() const -> std::size_t;
+
+    /// Return the memory used by the nodes of the lattice (in units of bytes).
+    auto memoryUsage() const -> std::size_t;
+
+    /// Return the predicted density of water at given temperature and pressure.
+    /// States outside the lattice are predicted from its closest nodes, with the density of vapor and supercritical water
+    /// below the lowest pressure of the lattice scaled as that of an ideal gas. Non-finite or non-positive temperatures and
+    /// pressures yield the density of @ref waterThermoDataInterpolatedDensityWagnerPruss instead.
+    /// @param T The temperature of water (in units of K)
+    /// @param P The pressure of water (in units of Pa)
+    /// @return The predicted density of water (in units of kg/m3)
+    auto density(RealConstRef T, RealConstRef P) const -> Real;
+
+private:
+    struct Impl;
+
+    std::unique_ptr<Impl> pimpl;
+};
+
+/// Enable or disable the use of the lattice returned by @ref waterDensityLattice in @ref waterDensityInitialGuess, which is disabled by default.
+/// The lattice is only constructed, using all hardware threads, when its first initial guess is needed.
+auto enableWaterDensityLattice(bool enable) -> void;
+
+/// Return true if the lattice returned by @ref waterDensityLattice is used in @ref waterDensityInitialGuess.
+auto waterDensityLatticeEnabled() -> bool;
+
+/// Return the lattice of densities of water calculated with the Wagner and Pruss (2002) equation of state using the default options.
+/// The lattice is constructed on the first call, once even if several threads call this method at the same time.
+auto waterDensityLattice() -> const WaterDensityLattice&;
+
+} // namespace Fluidika
@@ -0,0 +1,133 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+// C++ includes
+#include <cmath>
+#include <limits>
+#include <utility>
+
+// Catch includes
+#include <catch2/catch.hpp>
+
+// Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Water/ThermoModels/HGK.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
+#include <Fluidika/Water/ThermoModels/WaterDensityLattice.hpp>
+#include <Fluidika/Water/WaterData.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+using namespace Fluidika;
+
+TEST_CASE("Fluidika::WaterThermoModels::WaterDensityLattice", "[WaterDensityLattice]")
+{
+    // A coarser lattice than the default one, which is faster to construct
+    WaterDensityLatticeOptions options;
+    options.temperature_step = 2.0;
+    options.pressure_points = 128;
+    options.threads = 2;
+
+    const auto solve = [&](WaterThermoModel model, RealConstRef T, RealConstRef P, RealConstRef D0)
+    {
+        return model == WaterThermoModel::HGK ?
+            waterThermoPropsHGK(T, P, D0, WaterDensityMethod::Safeguarded) :
+            waterThermoPropsWagnerPruss(T, P, D0, WaterDensityMethod::Safeguarded);
+    };
+
+    SECTION("when the lattice is constructed")
+    {
+        for(auto model : { WaterThermoModel::WagnerPruss, WaterThermoModel::HGK })
+        {
+            const WaterDensityLattice lattice(model, options);
+
+            REQUIRE(lattice.model() == model);
+            REQUIRE(lattice.options().pressure_points == options.pressure_points);
+            REQUIRE(lattice.size() > 0);
+            REQUIRE(lattice.memoryUsage() >= lattice.size() * sizeof(float));
+
+            // The lattice is the same whatever the number of threads used to construct it
+            auto serial = options;
+            serial.threads = 1;
+            const WaterDensityLattice other(model, serial);
+
+            REQUIRE(other.size() == lattice.size());
+            for(auto T : { 260.0, 300.0, 500.0, 640.0, 700.0, 1200.0 })
+                for(auto P : { 1e3, 1e5, 1e7, 1e9 })
+                    REQUIRE(other.density(T, P) == lattice.density(T, P));
+        }
+    }
+
+    SECTION("when densities are predicted")
+    {
+        for(auto model : { WaterThermoModel::WagnerPruss, WaterThermoModel::HGK })
+        {
+            const WaterDensityLattice lattice(model, options);
+
+            for(auto item : waterThermoDataSinglePhaseStateWagnerPruss())
+            {
+                const auto T = item.temperature;
+                const auto P = item.pressure;
+
+                // Skip the states on the saturation curve, whose phase cannot be determined from temperature and pressure
+                if(T < waterCriticalTemperature && std::abs(P/waterPressureSaturatedStateWagnerPruss(T) - 1.0) < 1e-4)
+                    continue;
+
+                const auto D0 = lattice.density(T, P);
+
+                // The predictions lie on the same side of the saturation curve as the state
+                if(T < waterCriticalTemperature)
+                    REQUIRE((D0 > waterCriticalDensity) == (item.density > waterCriticalDensity));
+
+                // The predictions of this coarse lattice are close to the density of the equation of state, except close to the critical point
+                const auto D = solve(model, T, P, D0).density;
+                const auto critical = std::abs(T/waterCriticalTemperature - 1.0) < 0.1 && P < 2.5*waterCriticalPressure;
+                const auto epsilon = critical ? 0.1 : 1e-2;
+
+                REQUIRE(D0 == Approx(D).epsilon(epsilon));
+            }
+
+            // The states of vapor below the lowest pressure of the lattice are predicted as those of an ideal gas
+            REQUIRE(lattice.density(300.0, 1e-6) == Approx(lattice.density(300.0, 1e-5) / 10).epsilon(1e-12));
+
+            // The states whose pressure coordinate is not defined are predicted as the initial guesses without the lattice
+            const auto nan = std::numeric_limits<Real>::quiet_NaN();
+            const auto inf = std::numeric_limits<Real>::infinity();
+            for(auto [T, P] : { std::pair{ 300.0, -1e5 }, std::pair{ 300.0, 0.0 }, std::pair{ nan, 1e5 }, std::pair{ 300.0, nan }, std::pair{ inf, 1e5 } })
+            {
+                const auto D0 = lattice.density(T, P);
+                const auto expected = waterThermoDataInterpolatedDensityWagnerPruss(T, P);
+                REQUIRE(((D0 == expected) || (std::isnan(D0) && std::isnan(expected))));
+            }
+        }
+    }
+
+    SECTION("when the lattice is enabled for the initial guesses")
+    {
+        REQUIRE(waterDensityLatticeEnabled() == false);
+
+        enableWaterDensityLattice(true);
+        REQUIRE(waterDensityLatticeEnabled() == true);
+
+        // The initial guesses are then the densities of the lattice
+        for(auto T : { 300.0, 500.0, 640.0, 700.0, 1200.0 })
+            for(auto P : { 1e3, 1e5, 1e7, 1e9 })
+                REQUIRE(waterDensityInitialGuess(T, P) == waterDensityLattice().density(T, P));
+
+        enableWaterDensityLattice(false);
+        REQUIRE(waterDensityLatticeEnabled() == false);
+    }
+}
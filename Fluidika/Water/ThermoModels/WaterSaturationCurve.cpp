@@ -0,0 +1,351 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "WaterSaturationCurve.hpp"
+
+// C++ includes
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Common/Exception.hpp>
+#include <Fluidika/Water/ThermoModels/HGK.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/ThermoModels/UtilsGeneric.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+
+namespace Fluidika {
+
+namespace {
+
+/// The distance between the highest temperature of the knots and the critical temperature of water (in units of K).
+const auto critical_gap = 1.0e-03;
+
+/// The coefficients of a cubic polynomial in the position between the knots of an interval of the spline, in ascending powers.
+using WaterSaturationCubic = std::array<Real, 4>;
+
+/// The cubic polynomials of an interval of the spline.
+struct WaterSaturationInterval
+{
+    /// The polynomial of the logarithm of the saturation pressure.
+    WaterSaturationCubic lnP;
+
+    /// The polynomial of the density of saturated liquid water.
+    WaterSaturationCubic Dl;
+
+    /// The polynomial of the logarithm of the density of saturated vapor water.
+    WaterSaturationCubic lnDv;
+};
+
+/// Return the cubic Hermite polynomial in [0, 1] with given values and derivatives at both ends.
+auto hermite(Real f0, Real d0, Real f1, Real d1) -> WaterSaturationCubic
+{
+    return { f0, d0, 3*(f1 - f0) - 2*d0 - d1, 2*(f0 - f1) + d0 + d1 };
+}
+
+/// Return the value of a cubic polynomial at a given position.
+auto value(const WaterSaturationCubic& c, Real t) -> Real
+{
+    return c[0] + t*(c[1] + t*(c[2] + t*c[3]));
+}
+
+/// Return the derivative of a cubic polynomial at a given position.
+auto slope(const WaterSaturationCubic& c, Real t) -> Real
+{
+    return c[1] + t*(2*c[2] + 3*t*c[3]);
+}
+
+/// Calculate the properties of water at saturation with a given equation of state and initial guesses for the saturated densities, without warnings.
+auto waterSaturationPropsNewton(WaterThermoModel model, RealConstRef T, RealConstRef Dl0, RealConstRef Dv0, WaterSolverResult& result) -> WaterSaturationProps
+{
+    if(model == WaterThermoModel::HGK)
+    {
+        const HGKIsotherm isotherm(T);
+        const auto helmholtz = [&](RealConstRef, RealConstRef D) { return isotherm.evaluate<2>(D); };
+        return generic::waterSaturationPropsNewton(helmholtz, T, Dl0, Dv0, result);
+    }
+
+    const WagnerPrussIsotherm isotherm(T);
+    const auto helmholtz = [&](RealConstRef, RealConstRef D) { return isotherm.evaluate<2>(D); };
+    return generic::waterSaturationPropsNewton(helmholtz, T, Dl0, Dv0, result);
+}
+
+} // namespace
+
+struct WaterSaturationCurve::Impl
+{
+    /// The equation of state of water.
+    WaterThermoModel model;
+
+    /// The cube root of the distance between the lowest temperature of the knots and the critical temperature.
+    Real u0;
+
+    /// The spacing of the knots in the cube root of the distance to the critical temperature.
+    Real h;
+
+    /// The cubic polynomials of the intervals between consecutive knots.
+    std::vector<WaterSaturationInterval> intervals;
+
+    /// The logarithms of the saturation pressures at the knots, in ascending order.
+    std::vector<Real> lnP;
+
+    /// The properties of water at saturation at the first and last knots.
+    WaterSaturationProps first, last;
+
+    /// Construct a WaterSaturationCurve::Impl instance.
+    Impl(WaterThermoModel model, std::size_t knots)
+    : model(model)
+    {
+        using std::cbrt;
+        using std::log;
+
+        error(knots < 2, "Cannot construct a saturation curve of water with less than two knots.");
+
+        u0 = cbrt(waterCriticalTemperature - waterTriplePointTemperature);
+        h = (u0 - cbrt(critical_gap))/(knots - 1);
+
+        std::vector<Real> T(knots);
+        for(std::size_t k = 0; k < knots; ++k)
+        {
+            const auto u = u0 - k*h;
+            T[k] = waterCriticalTemperature - u*u*u;
+        }
+
+        // The knots are in ascending order of temperature, so that the batch solver extrapolates the initial guesses of each knot from the previous one
+        std::vector<WaterSaturationProps> props(knots);
+        std::vector<WaterSolverStatus> status(knots);
+
+        if(model == WaterThermoModel::HGK)
+            waterSaturationPropsHGKBatch(knots, T.data(), props.data(), status.data());
+        else waterSaturationPropsWagnerPrussBatch(knots, T.data(), props.data(), status.data());
+
+        for(std::size_t k = 0; k < knots; ++k)
+            error(status[k] != WaterSolverStatus::Converged, "Cannot construct the saturation curve of water because the calculation at temperature ", T[k], " K did not converge.");
+
+        // The derivatives with respect to the position between two knots, which changes the cube root of the distance to the critical temperature by -h
+        const auto slopes = [&](const WaterSaturationProps& s)
+        {
+            const auto u = cbrt(waterCriticalTemperature - s.temperature);
+            const auto dTdt = 3*u*u*h;
+            return std::array<Real, 3>{ s.pressureT/s.pressure*dTdt, s.density_liquidT*dTdt, s.density_vaporT/s.density_vapor*dTdt };
+        };
+
+        intervals.resize(knots - 1);
+        lnP.resize(knots);
+
+        for(std::size_t k = 0; k < knots; ++k)
+            lnP[k] = log(props[k].pressure);
+
+        for(std::size_t k = 0; k + 1 < knots; ++k)
+        {
+            const auto& a = props[k];
+            const auto& b = props[k + 1];
+            const auto da = slopes(a);
+            const auto db = slopes(b);
+
+            intervals[k].lnP  = hermite(lnP[k], da[0], lnP[k + 1], db[0]);
+            intervals[k].Dl   = hermite(a.density_liquid, da[1], b.density_liquid, db[1]);
+            intervals[k].lnDv = hermite(log(a.density_vapor), da[2], log(b.density_vapor), db[2]);
+        }
+
+        first = props.front();
+        last = props.back();
+    }
+
+    /// Return true if a temperature is within the knots.
+    auto inside(RealConstRef T) const -> bool
+    {
+        return T >= first.temperature && T <= last.temperature;
+    }
+
+    /// Return the interval that contains a temperature within the knots and the position of the temperature in it.
+    auto locate(RealConstRef T) const -> std::pair<std::size_t, Real>
+    {
+        const auto s = (u0 - std::cbrt(waterCriticalTemperature - T))/h;
+        const auto i = std::min(static_cast<std::size_t>(std::max(s, 0.0)), intervals.size() - 1);
+        return { i, s - i };
+    }
+
+    /// Calculate the properties of water at saturation at a temperature outside the knots, with initial guesses extrapolated from the closest knot.
+    auto solve(RealConstRef T) const -> WaterSaturationProps
+    {
+        const auto& end = T < first.temperature ? first : last;
+        const auto dT = T - end.temperature;
+        const auto Dl0 = end.density_liquid + end.density_liquidT*dT;
+        const auto Dv0 = end.density_vapor * std::exp(end.density_vaporT/end.density_vapor*dT);
+
+        WaterSolverResult result;
+        const auto res = waterSaturationPropsNewton(model, T, Dl0, Dv0, result);
+
+        if(result.status == WaterSolverStatus::Converged)
+            return res;
+
+        return model == WaterThermoModel::HGK ? waterSaturationPropsHGK(T) : waterSaturationPropsWagnerPruss(T);
+    }
+};
+
+WaterSaturationCurve::WaterSaturationCurve(WaterThermoModel model, std::size_t knots)
+: pimpl(new Impl(model, knots))
+{}
+
+WaterSaturationCurve::WaterSaturationCurve(const WaterSaturationCurve& other)
+: pimpl(new Impl(*other.pimpl))
+{}
+
+WaterSaturationCurve::~WaterSaturationCurve()
+{}
+
+auto WaterSaturationCurve::operator=(WaterSaturationCurve other) -> WaterSaturationCurve&
+{
+    pimpl = std::move(other.pimpl);
+    return *this;
+}
+
+auto WaterSaturationCurve::model() const -> WaterThermoModel
+{
+    return pimpl->model;
+}
+
+auto WaterSaturationCurve::size() const -> std::size_t
+{
+    return pimpl->lnP.size();
+}
+
+auto WaterSaturationCurve::minTemperature() const -> Real
+{
+    return pimpl->first.temperature;
+}
+
+auto WaterSaturationCurve::maxTemperature() const -> Real
+{
+    return pimpl->last.temperature;
+}
+
+auto WaterSaturationCurve::props(RealConstRef T) const -> WaterSaturationProps
+{
+    if(!pimpl->inside(T))
+        return pimpl->solve(T);
+
+    const auto [i, t] = pimpl->locate(T);
+    const auto& c = pimpl->intervals[i];
+
+    // The derivative of the position in the interval with respect to temperature
+    const auto u = pimpl->u0 - (i + t)*pimpl->h;
+    const auto dtdT = 1/(3*u*u*pimpl->h);
+
+    WaterSaturationProps res;
+    res.temperature     = T;
+    res.pressure        = std::exp(value(c.lnP, t));
+    res.pressureT       = res.pressure * slope(c.lnP, t)*dtdT;
+    res.density_liquid  = value(c.Dl, t);
+    res.density_liquidT = slope(c.Dl, t)*dtdT;
+    res.density_vapor   = std::exp(value(c.lnDv, t));
+    res.density_vaporT  = res.density_vapor * slope(c.lnDv, t)*dtdT;
+    return res;
+}
+
+auto WaterSaturationCurve::pressure(RealConstRef T) const -> Real
+{
+    if(!pimpl->inside(T))
+        return pimpl->solve(T).pressure;
+
+    const auto [i, t] = pimpl->locate(T);
+    return std::exp(value(pimpl->intervals[i].lnP, t));
+}
+
+auto WaterSaturationCurve::temperature(RealConstRef P) const -> Real
+{
+    using std::abs;
+    using std::log;
+
+    const auto& lnP = pimpl->lnP;
+    const auto y = log(P);
+
+    if(y >= lnP.front() && y <= lnP.back())
+    {
+        // The interval whose knots bracket the pressure, in which the cubic polynomial of the logarithm of pressure is monotonic
+        const auto k = std::upper_bound(lnP.begin(), lnP.end(), y) - lnP.begin();
+        const auto i = std::min<std::size_t>(k - 1, pimpl->intervals.size() - 1);
+        const auto& c = pimpl->intervals[i].lnP;
+
+        auto t = (y - lnP[i])/(lnP[i + 1] - lnP[i]);
+        for(int iter = 0; iter < 10; ++iter)
+        {
+            const auto dt = (value(c, t) - y)/slope(c, t);
+            t = std::clamp(t - dt, 0.0, 1.0);
+            if(abs(dt) < 1e-14)
+                break;
+        }
+
+        const auto u = pimpl->u0 - (i + t)*pimpl->h;
+        return waterCriticalTemperature - u*u*u;
+    }
+
+    // Apply Newton's method to the logarithm of the saturation pressure calculated with the saturation solver, keeping the temperatures below the critical one
+    Real T = y < lnP.front() ? pimpl->first.temperature : pimpl->last.temperature;
+    for(int iter = 0; iter < 50; ++iter)
+    {
+        const auto s = pimpl->solve(T);
+        if(!(s.pressure > 0))
+            break;
+        const auto dT = (log(s.pressure) - y)/(s.pressureT/s.pressure);
+        const auto Tnew = T - dT;
+        T = Tnew < waterCriticalTemperature ? Tnew : (T + waterCriticalTemperature)/2;
+        if(abs(dT) < 1e-12*T)
+            return T;
+    }
+
+    return std::numeric_limits<Real>::quiet_NaN();
+}
+
+auto WaterSaturationCurve::densityLiquid(RealConstRef T) const -> Real
+{
+    if(!pimpl->inside(T))
+        return pimpl->solve(T).density_liquid;
+
+    const auto [i, t] = pimpl->locate(T);
+    return value(pimpl->intervals[i].Dl, t);
+}
+
+auto WaterSaturationCurve::densityVapor(RealConstRef T) const -> Real
+{
+    if(!pimpl->inside(T))
+        return pimpl->solve(T).density_vapor;
+
+    const auto [i, t] = pimpl->locate(T);
+    return std::exp(value(pimpl->intervals[i].lnDv, t));
+}
+
+auto waterSaturationCurve(WaterThermoModel model) -> const WaterSaturationCurve&
+{
+    if(model == WaterThermoModel::HGK)
+    {
+        static const WaterSaturationCurve curve(WaterThermoModel::HGK);
+        return curve;
+    }
+
+    static const WaterSaturationCurve curve(WaterThermoModel::WagnerPruss);
+    return curve;
+}
+
+} // namespace Fluidika
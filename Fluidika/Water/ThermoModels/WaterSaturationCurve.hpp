@@ -0,0 +1,108 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// C++ includes
+#include <cstddef>
+#include <memory>
+
+// Fluidika includes
+#include <Fluidika/Common/Real.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+
+namespace Fluidika {
+
+// Forward declarations
+struct WaterSaturationProps;
+
+/// Used to evaluate the saturation curve of water with a spline of the saturation states calculated with an equation of state.
+/// The saturation states are calculated with @ref waterSaturationPropsWagnerPruss or @ref waterSaturationPropsHGK at knots
+/// from the triple point up to 1e-3 K below the critical temperature. The knots are uniform in the cube root of the distance
+/// to the critical temperature, which removes most of the curvature of the saturated densities close to the critical point.
+/// Between two knots, the logarithm of the saturation pressure, the density of saturated liquid and the logarithm of the
+/// density of saturated vapor are cubic Hermite polynomials matching the values and the derivatives along the saturation
+/// curve at both knots, so that the spline and its first derivatives are continuous. With the default number of knots, the
+/// spline agrees with the saturation solver to within about 1e-9 in pressure and densities and 1e-7 in their derivatives,
+/// to within about 1e-7 in densities in the last 0.1 K below the critical temperature, and the saturation temperature at
+/// given pressure to within about 1e-8 K. The saturated liquid density of HGK changes abruptly close to 646.7 K, where the
+/// model has a spurious loop close to its critical point, and the spline deviates there by up to about 4e-3 in liquid density.
+/// Temperatures outside the knots are calculated with the saturation solver.
+/// @see waterSaturationCurve
+class WaterSaturationCurve
+{
+public:
+    /// Construct a WaterSaturationCurve instance.
+    /// @param model The equation of state of water
+    /// @param knots The number of knots of the spline
+    explicit WaterSaturationCurve(WaterThermoModel model = WaterThermoModel::WagnerPruss, std::size_t knots = 1024);
+
+    /// Construct a copy of a WaterSaturationCurve instance.
+    WaterSaturationCurve(const WaterSaturationCurve& other);
+
+    /// Destroy this WaterSaturationCurve instance.
+    ~WaterSaturationCurve();
+
+    /// Assign a copy of a WaterSaturationCurve instance to this.
+    auto operator=(WaterSaturationCurve other) -> WaterSaturationCurve&;
+
+    /// Return the equation of state of water used to calculate the saturation states of the spline.
+    auto model() const -> WaterThermoModel;
+
+    /// Return the number of knots of the spline.
+    auto size() const -> std::size_t;
+
+    /// Return the lowest temperature of the knots of the spline (in units of K).
+    auto minTemperature() const -> Real;
+
+    /// Return the highest temperature of the knots of the spline (in units of K).
+    auto maxTemperature() const -> Real;
+
+    /// Return the properties of water at saturation at given temperature.
+    /// @param T The temperature of water (in units of K), which must be below the critical temperature
+    auto props(RealConstRef T) const -> WaterSaturationProps;
+
+    /// Return the saturation pressure of water at given temperature (in units of Pa).
+    /// @param T The temperature of water (in units of K), which must be below the critical temperature
+    auto pressure(RealConstRef T) const -> Real;
+
+    /// Return the saturation temperature of water at given pressure (in units of K).
+    /// Within the knots, the temperature is found with Newton iterations on the spline of the interval that contains the
+    /// pressure, and otherwise with Newton iterations on the saturation solver. Pressures above that of the critical point yield NaN.
+    /// @param P The pressure of water (in units of Pa)
+    auto temperature(RealConstRef P) const -> Real;
+
+    /// Return the density of saturated liquid water at given temperature (in units of kg/m3).
+    /// @param T The temperature of water (in units of K), which must be below the critical temperature
+    auto densityLiquid(RealConstRef T) const -> Real;
+
+    /// Return the density of saturated vapor water at given temperature (in units of kg/m3).
+    /// @param T The temperature of water (in units of K), which must be below the critical temperature
+    auto densityVapor(RealConstRef T) const -> Real;
+
+private:
+    struct Impl;
+
+    std::unique_ptr<Impl> pimpl;
+};
+
+/// Return the saturation curve of water calculated with a given equation of state using the default number of knots.
+/// The curve of each model is constructed on the first call, once even if several threads call this method at the same time.
+/// @param model The equation of state of water
+auto waterSaturationCurve(WaterThermoModel model = WaterThermoModel::WagnerPruss) -> const WaterSaturationCurve&;
+
+} // namespace Fluidika
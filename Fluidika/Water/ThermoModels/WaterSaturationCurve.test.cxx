@@ -0,0 +1,103 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+// C++ includes
+#include <cmath>
+
+// Catch includes
+#include <catch2/catch.hpp>
+
+// Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Water/ThermoModels/HGK.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
+#include <Fluidika/Water/ThermoModels/WaterSaturationCurve.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+using namespace Fluidika;
+
+TEST_CASE("Fluidika::WaterThermoModels::WaterSaturationCurve", "[WaterSaturationCurve]")
+{
+    for(auto model : { WaterThermoModel::WagnerPruss, WaterThermoModel::HGK })
+    {
+        const auto& curve = waterSaturationCurve(model);
+
+        // The sections are named after the model, so that Catch runs them for each model
+        const auto name = model == WaterThermoModel::HGK ? "HGK" : "WagnerPruss";
+
+        const auto solve = [&](RealConstRef T)
+        {
+            return model == WaterThermoModel::HGK ? waterSaturationPropsHGK(T) : waterSaturationPropsWagnerPruss(T);
+        };
+
+        DYNAMIC_SECTION("when the curve is constructed for model " << name)
+        {
+            REQUIRE(curve.model() == model);
+            REQUIRE(curve.size() == 1024);
+            REQUIRE(curve.minTemperature() == Approx(waterTriplePointTemperature).epsilon(1e-12));
+            REQUIRE(curve.maxTemperature() == Approx(waterCriticalTemperature - 1e-3).epsilon(1e-12));
+            REQUIRE(&waterSaturationCurve(model) == &curve);
+        }
+
+        DYNAMIC_SECTION("when saturation states are evaluated for model " << name)
+        {
+            for(auto T = 273.5; T < waterCriticalTemperature - 0.5; T += 3.7)
+            {
+                // The saturated liquid density of HGK changes abruptly close to 646.7 K, where the model has a spurious loop, which the spline smooths
+                if(model == WaterThermoModel::HGK && std::abs(T - 646.7) < 0.3)
+                    continue;
+
+                const auto expected = solve(T);
+                const auto sat = curve.props(T);
+
+                REQUIRE(sat.temperature == T);
+                REQUIRE(sat.pressure == Approx(expected.pressure).epsilon(1e-8));
+                REQUIRE(sat.pressureT == Approx(expected.pressureT).epsilon(1e-6));
+                REQUIRE(sat.density_liquid == Approx(expected.density_liquid).epsilon(1e-8));
+                REQUIRE(sat.density_liquidT == Approx(expected.density_liquidT).epsilon(1e-5).margin(1e-5)); // the derivative vanishes close to 277 K
+                REQUIRE(sat.density_vapor == Approx(expected.density_vapor).epsilon(1e-8));
+                REQUIRE(sat.density_vaporT == Approx(expected.density_vaporT).epsilon(1e-5));
+
+                REQUIRE(curve.pressure(T) == sat.pressure);
+                REQUIRE(curve.densityLiquid(T) == sat.density_liquid);
+                REQUIRE(curve.densityVapor(T) == sat.density_vapor);
+
+                // The saturation temperature inverts the saturation pressure
+                REQUIRE(curve.temperature(sat.pressure) == Approx(T).epsilon(1e-10));
+            }
+        }
+
+        DYNAMIC_SECTION("when saturation states are evaluated outside the knots for model " << name)
+        {
+            // The states below the triple point and close to the critical point are calculated with the saturation solver
+            for(auto T : { 270.0, waterCriticalTemperature - 5e-4 })
+            {
+                const auto sat = curve.props(T);
+
+                REQUIRE(sat.pressure > 0.0);
+                REQUIRE(sat.density_liquid > sat.density_vapor);
+                REQUIRE(curve.pressure(T) == sat.pressure);
+                REQUIRE(curve.temperature(sat.pressure) == Approx(T).epsilon(1e-10));
+            }
+
+            // The initial guesses of the saturation solver differ, so the results agree to within its tolerance
+            REQUIRE(curve.props(270.0).pressure == Approx(solve(270.0).pressure).epsilon(1e-10));
+
+            // There is no saturation temperature above the critical pressure
+            REQUIRE(std::isnan(curve.temperature(2*waterCriticalPressure)));
+        }
+    }
+}
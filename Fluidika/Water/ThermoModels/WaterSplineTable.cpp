@@ -0,0 +1,458 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "WaterSplineTable.hpp"
+
+// C++ includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Common/Exception.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
+#include <Fluidika/Water/ThermoModels/WaterTableBuilder.hpp>
+#include <Fluidika/Water/ThermoModels/WaterTableFields.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+
+namespace Fluidika {
+
+namespace {
+
+using namespace internal;
+
+/// The number of properties stored at each node of the table.
+constexpr auto num_fields = waterTableNumFields;
+
+/// The gap between the highest temperature of the liquid and vapor sheets and the critical temperature (in units of K).
+constexpr Real critical_gap = 1e-3;
+
+/// The relative difference from the saturation pressure within which states are calculated with the equation of state, which exceeds the error of the interpolated saturation pressure.
+constexpr Real saturation_gap = 1e-6;
+
+/// The specific gas constant of water (in units of J/(kg*K))
+const auto R = universalGasConstant/waterMolarMass;
+
+/// A node of a sheet of the table, with the values of the stored properties and their derivatives along the sheet.
+/// The derivatives are taken with respect to the indices of the temperatures and pressures of the sheet.
+struct WaterSplineNode
+{
+    /// The values of the properties (0), and their derivatives along temperatures (1), pressures (2), and both (3).
+    Real values[4][num_fields];
+};
+
+/// The phases of water covered by the sheets of the table.
+enum class WaterSplineSheetPhase
+{
+    Liquid, Vapor, Supercritical
+};
+
+/// Return the derivative at the *i*-th of *n* uniformly spaced values with unit spacing, using fourth-order finite differences.
+/// The values are accessed with *f(k)*, and one-sided differences are used at the two first and last values.
+template<typename Function>
+auto waterSplineDerivative(std::size_t i, std::size_t n, const Function& f) -> Real
+{
+    if(i == 0) return (-25*f(0) + 48*f(1) - 36*f(2) + 16*f(3) - 3*f(4))/12;
+    if(i == 1) return (-3*f(0) - 10*f(1) + 18*f(2) - 6*f(3) + f(4))/12;
+    if(i == n - 2) return (3*f(n - 1) + 10*f(n - 2) - 18*f(n - 3) + 6*f(n - 4) - f(n - 5))/12;
+    if(i == n - 1) return (25*f(n - 1) - 48*f(n - 2) + 36*f(n - 3) - 16*f(n - 4) + 3*f(n - 5))/12;
+    return (f(i - 2) - 8*f(i - 1) + 8*f(i + 1) - f(i + 2))/12;
+}
+
+/// Return the weights of the cubic Hermite polynomials of the values and derivatives at the ends of a unit interval.
+auto waterSplineWeights(RealConstRef t) -> std::array<Real, 4>
+{
+    const auto s = 1.0 - t;
+    return {{ (1.0 + 2.0*t)*s*s, t*s*s, t*t*(3.0 - 2.0*t), -t*t*s }};
+}
+
+/// A sheet of the table, uniform in temperature and in the pressure coordinate of @ref waterTableCoordinate.
+struct WaterSplineSheet
+{
+    /// The phase of water covered by the sheet.
+    WaterSplineSheetPhase phase;
+
+    /// The lowest temperature of the sheet (in units of K)
+    Real Tmin;
+
+    /// The spacing between the temperatures of the sheet (in units of K)
+    Real dT;
+
+    /// The number of temperatures of the sheet.
+    std::size_t nT;
+
+    /// The number of pressures of the sheet at each temperature.
+    std::size_t nP;
+
+    /// The pressure coordinate of the lowest and highest pressures of the table.
+    Real umin, umax;
+
+    /// The nodes of the sheet, stored by temperature and then by pressure.
+    std::vector<WaterSplineNode> nodes;
+
+    /// Construct a WaterSplineSheet object.
+    WaterSplineSheet(WaterSplineSheetPhase phase, RealConstRef Tmin, RealConstRef Tmax, const WaterSplineTableOptions& options)
+    : phase(phase), Tmin(Tmin)
+    {
+        nT = std::max<std::size_t>(std::ceil((Tmax - Tmin)/options.temperature_step), 4) + 1;
+        nP = std::max<std::size_t>(options.pressure_points, 5);
+        dT = (Tmax - Tmin)/(nT - 1);
+        umin = waterTableCoordinate(options.Pmin);
+        umax = waterTableCoordinate(options.Pmax);
+        nodes.resize(nT * nP);
+    }
+
+    /// Return a node of the sheet.
+    auto node(std::size_t i, std::size_t j) -> WaterSplineNode&
+    {
+        return nodes[i*nP + j];
+    }
+
+    /// Return a node of the sheet.
+    auto node(std::size_t i, std::size_t j) const -> const WaterSplineNode&
+    {
+        return nodes[i*nP + j];
+    }
+
+    /// Return the temperature of the sheet with given index (in units of K).
+    auto temperature(std::size_t i) const -> Real
+    {
+        return Tmin + i*dT;
+    }
+
+    /// Return the pressure coordinate of the lowest and highest pressures of the sheet at given temperature.
+    /// @param usat The pressure coordinate of the saturation pressure at the temperature (not used in the supercritical sheet)
+    auto coordinateRange(RealConstRef usat) const -> std::array<Real, 2>
+    {
+        switch(phase) {
+        case WaterSplineSheetPhase::Liquid: return {usat, umax};
+        case WaterSplineSheetPhase::Vapor: return {umin, usat};
+        default: return {umin, umax};
+        }
+    }
+
+    /// Calculate the derivatives of the properties stored at the nodes of the sheet from their values.
+    auto differentiate() -> void
+    {
+        for(std::size_t i = 0; i < nT; ++i)
+            for(std::size_t j = 0; j < nP; ++j)
+                for(std::size_t k = 0; k < num_fields; ++k)
+                {
+                    node(i, j).values[1][k] = waterSplineDerivative(i, nT, [&](std::size_t m) { return node(m, j).values[0][k]; });
+                    node(i, j).values[2][k] = waterSplineDerivative(j, nP, [&](std::size_t m) { return node(i, m).values[0][k]; });
+                }
+
+        for(std::size_t i = 0; i < nT; ++i)
+            for(std::size_t j = 0; j < nP; ++j)
+                for(std::size_t k = 0; k < num_fields; ++k)
+                    node(i, j).values[3][k] = waterSplineDerivative(i, nT, [&](std::size_t m) { return node(m, j).values[2][k]; });
+    }
+
+    /// Return the thermodynamic properties of water at given temperature and pressure, interpolated with bicubic Hermite splines among the nodes of the sheet.
+    /// @param u The pressure coordinate of the pressure
+    /// @param usat The pressure coordinate of the saturation pressure at the temperature (not used in the supercritical sheet)
+    auto interpolate(RealConstRef T, RealConstRef P, RealConstRef u, RealConstRef usat) const -> WaterThermoProps
+    {
+        const auto [ua, ub] = coordinateRange(usat);
+        const auto x = std::min(std::max((T - Tmin)/dT, 0.0), nT - 1.0);
+        const auto y = std::min(std::max((u - ua)/(ub - ua)*(nP - 1), 0.0), nP - 1.0);
+        const auto i = std::min<std::size_t>(x, nT - 2);
+        const auto j = std::min<std::size_t>(y, nP - 2);
+        const auto wx = waterSplineWeights(x - i);
+        const auto wy = waterSplineWeights(y - j);
+
+        const auto& a = node(i, j).values;
+        const auto& b = node(i, j + 1).values;
+        const auto& c = node(i + 1, j).values;
+        const auto& d = node(i + 1, j + 1).values;
+
+        Real values[num_fields];
+
+        for(std::size_t k = 0; k < num_fields; ++k)
+        {
+            const auto fa = wy[0]*(wx[0]*a[0][k] + wx[1]*a[1][k]) + wy[1]*(wx[0]*a[2][k] + wx[1]*a[3][k]);
+            const auto fb = wy[2]*(wx[0]*b[0][k] + wx[1]*b[1][k]) + wy[3]*(wx[0]*b[2][k] + wx[1]*b[3][k]);
+            const auto fc = wy[0]*(wx[2]*c[0][k] + wx[3]*c[1][k]) + wy[1]*(wx[2]*c[2][k] + wx[3]*c[3][k]);
+            const auto fd = wy[2]*(wx[2]*d[0][k] + wx[3]*d[1][k]) + wy[3]*(wx[2]*d[2][k] + wx[3]*d[3][k]);
+            values[k] = fa + fb + fc + fd;
+        }
+
+        return waterTableProps(phase == WaterSplineSheetPhase::Liquid, T, P, values);
+    }
+
+    /// Calculate the values of the properties stored at the nodes of the sheet at a temperature.
+    /// @param sat The properties of water at saturation at the temperature (not used in the supercritical sheet)
+    auto calculate(std::size_t i, const WaterSaturationProps& sat) -> void
+    {
+        // Avoid the single-phase boundary of the supercritical sheet at the critical temperature
+        const auto T = phase == WaterSplineSheetPhase::Supercritical ? std::max(temperature(i), waterCriticalTemperature + 1e-6) : sat.temperature;
+
+        const WagnerPrussIsotherm isotherm(T);
+        const auto model = [&](RealConstRef, RealConstRef D) { return isotherm.evaluate(D); };
+        const auto modeliter = [&](RealConstRef, RealConstRef D) { return isotherm.evaluate<2>(D); };
+
+        const auto liquid = phase == WaterSplineSheetPhase::Liquid;
+        const auto vapor = phase == WaterSplineSheetPhase::Vapor;
+        const auto [ua, ub] = coordinateRange(phase == WaterSplineSheetPhase::Supercritical ? 0.0 : waterTableCoordinate(sat.pressure));
+
+        // The densities along the pressures start at the saturation curve for liquid and vapor, and from the lowest pressure for
+        // supercritical water, so that each starts from a density on the side of the sheet, and that of vapor from an almost ideal gas
+        Real D = 0.0, Pprev = 0.0;
+
+        for(std::size_t m = 0; m < nP; ++m)
+        {
+            const auto j = vapor ? nP - 1 - m : m;
+            const auto P = std::exp(ua + (ub - ua)*j/(nP - 1)) - waterTablePressureShift;
+
+            WaterThermoProps wtp;
+
+            if(m == 0 && phase != WaterSplineSheetPhase::Supercritical)
+            {
+                const auto Dsat = liquid ? sat.density_liquid : sat.density_vapor;
+                wtp = waterThermoProps(T, Dsat, model(T, Dsat)); // the saturated state of the equation of state
+            }
+            else wtp = waterTableNodeProps(model, modeliter, T, P, m == 0 ? P/(R*T) : liquid ? D : D*P/Pprev, liquid);
+
+            D = wtp.density;
+            Pprev = P;
+
+            waterTableFields(phase == WaterSplineSheetPhase::Liquid, wtp, node(i, j).values[0]);
+        }
+    }
+};
+
+} // namespace
+
+struct WaterSplineTable::Impl
+{
+    /// The options used to construct the table.
+    WaterSplineTableOptions options;
+
+    /// The liquid, vapor and supercritical sheets of the table.
+    std::vector<WaterSplineSheet> sheets;
+
+    /// The logarithm of the saturation pressure at the temperatures of the liquid and vapor sheets.
+    std::vector<Real> saturation_lnP;
+
+    /// The derivative of the logarithm of the saturation pressure with respect to temperature at the temperatures of the liquid and vapor sheets (in units of 1/K).
+    std::vector<Real> saturation_lnPT;
+
+    /// The pressure coordinate of the saturation pressure at the temperatures of the liquid and vapor sheets.
+    std::vector<Real> saturation_u;
+
+    /// The derivative of the pressure coordinate of the saturation pressure with respect to temperature at the temperatures of the liquid and vapor sheets (in units of 1/K).
+    std::vector<Real> saturation_uT;
+
+    /// Construct a WaterSplineTable::Impl instance.
+    Impl(const WaterSplineTableOptions& options)
+    : options(options)
+    {
+        const auto Tc = waterCriticalTemperature;
+
+        error(!(options.Tmin < Tc - critical_gap && options.Tmax > Tc),
+            "The temperatures of a water spline table must range from below to above the critical temperature of water.");
+        error(!(options.Pmin > 0.0 && options.Pmax > waterCriticalPressure && options.temperature_step > 0.0),
+            "The pressures of a water spline table must be positive and range above the critical pressure of water, and its temperature step positive.");
+
+        sheets.emplace_back(WaterSplineSheetPhase::Liquid, options.Tmin, Tc - critical_gap, options);
+        sheets.emplace_back(WaterSplineSheetPhase::Vapor, options.Tmin, Tc - critical_gap, options);
+        sheets.emplace_back(WaterSplineSheetPhase::Supercritical, Tc, options.Tmax, options);
+
+        // The saturation curve of the equation of state at the temperatures of the liquid and vapor sheets, calculated in ascending order
+        const auto& subcritical = sheets[0];
+
+        std::vector<Real> T(subcritical.nT);
+        for(std::size_t i = 0; i < T.size(); ++i)
+            T[i] = subcritical.temperature(i);
+
+        std::vector<WaterSaturationProps> sat(T.size());
+        std::vector<WaterSolverStatus> status(T.size());
+        waterSaturationPropsWagnerPrussBatch(T.size(), T.data(), sat.data(), status.data());
+
+        for(std::size_t i = 0; i < T.size(); ++i)
+        {
+            error(status[i] != WaterSolverStatus::Converged, "The saturation state of water at temperature ", T[i], " K of a water spline table could not be calculated.");
+            saturation_lnP.push_back(std::log(sat[i].pressure));
+            saturation_lnPT.push_back(sat[i].pressureT/sat[i].pressure);
+            saturation_u.push_back(waterTableCoordinate(sat[i].pressure));
+            saturation_uT.push_back(sat[i].pressureT/(sat[i].pressure + waterTablePressureShift));
+        }
+
+        error(!(options.Pmin < sat.front().pressure), "The lowest pressure of a water spline table must be below the saturation pressure of water at its lowest temperature.");
+
+        // The columns of nodes at each temperature of each sheet are calculated independently
+        waterTableCalculateColumns(sheets, options.threads, [&](WaterSplineSheet& sheet, std::size_t i)
+        {
+            sheet.calculate(i, sheet.phase == WaterSplineSheetPhase::Supercritical ? WaterSaturationProps{} : sat[i]);
+        });
+
+        for(auto& sheet : sheets)
+            sheet.differentiate();
+    }
+
+    /// Return the sheet of the table whose nodes are interpolated for given temperature and pressure, or null if the properties of water are calculated with the equation of state.
+    /// The saturation pressure at the temperatures of the liquid and vapor sheets is interpolated with cubic Hermite polynomials.
+    /// @param T The temperature of water (in units of K)
+    /// @param P The pressure of water (in units of Pa)
+    /// @param[out] u The pressure coordinate of the pressure
+    /// @param[out] usat The pressure coordinate of the saturation pressure at the temperature (zero above the critical temperature)
+    auto find(RealConstRef T, RealConstRef P, Real& u, Real& usat) const -> const WaterSplineSheet*
+    {
+        const auto Tc = waterCriticalTemperature;
+        const auto Pc = waterCriticalPressure;
+
+        if(!(T >= options.Tmin && T <= options.Tmax && P >= options.Pmin && P <= options.Pmax))
+            return nullptr;
+
+        if(T > Tc - critical_gap && T < Tc)
+            return nullptr;
+
+        if(std::abs(T/Tc - 1.0) < options.critical_temperature_range && std::abs(P/Pc - 1.0) < options.critical_pressure_range)
+            return nullptr;
+
+        u = waterTableCoordinate(P);
+        usat = 0.0;
+
+        if(T >= Tc)
+            return &sheets[2];
+
+        const auto& sheet = sheets[0];
+        const auto x = std::min(std::max((T - sheet.Tmin)/sheet.dT, 0.0), sheet.nT - 1.0);
+        const auto i = std::min<std::size_t>(x, sheet.nT - 2);
+        const auto w = waterSplineWeights(x - i);
+
+        const auto lnP = std::log(P);
+        const auto lnPs = w[0]*saturation_lnP[i] + w[1]*saturation_lnPT[i]*sheet.dT + w[2]*saturation_lnP[i + 1] + w[3]*saturation_lnPT[i + 1]*sheet.dT;
+
+        if(std::abs(lnP - lnPs) < saturation_gap)
+            return nullptr;
+
+        usat = w[0]*saturation_u[i] + w[1]*saturation_uT[i]*sheet.dT + w[2]*saturation_u[i + 1] + w[3]*saturation_uT[i + 1]*sheet.dT;
+
+        return lnP > lnPs ? &sheets[0] : &sheets[1];
+    }
+};
+
+WaterSplineTable::WaterSplineTable(const WaterSplineTableOptions& options)
+: pimpl(new Impl(options))
+{}
+
+WaterSplineTable::WaterSplineTable(const WaterSplineTable& other)
+: pimpl(new Impl(*other.pimpl))
+{}
+
+WaterSplineTable::~WaterSplineTable()
+{}
+
+auto WaterSplineTable::operator=(WaterSplineTable other) -> WaterSplineTable&
+{
+    pimpl = std::move(other.pimpl);
+    return *this;
+}
+
+auto WaterSplineTable::options() const -> const WaterSplineTableOptions&
+{
+    return pimpl->options;
+}
+
+auto WaterSplineTable::size() const -> std::size_t
+{
+    std::size_t res = 0;
+    for(const auto& sheet : pimpl->sheets)
+        res += sheet.nT * sheet.nP;
+    return res;
+}
+
+auto WaterSplineTable::memoryUsage() const -> std::size_t
+{
+    std::size_t res = sizeof(Impl) + (pimpl->saturation_lnP.capacity() + pimpl->saturation_lnPT.capacity() + pimpl->saturation_u.capacity() + pimpl->saturation_uT.capacity()) * sizeof(Real);
+    for(const auto& sheet : pimpl->sheets)
+        res += sizeof(WaterSplineSheet) + sheet.nodes.capacity() * sizeof(WaterSplineNode);
+    return res;
+}
+
+auto WaterSplineTable::contains(RealConstRef T, RealConstRef P) const -> bool
+{
+    Real u, usat;
+    return pimpl->find(T, P, u, usat) != nullptr;
+}
+
+auto WaterSplineTable::props(RealConstRef T, RealConstRef P) const -> WaterThermoProps
+{
+    Real u, usat;
+    const auto sheet = pimpl->find(T, P, u, usat);
+
+    if(!sheet)
+        return waterThermoPropsWagnerPruss(T, P);
+
+    return sheet->interpolate(T, P, u, usat);
+}
+
+auto WaterSplineTable::props(RealConstRef T, RealConstRef P, StateOfMatter stateofmatter) const -> WaterThermoProps
+{
+    Real u, usat;
+    const auto sheet = pimpl->find(T, P, u, usat);
+
+    if(!sheet)
+        return waterThermoPropsWagnerPruss(T, P, stateofmatter);
+
+    const auto liquid = stateofmatter == StateOfMatter::Liquid || stateofmatter == StateOfMatter::Solid;
+
+    if((sheet->phase == WaterSplineSheetPhase::Liquid && !liquid) || (sheet->phase == WaterSplineSheetPhase::Vapor && liquid))
+        return waterThermoPropsWagnerPruss(T, P, stateofmatter);
+
+    return sheet->interpolate(T, P, u, usat);
+}
+
+auto waterSplineTable() -> const WaterSplineTable&
+{
+    static const WaterSplineTable table;
+    return table;
+}
+
+auto waterThermoPropsWagnerPrussSpline(RealConstRef T, RealConstRef P) -> WaterThermoProps
+{
+    return waterSplineTable().props(T, P);
+}
+
+auto waterThermoPropsWagnerPrussSpline(RealConstRef T, RealConstRef P, StateOfMatter stateofmatter) -> WaterThermoProps
+{
+    return waterSplineTable().props(T, P, stateofmatter);
+}
+
+auto waterThermoPropsWagnerPrussSplineBatch(std::size_t n, const Real* T, const Real* P, WaterThermoProps* res, WaterSolverStatus* status) -> void
+{
+    const auto& table = waterSplineTable();
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        if(table.contains(T[i], P[i]))
+        {
+            res[i] = table.props(T[i], P[i]);
+            if(status) status[i] = WaterSolverStatus::Converged;
+        }
+        else
+        {
+            WaterSolverResult result;
+            res[i] = waterThermoPropsWagnerPruss(T[i], P[i], waterDensityInitialGuess(T[i], P[i]), WaterDensityMethod::Newton, result);
+            if(status) status[i] = result.status;
+        }
+    }
+}
+
+} // namespace Fluidika
@@ -0,0 +1,166 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// C++ includes
+#include <cstddef>
+#include <memory>
+
+// Fluidika includes
+#include <Fluidika/Common/Real.hpp>
+#include <Fluidika/Common/StateOfMatter.hpp>
+
+namespace Fluidika {
+
+// Forward declarations
+struct WaterThermoProps;
+enum class WaterSolverStatus;
+
+/// The options for the construction of a @ref WaterSplineTable.
+struct WaterSplineTableOptions
+{
+    /// The lowest temperature of the table (in units of K)
+    Real Tmin = 273.16;
+
+    /// The highest temperature of the table (in units of K)
+    Real Tmax = 1273.0;
+
+    /// The lowest pressure of the table (in units of Pa), which must be below the saturation pressure at the lowest temperature
+    Real Pmin = 100.0;
+
+    /// The highest pressure of the table (in units of Pa)
+    Real Pmax = 1.0e+09;
+
+    /// The largest spacing between the temperatures of the table (in units of K)
+    Real temperature_step = 4.0;
+
+    /// The number of pressures of the table at each temperature of each of its sheets
+    std::size_t pressure_points = 192;
+
+    /// The half-width of the critical region of the table as a fraction of the critical temperature of water
+    Real critical_temperature_range = 0.08;
+
+    /// The half-width of the critical region of the table as a fraction of the critical pressure of water
+    Real critical_pressure_range = 0.7;
+
+    /// The number of threads used to construct the table, or zero to use all hardware threads
+    std::size_t threads = 0;
+};
+
+/// Used to calculate the thermodynamic properties of water with a spline-based table look-up (SBTL) of the Wagner and Pruss (2002) equation of state.
+/// The table is made of three sheets of nodes, uniform in temperature and in the pressure coordinate log(P + 1 MPa), with one
+/// sheet per phase: liquid and vapor below the critical temperature, and supercritical water above it. The pressures of the
+/// liquid and vapor sheets range from and up to the saturation pressure of the equation of state at each temperature, so that
+/// the saturation curve is a line of nodes of both sheets and no spline crosses it.
+///
+/// The nodes store the density, the Helmholtz free energy, the entropy, the isochoric heat capacity and the first and second
+/// partial derivatives of pressure with respect to temperature and density, the latter scaled by their ideal-gas values so
+/// that they vary slowly across the sheets. The properties at a given temperature and pressure are interpolated with bicubic
+/// Hermite splines among the four nodes around it, whose derivatives are calculated with fourth-order finite differences.
+/// All other properties are calculated from these as in @ref waterThermoProps, so that they are consistent with each other.
+///
+/// The states outside the table, in its critical region, where the properties vary too quickly to be interpolated, or whose
+/// pressure is within a relative difference of 1e-6 from the saturation pressure, which is interpolated among the temperatures
+/// of the sheets, are calculated with @ref waterThermoPropsWagnerPruss. With the default options, the critical region spans 595-699 K and
+/// 6.6-37.5 MPa, and the table has 66816 nodes (19 MB) and is constructed in about 0.2 s with one thread. The largest
+/// relative errors of its properties with respect to those of @ref waterThermoPropsWagnerPruss, which occur next to the
+/// critical region, are then about 3e-5 in density, 1e-5 in entropy, enthalpy and internal energy (relative to R and R*T
+/// where these are close to zero), 1e-4 in isochoric heat capacity and speed of sound, 5e-4 in isobaric heat capacity and
+/// the first partial derivatives of density and pressure, and 1e-1 in the second partial derivatives of density. Elsewhere,
+/// the relative error in density is below 1e-6. The properties are about 10 times faster to calculate than those of
+/// @ref waterThermoPropsWagnerPruss for states in random order, and about 20 times for sequences of nearby states, whose
+/// nodes are found in the cache of the processor.
+/// @see waterSplineTable, waterThermoPropsWagnerPrussSpline
+class WaterSplineTable
+{
+public:
+    /// Construct a WaterSplineTable instance.
+    /// @param options The options for the construction of the table
+    explicit WaterSplineTable(const WaterSplineTableOptions& options = {});
+
+    /// Construct a copy of a WaterSplineTable instance.
+    WaterSplineTable(const WaterSplineTable& other);
+
+    /// Destroy this WaterSplineTable instance.
+    ~WaterSplineTable();
+
+    /// Assign a copy of a WaterSplineTable instance to this.
+    auto operator=(WaterSplineTable other) -> WaterSplineTable&;
+
+    /// Return the options used to construct the table.
+    auto options() const -> const WaterSplineTableOptions&;
+
+    /// Return the number of nodes of the table in all its sheets.
+    auto size() const -> std::size_t;
+
+    /// Return the memory used by the nodes of the table (in units of bytes).
+    auto memoryUsage() const -> std::size_t;
+
+    /// Return true if the properties of water at given temperature and pressure are interpolated in the table.
+    /// @param T The temperature of water (in units of K)
+    /// @param P The pressure of water (in units of Pa)
+    auto contains(RealConstRef T, RealConstRef P) const -> bool;
+
+    /// Calculate the thermodynamic properties of water at given temperature and pressure.
+    /// @param T The temperature of water (in units of K)
+    /// @param P The pressure of water (in units of Pa)
+    auto props(RealConstRef T, RealConstRef P) const -> WaterThermoProps;
+
+    /// Calculate the thermodynamic properties of water at given temperature and pressure and specific state of matter for water.
+    /// The liquid (solid) and vapor (gas or plasma) sheets only cover the stable states of each phase. Metastable states,
+    /// whose state of matter is not that of the side of the saturation curve of given pressure, are calculated with
+    /// @ref waterThermoPropsWagnerPruss as for states outside the table.
+    /// @param T The temperature of water (in units of K)
+    /// @param P The pressure of water (in units of Pa)
+    /// @param stateofmatter The state of matter of water
+    auto props(RealConstRef T, RealConstRef P, StateOfMatter stateofmatter) const -> WaterThermoProps;
+
+private:
+    struct Impl;
+
+    std::unique_ptr<Impl> pimpl;
+};
+
+/// Return the table of thermodynamic properties of water of the Wagner and Pruss (2002) equation of state using the default options.
+/// The table is constructed on the first call, once even if several threads call this method at the same time.
+auto waterSplineTable() -> const WaterSplineTable&;
+
+/// Calculate the thermodynamic properties of water using the spline-based table look-up of the Wagner and Pruss (2002) equation of state with given temperature and pressure.
+/// This is the fast counterpart of @ref waterThermoPropsWagnerPruss for calculations that can afford its lower accuracy (see @ref WaterSplineTable).
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @see waterSplineTable
+auto waterThermoPropsWagnerPrussSpline(RealConstRef T, RealConstRef P) -> WaterThermoProps;
+
+/// Calculate the thermodynamic properties of water using the spline-based table look-up of the Wagner and Pruss (2002) equation of state with given temperature, pressure and specific state of matter for water.
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param stateofmatter The state of matter of water
+/// @see waterSplineTable
+auto waterThermoPropsWagnerPrussSpline(RealConstRef T, RealConstRef P, StateOfMatter stateofmatter) -> WaterThermoProps;
+
+/// Calculate the thermodynamic properties of water using the spline-based table look-up of the Wagner and Pruss (2002) equation of state for many pairs of temperature and pressure.
+/// @param n The number of states to be calculated
+/// @param T The array of temperatures of water (in units of K) with length *n*
+/// @param P The array of pressures of water (in units of Pa) with length *n*
+/// @param[out] res The array of thermodynamic properties of water with length *n*
+/// @param[out] status The array of outcomes of the calculations with length *n* (converged for the interpolated states), or nullptr if not needed
+/// @see waterSplineTable, waterThermoPropsWagnerPrussBatch
+auto waterThermoPropsWagnerPrussSplineBatch(std::size_t n, const Real* T, const Real* P, WaterThermoProps* res, WaterSolverStatus* status) -> void;
+
+} // namespace Fluidika
@@ -0,0 +1,175 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+// C++ includes
+#include <cmath>
+#include <utility>
+#include <vector>
+
+// Catch includes
+#include <catch2/catch.hpp>
+
+// Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
+#include <Fluidika/Water/ThermoModels/WaterSplineTable.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+using namespace Fluidika;
+
+TEST_CASE("Fluidika::WaterThermoModels::WaterSplineTable", "[WaterSplineTable]")
+{
+    const auto& table = waterSplineTable();
+
+    const auto R = universalGasConstant/waterMolarMass;
+
+    SECTION("when the table is constructed")
+    {
+        REQUIRE(table.size() == 66816);
+        REQUIRE(table.memoryUsage() > table.size() * 36 * sizeof(Real));
+        REQUIRE(&waterSplineTable() == &table);
+
+        REQUIRE(table.contains(300.0, 1e+05));
+        REQUIRE(table.contains(1000.0, 5e+08));
+        REQUIRE_FALSE(table.contains(1300.0, 1e+05));
+        REQUIRE_FALSE(table.contains(300.0, 50.0));
+        REQUIRE_FALSE(table.contains(650.0, 2.5e+07));
+        REQUIRE_FALSE(table.contains(waterCriticalTemperature - 5e-4, 1e+08));
+
+        WaterSplineTableOptions options;
+        options.Tmax = 600.0;
+        REQUIRE_THROWS(WaterSplineTable(options));
+
+        options = {};
+        options.Pmin = 1e+04;
+        REQUIRE_THROWS(WaterSplineTable(options));
+    }
+
+    SECTION("when states in the table are interpolated")
+    {
+        for(auto T = 275.3; T < 1273.0; T += 11.3)
+        {
+            for(auto P = 137.0; P < 1e+09; P *= 1.73)
+            {
+                if(!table.contains(T, P))
+                    continue;
+
+                const auto expected = waterThermoPropsWagnerPruss(T, P);
+                const auto wtp = table.props(T, P);
+
+                REQUIRE(wtp.temperature == T);
+                REQUIRE(wtp.pressure == Approx(P).epsilon(1e-14));
+                REQUIRE(wtp.density == Approx(expected.density).epsilon(3e-5));
+                REQUIRE(wtp.entropy == Approx(expected.entropy).epsilon(1e-5).margin(1e-5*R));
+                REQUIRE(wtp.enthalpy == Approx(expected.enthalpy).epsilon(1e-5).margin(1e-5*R*T));
+                REQUIRE(wtp.internal_energy == Approx(expected.internal_energy).epsilon(1e-5).margin(1e-5*R*T));
+                REQUIRE(wtp.cv == Approx(expected.cv).epsilon(1e-4));
+                REQUIRE(wtp.cp == Approx(expected.cp).epsilon(5e-4));
+                REQUIRE(wtp.speed_of_sound == Approx(expected.speed_of_sound).epsilon(1e-4));
+                REQUIRE(wtp.densityP == Approx(expected.densityP).epsilon(5e-4));
+                REQUIRE(wtp.pressureD == Approx(expected.pressureD).epsilon(5e-4));
+            }
+        }
+    }
+
+    SECTION("when states next to the saturation curve are interpolated")
+    {
+        for(auto T : { 300.0, 450.0, 580.0 })
+        {
+            const auto sat = waterSaturationPropsWagnerPruss(T);
+
+            REQUIRE(table.props(T, sat.pressure*(1 + 1e-5)).density == Approx(sat.density_liquid).epsilon(1e-6));
+            REQUIRE(table.props(T, sat.pressure*(1 - 1e-5)).density == Approx(sat.density_vapor).epsilon(2e-5));
+
+            // The states closer to the saturation curve than its interpolation error are calculated with the equation of state
+            REQUIRE_FALSE(table.contains(T, sat.pressure*(1 + 1e-7)));
+            REQUIRE(table.props(T, sat.pressure*(1 - 1e-7)).density == waterThermoPropsWagnerPruss(T, sat.pressure*(1 - 1e-7)).density);
+        }
+    }
+
+    SECTION("when states outside the table are calculated")
+    {
+        // The states outside the table, or in its critical region, are calculated with the equation of state
+        for(auto [T, P] : { std::pair{ 1300.0, 1e+05 }, std::pair{ 650.0, 2.5e+07 }, std::pair{ 300.0, 50.0 } })
+        {
+            REQUIRE(table.props(T, P).density == waterThermoPropsWagnerPruss(T, P).density);
+            REQUIRE(table.props(T, P).cp == waterThermoPropsWagnerPruss(T, P).cp);
+        }
+    }
+
+    SECTION("when the state of matter of water is given")
+    {
+        // Liquid water at 400 K and 1 bar is metastable, since its saturation pressure is about 2.5 bar
+        const auto T = 400.0;
+        const auto P = 1e+05;
+
+        REQUIRE(table.props(T, P, StateOfMatter::Gas).density == table.props(T, P).density);
+        REQUIRE(table.props(T, P, StateOfMatter::Liquid).density == waterThermoPropsWagnerPruss(T, P, StateOfMatter::Liquid).density);
+        REQUIRE(table.props(T, P, StateOfMatter::Liquid).density > 900.0);
+
+        REQUIRE(table.props(T, 1e+07, StateOfMatter::Liquid).density == table.props(T, 1e+07).density);
+        REQUIRE(waterThermoPropsWagnerPrussSpline(T, P, StateOfMatter::Liquid).density == table.props(T, P, StateOfMatter::Liquid).density);
+    }
+
+    SECTION("when states are calculated in batch")
+    {
+        const std::vector<Real> T = { 300.0, 450.0, 650.0, 900.0, 1300.0 };
+        const std::vector<Real> P = { 1e+05, 1e+03, 2.5e+07, 3e+08, 1e+06 };
+
+        std::vector<WaterThermoProps> res(T.size());
+        std::vector<WaterSolverStatus> status(T.size());
+        waterThermoPropsWagnerPrussSplineBatch(T.size(), T.data(), P.data(), res.data(), status.data());
+
+        for(std::size_t i = 0; i < T.size(); ++i)
+        {
+            REQUIRE(res[i].density == waterThermoPropsWagnerPrussSpline(T[i], P[i]).density);
+            REQUIRE(res[i].enthalpy == table.props(T[i], P[i]).enthalpy);
+            REQUIRE(status[i] == WaterSolverStatus::Converged);
+        }
+
+        // The state at 1300 K lies outside the table, so its status is that of the equation of state
+        REQUIRE_FALSE(table.contains(T.back(), P.back()));
+
+        waterThermoPropsWagnerPrussSplineBatch(T.size(), T.data(), P.data(), res.data(), nullptr);
+        REQUIRE(res.front().density == table.props(T.front(), P.front()).density);
+    }
+
+    SECTION("when a table is constructed with custom options")
+    {
+        WaterSplineTableOptions options;
+        options.Tmax = 800.0;
+        options.Pmax = 1e+08;
+        options.temperature_step = 10.0;
+        options.pressure_points = 64;
+        options.threads = 2;
+
+        const WaterSplineTable custom(options);
+
+        REQUIRE(custom.options().Tmax == 800.0);
+        REQUIRE(custom.size() == 2*39*64 + 17*64);
+        REQUIRE_FALSE(custom.contains(900.0, 1e+05));
+        REQUIRE_FALSE(custom.contains(500.0, 2e+08));
+
+        for(auto [T, P] : { std::pair{ 320.0, 1e+05 }, std::pair{ 500.0, 1e+04 }, std::pair{ 780.0, 5e+07 } })
+            REQUIRE(custom.props(T, P).density == Approx(waterThermoPropsWagnerPruss(T, P).density).epsilon(1e-3));
+
+        // Copies of the table interpolate the same properties
+        WaterSplineTable copy = custom;
+        REQUIRE(copy.size() == custom.size());
+        REQUIRE(copy.props(500.0, 1e+04).entropy == custom.props(500.0, 1e+04).entropy);
+    }
+}
@@ -0,0 +1,183 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "WaterStateTracker.hpp"
+
+// C++ includes
+#include <cmath>
+#include <vector>
+
+// Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Water/ThermoModels/HGK.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+
+namespace Fluidika {
+
+namespace {
+
+/// The last water state of a cell.
+struct WaterCellState
+{
+    /// The temperature of water (in units of K)
+    Real T = 0.0;
+
+    /// The pressure of water (in units of Pa)
+    Real P = 0.0;
+
+    /// The density of water (in units of kg/m3), which is zero if the cell has no state
+    Real D = 0.0;
+
+    /// The partial derivative of density with respect to temperature (in units of (kg/m3)/K)
+    Real DT = 0.0;
+
+    /// The partial derivative of density with respect to pressure (in units of (kg/m3)/Pa)
+    Real DP = 0.0;
+};
+
+} // namespace
+
+struct WaterStateTracker::Impl
+{
+    /// The equation of state of water.
+    WaterThermoModel model;
+
+    /// The last water states of the cells.
+    std::vector<WaterCellState> cells;
+
+    /// Construct a WaterStateTracker::Impl instance.
+    Impl(std::size_t size, WaterThermoModel model)
+    : model(model), cells(size)
+    {}
+
+    /// Return the initial guess for the density of water in a cell at given temperature and pressure.
+    auto predict(std::size_t i, RealConstRef T, RealConstRef P) const -> Real
+    {
+        const auto& cell = cells[i];
+
+        if(cell.D <= 0.0)
+            return waterDensityInitialGuess(T, P);
+
+        // Below the critical temperature, the Newton iterations would converge to a metastable state if started
+        // from the other side of the saturation curve, where the saturated liquid and vapor densities lie
+        // above and below the critical density respectively
+        if(T < waterCriticalTemperature)
+        {
+            const auto liquid = P >= waterPressureSaturatedStateWagnerPruss(T);
+            if(liquid != (cell.D > waterCriticalDensity))
+                return waterDensityInitialGuess(T, P);
+        }
+
+        const auto D0 = cell.D + cell.DT*(T - cell.T) + cell.DP*(P - cell.P);
+
+        return (D0 > 0.0 && std::isfinite(D0)) ? D0 : waterDensityInitialGuess(T, P);
+    }
+
+    /// Remember the water state of a cell, or forget it if the calculation did not converge.
+    auto remember(std::size_t i, RealConstRef T, RealConstRef P, const WaterThermoProps& wtp, bool converged) -> void
+    {
+        auto& cell = cells[i];
+        const auto valid = converged && wtp.density > 0.0 && std::isfinite(wtp.densityT) && std::isfinite(wtp.densityP);
+        cell.T  = T;
+        cell.P  = P;
+        cell.D  = valid ? wtp.density : 0.0;
+        cell.DT = valid ? wtp.densityT : 0.0;
+        cell.DP = valid ? wtp.densityP : 0.0;
+    }
+};
+
+WaterStateTracker::WaterStateTracker(std::size_t size, WaterThermoModel model)
+: pimpl(new Impl(size, model))
+{}
+
+WaterStateTracker::WaterStateTracker(const WaterStateTracker& other)
+: pimpl(new Impl(*other.pimpl))
+{}
+
+WaterStateTracker::~WaterStateTracker()
+{}
+
+auto WaterStateTracker::operator=(WaterStateTracker other) -> WaterStateTracker&
+{
+    pimpl = std::move(other.pimpl);
+    return *this;
+}
+
+auto WaterStateTracker::size() const -> std::size_t
+{
+    return pimpl->cells.size();
+}
+
+auto WaterStateTracker::model() const -> WaterThermoModel
+{
+    return pimpl->model;
+}
+
+auto WaterStateTracker::reset() -> void
+{
+    for(auto& cell : pimpl->cells)
+        cell = {};
+}
+
+auto WaterStateTracker::reset(std::size_t i) -> void
+{
+    pimpl->cells[i] = {};
+}
+
+auto WaterStateTracker::predict(std::size_t i, RealConstRef T, RealConstRef P) const -> Real
+{
+    return pimpl->predict(i, T, P);
+}
+
+auto WaterStateTracker::update(std::size_t i, RealConstRef T, RealConstRef P) -> WaterThermoProps
+{
+    const auto D0 = pimpl->predict(i, T, P);
+
+    WaterSolverResult result;
+
+    const auto wtp = pimpl->model == WaterThermoModel::HGK ?
+        waterThermoPropsHGK(T, P, D0, WaterDensityMethod::Newton, result) :
+        waterThermoPropsWagnerPruss(T, P, D0, WaterDensityMethod::Newton, result);
+
+    pimpl->remember(i, T, P, wtp, result.status == WaterSolverStatus::Converged);
+
+    return wtp;
+}
+
+auto WaterStateTracker::update(const Real* T, const Real* P, WaterThermoProps* res) -> void
+{
+    const auto n = size();
+
+    std::vector<Real> D0(n);
+    for(std::size_t i = 0; i < n; ++i)
+        D0[i] = pimpl->predict(i, T[i], P[i]);
+
+    std::vector<WaterSolverStatus> status(n);
+
+    if(pimpl->model == WaterThermoModel::HGK)
+        waterThermoPropsHGKBatch(n, T, P, D0.data(), res, status.data());
+    else
+        waterThermoPropsWagnerPrussBatch(n, T, P, D0.data(), res, status.data());
+
+    for(std::size_t i = 0; i < n; ++i)
+        pimpl->remember(i, T[i], P[i], res[i], status[i] == WaterSolverStatus::Converged);
+}
+
+} // namespace Fluidika
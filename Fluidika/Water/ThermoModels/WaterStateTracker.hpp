@@ -0,0 +1,98 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+// C++ includes
+#include <cstddef>
+#include <memory>
+
+// Fluidika includes
+#include <Fluidika/Common/Real.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+
+namespace Fluidika {
+
+// Forward declarations
+struct WaterThermoProps;
+
+/// Used to calculate the thermodynamic properties of water in many cells whose temperature and pressure change slightly over time.
+/// In time-stepping simulations, the temperature and pressure of each cell move only slightly from one step to the next.
+/// This class remembers the density of water in each cell, together with its partial derivatives with respect to
+/// temperature and pressure, from the last calculation. The initial guess for the Newton iterations at the new
+/// temperature and pressure is then predicted with a first-order Taylor step from the last state, so that most
+/// cells converge in one or two iterations, instead of the few more needed from the guess of @ref waterDensityInitialGuess.
+/// Cells that have not been calculated yet, whose last calculation did not converge, or whose new state is on the
+/// other side of the saturation curve use the guess of @ref waterDensityInitialGuess instead.
+class WaterStateTracker
+{
+public:
+    /// Construct a WaterStateTracker instance.
+    /// @param size The number of cells whose water states are tracked
+    /// @param model The equation of state of water
+    explicit WaterStateTracker(std::size_t size, WaterThermoModel model = WaterThermoModel::WagnerPruss);
+
+    /// Construct a copy of a WaterStateTracker instance.
+    WaterStateTracker(const WaterStateTracker& other);
+
+    /// Destroy this WaterStateTracker instance.
+    ~WaterStateTracker();
+
+    /// Assign a copy of a WaterStateTracker instance to this.
+    auto operator=(WaterStateTracker other) -> WaterStateTracker&;
+
+    /// Return the number of cells whose water states are tracked.
+    auto size() const -> std::size_t;
+
+    /// Return the equation of state of water.
+    auto model() const -> WaterThermoModel;
+
+    /// Forget the last water state of all cells.
+    auto reset() -> void;
+
+    /// Forget the last water state of a cell.
+    /// @param i The index of the cell
+    auto reset(std::size_t i) -> void;
+
+    /// Return the initial guess for the density of water in a cell at given temperature and pressure.
+    /// @param i The index of the cell
+    /// @param T The new temperature of water in the cell (in units of K)
+    /// @param P The new pressure of water in the cell (in units of Pa)
+    /// @return The initial guess for the density of water (in units of kg/m3)
+    auto predict(std::size_t i, RealConstRef T, RealConstRef P) const -> Real;
+
+    /// Calculate the thermodynamic properties of water in a cell at given temperature and pressure, and remember its new state.
+    /// @param i The index of the cell
+    /// @param T The new temperature of water in the cell (in units of K)
+    /// @param P The new pressure of water in the cell (in units of Pa)
+    auto update(std::size_t i, RealConstRef T, RealConstRef P) -> WaterThermoProps;
+
+    /// Calculate the thermodynamic properties of water in all cells at given temperatures and pressures, and remember their new states.
+    /// The cells are calculated together with the batch solvers (e.g., @ref waterThermoPropsWagnerPrussBatch).
+    /// @param T The array of new temperatures of water (in units of K) with length @ref size
+    /// @param P The array of new pressures of water (in units of Pa) with length @ref size
+    /// @param[out] res The array of thermodynamic properties of water with length @ref size
+    auto update(const Real* T, const Real* P, WaterThermoProps* res) -> void;
+
+private:
+    struct Impl;
+
+    std::unique_ptr<Impl> pimpl;
+};
+
+} // namespace Fluidika
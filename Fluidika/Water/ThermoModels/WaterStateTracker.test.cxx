@@ -0,0 +1,132 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+
+// C++ includes
+#include <cmath>
+#include <vector>
+
+// Catch includes
+#include <catch2/catch.hpp>
+
+// Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Water/ThermoModels/HGK.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
+#include <Fluidika/Water/ThermoModels/WaterStateTracker.hpp>
+#include <Fluidika/Water/WaterData.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+using namespace Fluidika;
+
+TEST_CASE("Fluidika::WaterThermoModels::WaterStateTracker", "[WaterStateTracker]")
+{
+    // The initial states of the cells, taken from Table 13.2 of Wagner and Pruss (2002) away from the saturation curve
+    std::vector<Real> T0, P0;
+    for(auto item : waterThermoDataSinglePhaseStateWagnerPruss())
+    {
+        const auto T = item.temperature;
+        const auto P = item.pressure;
+        if(T < waterCriticalTemperature && std::abs(P/waterPressureSaturatedStateWagnerPruss(T) - 1.0) < 0.05)
+            continue;
+        T0.push_back(T);
+        P0.push_back(P);
+    }
+
+    const auto n = T0.size();
+
+    // Move the states of the cells slightly over a few time steps
+    const auto advance = [&](std::vector<Real>& T, std::vector<Real>& P, std::size_t step)
+    {
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            T[i] += 0.1 * std::sin(0.1*i + step);
+            P[i] *= 1.0 + 1e-4 * std::cos(0.1*i + step);
+        }
+    };
+
+    SECTION("when the cells are updated one by one")
+    {
+        for(auto model : { WaterThermoModel::WagnerPruss, WaterThermoModel::HGK })
+        {
+            auto T = T0;
+            auto P = P0;
+
+            WaterStateTracker tracker(n, model);
+
+            REQUIRE(tracker.size() == n);
+            REQUIRE(tracker.model() == model);
+
+            for(std::size_t step = 0; step < 4; ++step)
+            {
+                for(std::size_t i = 0; i < n; ++i)
+                {
+                    const auto D0 = tracker.predict(i, T[i], P[i]);
+                    const auto wtp = tracker.update(i, T[i], P[i]);
+                    // The safeguarded method converges on the side of the saturation curve given by the pressure, unlike
+                    // the Newton iterations from the guess of waterDensityInitialGuess for some vapor states
+                    const auto expected = model == WaterThermoModel::HGK ?
+                        waterThermoPropsHGK(T[i], P[i], WaterDensityMethod::Safeguarded) :
+                        waterThermoPropsWagnerPruss(T[i], P[i], WaterDensityMethod::Safeguarded);
+
+                    REQUIRE(wtp.density == Approx(expected.density).epsilon(1e-10));
+                    REQUIRE(wtp.pressure == Approx(P[i]).margin(1e-8 * waterCriticalPressure));
+
+                    // After the first step, the Taylor prediction must be close to the density (least so near the critical point)
+                    if(step > 0)
+                        REQUIRE(D0 == Approx(wtp.density).epsilon(1e-3));
+                }
+                advance(T, P, step);
+            }
+        }
+    }
+
+    SECTION("when all cells are updated together")
+    {
+        auto T = T0;
+        auto P = P0;
+
+        WaterStateTracker tracker(n);
+
+        std::vector<WaterThermoProps> res(n);
+
+        for(std::size_t step = 0; step < 4; ++step)
+        {
+            tracker.update(T.data(), P.data(), res.data());
+
+            for(std::size_t i = 0; i < n; ++i)
+                REQUIRE(res[i].density == Approx(waterThermoPropsWagnerPruss(T[i], P[i], WaterDensityMethod::Safeguarded).density).epsilon(1e-10));
+
+            advance(T, P, step);
+        }
+    }
+
+    SECTION("when a cell crosses the saturation curve")
+    {
+        WaterStateTracker tracker(1);
+
+        const auto P = 101325.0;
+
+        REQUIRE(tracker.update(0, 372.0, P).density > waterCriticalDensity);
+        REQUIRE(tracker.update(0, 374.0, P).density < waterCriticalDensity);
+        REQUIRE(tracker.update(0, 372.0, P).density > waterCriticalDensity);
+
+        tracker.reset();
+
+        REQUIRE(tracker.predict(0, 372.0, P) == waterDensityInitialGuess(372.0, P));
+    }
+}
@@ -0,0 +1,124 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// C++ includes
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Common/Real.hpp>
+#include <Fluidika/Water/ThermoModels/HGK.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/ThermoModels/UtilsGeneric.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+
+namespace Fluidika {
+namespace internal {
+
+/// Call a function for each index below *n* on several threads, each of which takes the next index not yet taken.
+/// @param n The number of indices
+/// @param threads The number of threads, or zero to use all hardware threads
+/// @param f The function called for each index, callable as `f(index)`
+template<typename Function>
+auto waterTableParallelFor(std::size_t n, std::size_t threads, const Function& f) -> void
+{
+    std::atomic<std::size_t> next{0};
+
+    const auto work = [&]()
+    {
+        for(auto c = next++; c < n; c = next++)
+            f(c);
+    };
+
+    const auto hardware = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    const auto nthreads = std::min(threads ? threads : hardware, n);
+
+    std::vector<std::thread> pool;
+    for(std::size_t t = 1; t < nthreads; ++t)
+        pool.emplace_back(work);
+    work();
+    for(auto& thread : pool)
+        thread.join();
+}
+
+/// Calculate the columns of nodes of the sheets of a table, one per temperature of each sheet, on several threads.
+/// The columns are calculated independently, and each sheet must give its number of temperatures as `sheet.nT`.
+/// @param sheets The sheets of the table
+/// @param threads The number of threads, or zero to use all hardware threads
+/// @param calculate The function that calculates a column of a sheet, callable as `calculate(sheet, i)`
+template<typename Sheet, typename Function>
+auto waterTableCalculateColumns(std::vector<Sheet>& sheets, std::size_t threads, const Function& calculate) -> void
+{
+    std::vector<std::array<std::size_t, 2>> columns;
+    for(std::size_t s = 0; s < sheets.size(); ++s)
+        for(std::size_t i = 0; i < sheets[s].nT; ++i)
+            columns.push_back({s, i});
+
+    waterTableParallelFor(columns.size(), threads, [&](std::size_t c) { calculate(sheets[columns[c][0]], columns[c][1]); });
+}
+
+/// Call a function with the Helmholtz functions of water at a temperature, with partial derivatives up to third and second order.
+/// @param model The equation of state of water
+/// @param T The temperature of water (in units of K)
+/// @param f The function called as `f(helmholtz, helmholtziter)`, with Helmholtz functions callable as `helmholtz(T, D)`
+template<typename Function>
+auto withWaterIsotherm(WaterThermoModel model, RealConstRef T, const Function& f) -> void
+{
+    if(model == WaterThermoModel::HGK)
+    {
+        const HGKIsotherm isotherm(T);
+        f([&](RealConstRef, RealConstRef D) { return isotherm.evaluate(D); }, [&](RealConstRef, RealConstRef D) { return isotherm.evaluate<2>(D); });
+    }
+    else
+    {
+        const WagnerPrussIsotherm isotherm(T);
+        f([&](RealConstRef, RealConstRef D) { return isotherm.evaluate(D); }, [&](RealConstRef, RealConstRef D) { return isotherm.evaluate<2>(D); });
+    }
+}
+
+/// Calculate the thermodynamic properties of water at a node of a table, on the side of the saturation curve of the node.
+/// The density is calculated with Newton's method from the initial guess, falling back on the safeguarded method, which
+/// respects the phase given by the saturation curve, if it does not converge to that side. Neither method warns nor updates
+/// the process-wide solver counters, which thus only count the calculations of the users of the library.
+/// @param model The function that calculates specific Helmholtz free energy of water, callable as `model(T, D)`
+/// @param modeliter The function that calculates specific Helmholtz free energy of water with partial derivatives up to second order
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param D0 The initial guess for the density of water (in units of kg/m3)
+/// @param liquid Whether the node is on the liquid side of the saturation curve (not used above the critical temperature)
+template<typename Model, typename ModelIter>
+auto waterTableNodeProps(const Model& model, const ModelIter& modeliter, RealConstRef T, RealConstRef P, RealConstRef D0, bool liquid) -> WaterThermoProps
+{
+    WaterSolverResult result;
+    const auto wtp = generic::waterThermoPropsNewton(model, modeliter, T, P, D0, result);
+
+    if(result.status == WaterSolverStatus::Converged && (T >= waterCriticalTemperature || (wtp.density > waterCriticalDensity) == liquid))
+        return wtp;
+
+    return generic::waterThermoPropsSafeguardedNewton(model, modeliter, T, P, D0, result);
+}
+
+} // namespace internal
+} // namespace Fluidika
@@ -0,0 +1,114 @@
+// Fluidika is a C++ library for calculation of thermodynamic and electrostatic properties of pure fluids.
+//
+// Copyright (C) 2018-2019 Allan Leal and Reaktoro Contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// C++ includes
+#include <cmath>
+#include <cstddef>
+
+// Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Water/ThermoModels/Utils.hpp>
+#include <Fluidika/Water/WaterProps.hpp>
+
+namespace Fluidika {
+namespace internal {
+
+/// The number of properties of water stored in the tables of thermodynamic properties of water (see @ref waterTableFields).
+constexpr std::size_t waterTableNumFields = 9;
+
+/// The shift of the pressures in the pressure coordinate log(P + waterTablePressureShift) of the tables (in units of Pa).
+/// The coordinate is logarithmic above this pressure and linear below it, where the stored properties of vapor vary linearly with pressure.
+constexpr Real waterTablePressureShift = 1e+06;
+
+/// Return the pressure coordinate of the tables of thermodynamic properties of water for given pressure (in units of Pa).
+inline auto waterTableCoordinate(RealConstRef P) -> Real
+{
+    return std::log(P + waterTablePressureShift);
+}
+
+/// Return the properties stored in the tables of thermodynamic properties of water for given thermodynamic properties of water.
+/// The density is stored as its logarithm for liquid water, and as the logarithm of D*R*T/P (which is zero for an ideal gas)
+/// for vapor and supercritical water, whose Helmholtz free energy and entropy are also stored without their terms R*T*log(P)
+/// and -R*log(P) of an ideal gas, which vary too quickly at low pressures, with the gas constant R of the equation of state. The partial derivatives of pressure are divided
+/// by their values for an ideal gas of the same density and temperature (or by D*R/T and R*T/D for the second derivatives
+/// in temperature and density, which are zero for an ideal gas), so that all stored properties vary slowly.
+/// @param liquid Whether water is liquid, or vapor or supercritical
+/// @param wtp The thermodynamic properties of water
+/// @param[out] values The stored properties, with length @ref waterTableNumFields
+/// @param gasconstant The specific gas constant of the ideal-gas limit of the equation of state (in units of J/(kg*K))
+inline auto waterTableFields(bool liquid, const WaterThermoProps& wtp, Real* values, RealConstRef gasconstant = universalGasConstant/waterMolarMass) -> void
+{
+    const auto R = universalGasConstant/waterMolarMass;
+
+    const auto T = wtp.temperature;
+    const auto P = wtp.pressure;
+    const auto D = wtp.density;
+
+    const auto lnP = liquid ? 0.0 : std::log(P);
+
+    values[0] = liquid ? std::log(D) : std::log(D*R*T/P);
+    values[1] = wtp.helmholtz - gasconstant*T*lnP;
+    values[2] = wtp.entropy + gasconstant*lnP;
+    values[3] = wtp.cv;
+    values[4] = wtp.pressureT/(D*R);
+    values[5] = wtp.pressureD/(R*T);
+    values[6] = wtp.pressureTT*T/(D*R);
+    values[7] = wtp.pressureTD/R;
+    values[8] = wtp.pressureDD*D/(R*T);
+}
+
+/// Return the thermodynamic properties of water corresponding to the properties stored in the tables of thermodynamic properties of water.
+/// The Helmholtz free energy state of water is reconstructed from the stored properties, so that all other properties
+/// are calculated from it with @ref waterThermoProps and are consistent with each other.
+/// @param liquid Whether water is liquid, or vapor or supercritical
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @param values The stored properties, with length @ref waterTableNumFields
+/// @param gasconstant The specific gas constant of the ideal-gas limit of the equation of state (in units of J/(kg*K))
+inline auto waterTableProps(bool liquid, RealConstRef T, RealConstRef P, const Real* values, RealConstRef gasconstant = universalGasConstant/waterMolarMass) -> WaterThermoProps
+{
+    const auto R = universalGasConstant/waterMolarMass;
+
+    const auto lnP = liquid ? 0.0 : std::log(P);
+
+    const auto D = liquid ? std::exp(values[0]) : std::exp(values[0])*P/(R*T);
+    const auto DD = D*D;
+
+    const auto PT  = values[4]*D*R;
+    const auto PD  = values[5]*R*T;
+    const auto PTT = values[6]*D*R/T;
+    const auto PTD = values[7]*R;
+    const auto PDD = values[8]*R*T/D;
+
+    WaterHelmholtzProps whp = {};
+    whp.helmholtz    = values[1] + gasconstant*T*lnP;
+    whp.helmholtzT   = gasconstant*lnP - values[2];
+    whp.helmholtzTT  = -values[3]/T;
+    whp.helmholtzD   = P/DD;
+    whp.helmholtzTD  = PT/DD;
+    whp.helmholtzDD  = (PD - 2*D*whp.helmholtzD)/DD;
+    whp.helmholtzTTD = PTT/DD;
+    whp.helmholtzTDD = (PTD - 2*D*whp.helmholtzTD)/DD;
+    whp.helmholtzDDD = (PDD - 2*whp.helmholtzD - 4*D*whp.helmholtzDD)/DD;
+
+    return waterThermoProps(T, D, whp);
+}
+
+} // namespace internal
+} // namespace Fluidika
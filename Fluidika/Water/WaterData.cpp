@@ -16,9 +16,14 @@
 // along with this library. If not, see <http://www.gnu.org/licenses/>.
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 
 // Fluidika includes
 #include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Common/Exception.hpp>
+#include <Fluidika/Common/TableFile.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
 #include <Fluidika/Water/WaterData.hpp>
 #include <Fluidika/Water/WaterProps.hpp>
 
@@ -38,7 +43,7 @@ namespace internal {
 /// - head capacity (constant volume) (in J/(kg·K), originally in kJ/(kg·K))
 /// - head capacity (constant pressure) (in J/(kg·K), originally in kJ/(kg·K))
 /// - speed of sound (in m/s)
-const std::array<WaterThermoPropsSimple, 193> water_thermo_props_saturated_liquid_wagnerpruss =
+constexpr std::array<WaterThermoPropsSimple, 193> water_thermo_props_saturated_liquid_wagnerpruss =
 {
     WaterThermoPropsSimple
     { 273.160, 0.000612, 999.793, 0.0004, 0.001, 0.0000, 4.2174, 4.2199, 1402.30 },
@@ -249,7 +254,7 @@ const std::array<WaterThermoPropsSimple, 193> water_thermo_props_saturated_liqui
 /// - head capacity (constant volume) (in J/(kg·K), originally in kJ/(kg·K))
 /// - head capacity (constant pressure) (in J/(kg·K), originally in kJ/(kg·K))
 /// - speed of sound (in m/s)
-const std::array<WaterThermoPropsSimple, 193> water_thermo_props_saturated_vapor_wagnerpruss =
+constexpr std::array<WaterThermoPropsSimple, 193> water_thermo_props_saturated_vapor_wagnerpruss =
 {
     WaterThermoPropsSimple
     { 273.160, 612, 0.00485, 2374734, 2500920, 9155.5, 1418.4, 1884.4, 409.00 },
@@ -461,7 +466,7 @@ const std::array<WaterThermoPropsSimple, 193> water_thermo_props_saturated_vapor
 /// - head capacity (constant volume) (in J/(kg·K), originally in kJ/(kg·K))
 /// - head capacity (constant pressure) (in J/(kg·K), originally in kJ/(kg·K))
 /// - speed of sound (in m/s)
-const std::array<WaterThermoPropsSimple, 2180> water_thermo_props_single_phase_state_wagnerpruss =
+constexpr std::array<WaterThermoPropsSimple, 2180> water_thermo_props_single_phase_state_wagnerpruss =
 {
     WaterThermoPropsSimple
     { 273.156, 50000, 999.81700, -16, 34, -0.1, 4217.2, 4219.7, 1402.30 },
@@ -2719,14 +2724,207 @@ const std::array<std::array<long, 2>, 31> pressure_equal_ranges_wagnerpruss =
     {{ 2117, 2180 }}
 };
 
+/// Return the columns of a table of thermodynamic properties of water in Wagner and Pruss (2002).
+template<std::size_t N>
+constexpr auto waterThermoDataColumns(const std::array<WaterThermoPropsSimple, N>& table) -> WaterThermoDataColumns<N>
+{
+    WaterThermoDataColumns<N> res = {};
+    for(std::size_t i = 0; i < N; ++i)
+    {
+        res.temperature[i] = table[i].temperature;
+        res.pressure[i] = table[i].pressure;
+        res.density[i] = table[i].density;
+        res.internal_energy[i] = table[i].internal_energy;
+        res.enthalpy[i] = table[i].enthalpy;
+        res.entropy[i] = table[i].entropy;
+        res.cv[i] = table[i].cv;
+        res.cp[i] = table[i].cp;
+        res.speed_of_sound[i] = table[i].speed_of_sound;
+    }
+    return res;
+}
+
+/// The columns of the saturated-liquid thermodynamic properties in Wagner and Pruss (2002), transposed at compile time.
+constexpr auto water_thermo_columns_saturated_liquid_wagnerpruss = waterThermoDataColumns(water_thermo_props_saturated_liquid_wagnerpruss);
+
+/// The columns of the saturated-vapor thermodynamic properties in Wagner and Pruss (2002), transposed at compile time.
+constexpr auto water_thermo_columns_saturated_vapor_wagnerpruss = waterThermoDataColumns(water_thermo_props_saturated_vapor_wagnerpruss);
+
+/// The columns of the single-phase thermodynamic properties in Wagner and Pruss (2002), transposed at compile time.
+constexpr auto water_thermo_columns_single_phase_state_wagnerpruss = waterThermoDataColumns(water_thermo_props_single_phase_state_wagnerpruss);
+
+/// Write the columns of a table of thermodynamic properties of water in Wagner and Pruss (2002) to a table file.
+template<std::size_t N>
+auto writeWaterThermoDataColumns(const std::string& path, const WaterThermoDataColumns<N>& columns) -> void
+{
+    writeTableFile(path, N, {
+        { "temperature", columns.temperature.data() },
+        { "pressure", columns.pressure.data() },
+        { "density", columns.density.data() },
+        { "internal_energy", columns.internal_energy.data() },
+        { "enthalpy", columns.enthalpy.data() },
+        { "entropy", columns.entropy.data() },
+        { "cv", columns.cv.data() },
+        { "cp", columns.cp.data() },
+        { "speed_of_sound", columns.speed_of_sound.data() },
+    });
+}
+
+/// The number of buckets in the index of the pressure levels of Table 13.2 of Wagner and Pruss (2002).
+/// The buckets are uniform in the bit pattern of pressure above that of the lowest level, which is piecewise linear in
+/// the logarithm of pressure, with 64 buckets per octave. No bucket then contains more than one pressure level.
+constexpr std::size_t num_pressure_buckets = 918;
+
+/// The number of buckets in the index of the temperatures in each pressure level of Table 13.2 of Wagner and Pruss (2002).
+/// The buckets are uniform in temperature, about 4 K wide. No bucket then contains more than three states of a level.
+constexpr std::size_t num_temperature_buckets = 256;
+
+/// The maximum number of states of a pressure level in a temperature bucket.
+constexpr long max_states_in_temperature_bucket = 3;
+
+/// The index used to find the pressure levels and temperatures in Table 13.2 of Wagner and Pruss (2002) in constant time.
+/// Each bucket stores the number of pressure levels (or states in a pressure level) that lie in the buckets below it,
+/// which is the result of std::lower_bound for any value in the bucket up to a comparison with the few entries in the bucket.
+struct WaterThermoDataIndex
+{
+    /// The bit pattern of the lowest pressure level.
+    std::int64_t pressure_bits_min;
+
+    /// The lowest temperature in Table 13.2 (in K).
+    double temperature_min;
+
+    /// The number of temperature buckets per Kelvin.
+    double temperature_scale;
+
+    /// The number of pressure levels in the buckets below each pressure bucket.
+    std::array<std::uint8_t, num_pressure_buckets> pressure_buckets;
+
+    /// The number of states of each pressure level in the buckets below each temperature bucket.
+    std::array<std::array<std::uint8_t, num_temperature_buckets>, 31> temperature_buckets;
+
+    /// Return the bucket of a given pressure, with pressures outside the table in the first or last bucket.
+    auto pressureBucket(RealConstRef P) const -> std::size_t
+    {
+        std::int64_t bits;
+        std::memcpy(&bits, &P, sizeof(bits));
+        const auto bucket = (std::max(bits, pressure_bits_min) - pressure_bits_min) >> 46; // negative pressures have negative bit patterns
+        return std::min<std::int64_t>(bucket, num_pressure_buckets - 1);
+    }
+
+    /// Return the bucket of a given temperature, with temperatures outside the table in the first or last bucket.
+    auto temperatureBucket(RealConstRef T) const -> std::size_t
+    {
+        const auto bucket = std::max(0.0, (T - temperature_min) * temperature_scale);
+        return std::min(bucket, num_temperature_buckets - 1.0);
+    }
+};
+
+/// Return the index used to find the pressure levels and temperatures in Table 13.2 of Wagner and Pruss (2002), built on first use.
+auto waterThermoDataIndex() -> const WaterThermoDataIndex&
+{
+    static const auto index = []()
+    {
+        const auto& temperature = water_thermo_columns_single_phase_state_wagnerpruss.temperature;
+
+        WaterThermoDataIndex res = {};
+
+        std::memcpy(&res.pressure_bits_min, &pressure_values_wagnerpruss.front(), sizeof(res.pressure_bits_min));
+
+        std::array<long, num_pressure_buckets> count = {};
+        for(const auto& P : pressure_values_wagnerpruss)
+        {
+            const auto bucket = res.pressureBucket(P);
+            error(++count[bucket] > 1, "More than one pressure level of Table 13.2 in the same bucket of the pressure index.");
+            for(auto i = bucket + 1; i < num_pressure_buckets; ++i)
+                ++res.pressure_buckets[i];
+        }
+
+        const auto [Tmin, Tmax] = std::minmax_element(temperature.begin(), temperature.end());
+
+        res.temperature_min = *Tmin;
+        res.temperature_scale = num_temperature_buckets / (*Tmax - *Tmin);
+
+        for(std::size_t k = 0; k < pressure_equal_ranges_wagnerpruss.size(); ++k)
+        {
+            const auto [begin, end] = pressure_equal_ranges_wagnerpruss[k];
+            std::array<long, num_temperature_buckets> count = {};
+            for(auto i = begin; i < end; ++i)
+            {
+                const auto bucket = res.temperatureBucket(temperature[i]);
+                error(++count[bucket] > max_states_in_temperature_bucket,
+                    "More than ", max_states_in_temperature_bucket, " states of a pressure level of Table 13.2 in the same bucket of the temperature index.");
+                for(auto j = bucket + 1; j < num_temperature_buckets; ++j)
+                    ++res.temperature_buckets[k][j];
+            }
+        }
+
+        return res;
+    }();
+    return index;
+}
+
+/// Return the index of the first pressure level in Table 13.2 not below given pressure, or the number of levels if there is none (as std::lower_bound).
+auto findWaterThermoPropsPressureLevel(RealConstRef P) -> long
+{
+    const auto& index = waterThermoDataIndex();
+    // The buckets above the highest level hold the number of levels, which is clamped to the last level before the comparison
+    const auto k = std::min<long>(index.pressure_buckets[index.pressureBucket(P)], pressure_values_wagnerpruss.size() - 1);
+    return k + (pressure_values_wagnerpruss[k] < P);
+}
+
+/// Return the index in Table 13.2 of the first state in a pressure level whose temperature is not below given temperature,
+/// or the end of the level if there is none (as std::lower_bound).
+auto findWaterThermoPropsTemperatureIndex(long level, RealConstRef T) -> long
+{
+    const auto& index = waterThermoDataIndex();
+    const auto& temperature = water_thermo_columns_single_phase_state_wagnerpruss.temperature;
+    const auto [begin, end] = pressure_equal_ranges_wagnerpruss[level];
+    const auto i = begin + index.temperature_buckets[level][index.temperatureBucket(T)];
+    auto res = i;
+    for(long j = 0; j < max_states_in_temperature_bucket; ++j)
+        res += temperature[std::min(i + j, end - 1)] < T;
+    return std::min(res, end);
+}
+
 auto findWaterThermoPropsRangeWithCommonPressure(RealConstRef P) -> std::array<long, 2>
 {
-    auto pressure_begin = pressure_values_wagnerpruss.begin();
-    auto pressure_end = pressure_values_wagnerpruss.end();
-    auto pressure_it = std::lower_bound(pressure_begin, pressure_end, P);
-    if(pressure_it == pressure_end) pressure_it = pressure_end - 1;
-    auto pressure_index = pressure_it - pressure_begin;
-    return pressure_equal_ranges_wagnerpruss[pressure_index];
+    const auto level = std::min<long>(findWaterThermoPropsPressureLevel(P), pressure_values_wagnerpruss.size() - 1);
+    return pressure_equal_ranges_wagnerpruss[level];
+}
+
+/// Return the index in Table 13.2 of Wagner and Pruss (2002) of the saturated-vapor state in each pressure level.
+/// The saturated-liquid and saturated-vapor states of a level below the critical pressure are stored one after the
+/// other at the same temperature. The end of the level is used for levels above the critical pressure.
+auto findWaterThermoPropsSaturatedVaporIndices() -> const std::array<long, 31>&
+{
+    static const auto indices = []()
+    {
+        const auto& temperature = water_thermo_columns_single_phase_state_wagnerpruss.temperature;
+        std::array<long, 31> res;
+        for(std::size_t k = 0; k < res.size(); ++k)
+        {
+            const auto [begin, end] = pressure_equal_ranges_wagnerpruss[k];
+            res[k] = end;
+            for(auto i = begin + 1; i < end; ++i)
+                if(temperature[i] == temperature[i - 1]) { res[k] = i; break; }
+        }
+        return res;
+    }();
+    return indices;
+}
+
+/// Return the density of water at given temperature interpolated linearly among the states in [begin, end) of a pressure level of Table 13.2.
+/// The density at the first or last of these states is returned if the temperature lies outside their range.
+/// @param i The index of the first state in the pressure level whose temperature is not below *T*
+auto interpolateWaterDensityWithCommonPressure(long begin, long end, long i, RealConstRef T) -> Real
+{
+    const auto& columns = water_thermo_columns_single_phase_state_wagnerpruss;
+    const auto& temperature = columns.temperature;
+    const auto& density = columns.density;
+    i = std::min(std::max(i, begin), end);
+    if(i == begin) return density[begin];
+    if(i == end) return density[end - 1];
+    return density[i - 1] + (T - temperature[i - 1])/(temperature[i] - temperature[i - 1]) * (density[i] - density[i - 1]);
 }
 
 } // namespace internal
@@ -2748,15 +2946,104 @@ auto waterThermoDataSinglePhaseStateWagnerPruss() -> const std::array<WaterTherm
     return water_thermo_props_single_phase_state_wagnerpruss;
 }
 
+auto waterThermoDataColumnsSaturatedLiquidStateWagnerPruss() -> const WaterThermoDataColumns<193>&
+{
+    return water_thermo_columns_saturated_liquid_wagnerpruss;
+}
+
+auto waterThermoDataColumnsSaturatedVaporStateWagnerPruss() -> const WaterThermoDataColumns<193>&
+{
+    return water_thermo_columns_saturated_vapor_wagnerpruss;
+}
+
+auto waterThermoDataColumnsSinglePhaseStateWagnerPruss() -> const WaterThermoDataColumns<2180>&
+{
+    return water_thermo_columns_single_phase_state_wagnerpruss;
+}
+
+auto writeWaterThermoDataSaturatedLiquidStateWagnerPruss(const std::string& path) -> void
+{
+    writeWaterThermoDataColumns(path, water_thermo_columns_saturated_liquid_wagnerpruss);
+}
+
+auto writeWaterThermoDataSaturatedVaporStateWagnerPruss(const std::string& path) -> void
+{
+    writeWaterThermoDataColumns(path, water_thermo_columns_saturated_vapor_wagnerpruss);
+}
+
+auto writeWaterThermoDataSinglePhaseStateWagnerPruss(const std::string& path) -> void
+{
+    writeWaterThermoDataColumns(path, water_thermo_columns_single_phase_state_wagnerpruss);
+}
+
 auto waterThermoDataNearestWagnerPruss(RealConstRef T, RealConstRef P) -> WaterThermoPropsSimple
 {
-    auto pressure_range = findWaterThermoPropsRangeWithCommonPressure(P);
-    const auto comp = [](const WaterThermoPropsSimple& props, RealConstRef T) { return props.temperature < T; };
-    auto begin = water_thermo_props_single_phase_state_wagnerpruss.begin() + pressure_range[0];
-    auto end = water_thermo_props_single_phase_state_wagnerpruss.begin() + pressure_range[1];
-    auto it = std::lower_bound(begin, end, T, comp);
-    if(it == end) it = end - 1;
-    return *it;
+    const auto level = std::min<long>(findWaterThermoPropsPressureLevel(P), pressure_values_wagnerpruss.size() - 1);
+    const auto end = pressure_equal_ranges_wagnerpruss[level][1];
+    const auto i = std::min(findWaterThermoPropsTemperatureIndex(level, T), end - 1);
+    return water_thermo_props_single_phase_state_wagnerpruss[i];
+}
+
+auto waterThermoDataInterpolatedDensityWagnerPruss(RealConstRef T, RealConstRef P) -> Real
+{
+    const auto& levels = pressure_values_wagnerpruss;
+    const auto& vapor_indices = findWaterThermoPropsSaturatedVaporIndices();
+
+    // The side of the saturation curve on which (T, P) lies, with neither side above the critical temperature
+    const auto subcritical = T < waterCriticalTemperature;
+    const auto Psat = subcritical ? waterPressureSaturatedStateWagnerPruss(T) : Real(0.0);
+    const auto liquid = subcritical && P >= Psat;
+    const auto vapor = subcritical && P < Psat;
+
+    // Return the density at T in the k-th pressure level on the same side of the saturation curve as (T, P), or false if T lies on the other side in that level
+    const auto density_in_level = [&](std::size_t k, Real& D) -> bool
+    {
+        const auto [begin, end] = pressure_equal_ranges_wagnerpruss[k];
+        const auto split = vapor_indices[k];
+        const auto i = findWaterThermoPropsTemperatureIndex(k, T);
+        if(split == end) // the level is above the critical pressure, and only liquid-like below the critical temperature
+        {
+            if(vapor) return false;
+            D = interpolateWaterDensityWithCommonPressure(begin, end, i, T);
+            return true;
+        }
+        const auto Tsat = water_thermo_columns_single_phase_state_wagnerpruss.temperature[split];
+        if(liquid && T > Tsat) return false;
+        if(vapor && T < Tsat) return false;
+        D = liquid ? interpolateWaterDensityWithCommonPressure(begin, split, i, T) : interpolateWaterDensityWithCommonPressure(split, end, i, T);
+        return true;
+    };
+
+    // The density of the saturated state on the side of (T, P), which replaces a pressure level that lies on the other side
+    const auto saturated_density = [&]() -> Real
+    {
+        return liquid ? waterDensitySaturatedLiquidStateWagnerPruss(T) : waterDensitySaturatedVaporStateWagnerPruss(T);
+    };
+
+    const auto k1 = std::size_t(findWaterThermoPropsPressureLevel(P));
+
+    Real D0 = 0.0, D1 = 0.0;
+
+    // Above the last pressure level (1 GPa), use the density in that level
+    if(k1 == levels.size())
+        return density_in_level(k1 - 1, D1) ? D1 : saturated_density();
+
+    // Below the first pressure level (50 kPa), scale the density of vapor as that of an ideal gas
+    if(k1 == 0)
+    {
+        if(!density_in_level(0, D1))
+            return saturated_density() * P/Psat;
+        return liquid ? D1 : D1 * P/levels[0];
+    }
+
+    // Interpolate linearly in pressure between the levels around P, replacing either of them by the saturated state
+    // at T if it lies on the other side of the saturation curve, so that liquid and vapor densities are never mixed
+    auto P0 = levels[k1 - 1];
+    auto P1 = levels[k1];
+    if(!density_in_level(k1 - 1, D0)) { P0 = Psat; D0 = saturated_density(); }
+    if(!density_in_level(k1, D1)) { P1 = Psat; D1 = saturated_density(); }
+    if(P1 <= P0) return D1;
+    return D0 + (P - P0)/(P1 - P0) * (D1 - D0);
 }
 
 auto waterThermoDataMinTemperatureWagnerPruss(RealConstRef P) -> WaterThermoPropsSimple
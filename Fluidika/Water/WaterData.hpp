@@ -19,6 +19,8 @@
 
 // C++ includes
 #include <array>
+#include <cstddef>
+#include <string>
 
 // Fluidika includes
 #include <Fluidika/Common/Real.hpp>
@@ -28,6 +30,41 @@ namespace Fluidika {
 // Forward declarations
 struct WaterThermoPropsSimple;
 
+/// The columns of a table of thermodynamic properties of water in Wagner and Pruss (2002).
+/// The properties of the *i*-th state in the table are the *i*-th entries of the columns, which have the same units as the
+/// fields of @ref WaterThermoPropsSimple. Each column is stored contiguously, so that searches over temperature and pressure
+/// do not load the other properties of the states.
+template<std::size_t N>
+struct WaterThermoDataColumns
+{
+    /// The temperatures of the states (in units of K)
+    std::array<Real, N> temperature;
+
+    /// The pressures of the states (in units of Pa)
+    std::array<Real, N> pressure;
+
+    /// The densities of the states (in units of kg/m3)
+    std::array<Real, N> density;
+
+    /// The specific internal energies of the states (in units of J/kg)
+    std::array<Real, N> internal_energy;
+
+    /// The specific enthalpies of the states (in units of J/kg)
+    std::array<Real, N> enthalpy;
+
+    /// The specific entropies of the states (in units of J/(kg*K))
+    std::array<Real, N> entropy;
+
+    /// The specific isochoric heat capacities of the states (in units of J/(kg*K))
+    std::array<Real, N> cv;
+
+    /// The specific isobaric heat capacities of the states (in units of J/(kg*K))
+    std::array<Real, N> cp;
+
+    /// The speeds of sound of the states (in units of m/s)
+    std::array<Real, N> speed_of_sound;
+};
+
 /// Return the array storing all saturated-liquid thermodynamic properties in Wagner and Pruss (2002).
 /// The returned array contains all saturated-liquid thermodynamic properties available in Table 13.1
 /// of Wagner and Pruss (2002)\sup{\cite Wagner2002} that were computed using the IAPWS-1995 water thermodynamic model.
@@ -46,12 +83,51 @@ auto waterThermoDataSaturatedVaporStateWagnerPruss() -> const std::array<WaterTh
 /// There are 2180 data points stored in this array.
 auto waterThermoDataSinglePhaseStateWagnerPruss() -> const std::array<WaterThermoPropsSimple, 2180>&;
 
+/// Return the columns of the saturated-liquid thermodynamic properties in Wagner and Pruss (2002).
+/// The columns contain the same states as @ref waterThermoDataSaturatedLiquidStateWagnerPruss, in the same order.
+auto waterThermoDataColumnsSaturatedLiquidStateWagnerPruss() -> const WaterThermoDataColumns<193>&;
+
+/// Return the columns of the saturated-vapor thermodynamic properties in Wagner and Pruss (2002).
+/// The columns contain the same states as @ref waterThermoDataSaturatedVaporStateWagnerPruss, in the same order.
+auto waterThermoDataColumnsSaturatedVaporStateWagnerPruss() -> const WaterThermoDataColumns<193>&;
+
+/// Return the columns of the single-phase thermodynamic properties in Wagner and Pruss (2002).
+/// The columns contain the same states as @ref waterThermoDataSinglePhaseStateWagnerPruss, in the same order.
+/// The searches in Table 13.2 of the methods below use these columns.
+auto waterThermoDataColumnsSinglePhaseStateWagnerPruss() -> const WaterThermoDataColumns<2180>&;
+
+/// Write the saturated-liquid thermodynamic properties in Table 13.1 of Wagner and Pruss (2002) to a table file.
+/// The table file has one column per field of @ref WaterThermoDataColumns, with the same name, and can be opened with @ref TableFile.
+/// @param path The path of the table file
+auto writeWaterThermoDataSaturatedLiquidStateWagnerPruss(const std::string& path) -> void;
+
+/// Write the saturated-vapor thermodynamic properties in Table 13.1 of Wagner and Pruss (2002) to a table file.
+/// The table file has one column per field of @ref WaterThermoDataColumns, with the same name, and can be opened with @ref TableFile.
+/// @param path The path of the table file
+auto writeWaterThermoDataSaturatedVaporStateWagnerPruss(const std::string& path) -> void;
+
+/// Write the single-phase thermodynamic properties in Table 13.2 of Wagner and Pruss (2002) to a table file.
+/// The table file has one column per field of @ref WaterThermoDataColumns, with the same name, and can be opened with @ref TableFile.
+/// @param path The path of the table file
+auto writeWaterThermoDataSinglePhaseStateWagnerPruss(const std::string& path) -> void;
+
 /// Return an approximation for the thermodynamic properties at given temperature and pressure using Table 13.2 of Wagner and Pruss (2002).
 /// This method searches for the closest temperature and pressure pair in Table 13.2 of Wagner and Pruss (2002)
 /// and returns the thermodynamic properties of water at those *(T, P)* conditions.
 /// Nearest pressure is searched first, then nearest temperature.
 auto waterThermoDataNearestWagnerPruss(RealConstRef T, RealConstRef P) -> WaterThermoPropsSimple;
 
+/// Return an approximation for the density of water at given temperature and pressure interpolated in Table 13.2 of Wagner and Pruss (2002).
+/// The density is interpolated linearly in temperature within the two pressure levels of Table 13.2 around *P*, and then
+/// linearly in pressure between them. Below the critical temperature, only the states of a level on the same side of the
+/// saturation curve as *(T, P)* are used. A level on the other side is replaced by the saturated state at *T*, so that
+/// liquid and vapor densities are never interpolated together. Below the lowest pressure level, the density of vapor is
+/// scaled with pressure as that of an ideal gas.
+/// @param T The temperature of water (in units of K)
+/// @param P The pressure of water (in units of Pa)
+/// @return The interpolated density of water (in units of kg/m3)
+auto waterThermoDataInterpolatedDensityWagnerPruss(RealConstRef T, RealConstRef P) -> Real;
+
 /// Return the thermodynamic properties of water at given pressure and lowest available temperature in Table 13.2 of Wagner and Pruss (2002).
 auto waterThermoDataMinTemperatureWagnerPruss(RealConstRef P) -> WaterThermoPropsSimple;
 
@@ -15,10 +15,16 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with this library. If not, see <http://www.gnu.org/licenses/>.
 
+// C++ includes
+#include <algorithm>
+#include <cmath>
+
 // Catch includes
 #include <catch2/catch.hpp>
 
 // Fluidika includes
+#include <Fluidika/Common/Constants.hpp>
+#include <Fluidika/Water/ThermoModels/WagnerPruss.hpp>
 #include <Fluidika/Water/WaterData.hpp>
 #include <Fluidika/Water/WaterProps.hpp>
 using namespace Fluidika;
@@ -33,4 +39,87 @@ TEST_CASE("Fluidika::WaterThermoDataWagnerPruss", "[WaterThermoDataWagnerPruss]"
         REQUIRE(wps.temperature == T);
         REQUIRE(wps.pressure == P);
     }
+
+    // The columns of the tables contain the same states as their rows
+    const auto check_columns = [](const auto& rows, const auto& columns)
+    {
+        for(std::size_t i = 0; i < rows.size(); ++i)
+        {
+            REQUIRE(columns.temperature[i] == rows[i].temperature);
+            REQUIRE(columns.pressure[i] == rows[i].pressure);
+            REQUIRE(columns.density[i] == rows[i].density);
+            REQUIRE(columns.internal_energy[i] == rows[i].internal_energy);
+            REQUIRE(columns.enthalpy[i] == rows[i].enthalpy);
+            REQUIRE(columns.entropy[i] == rows[i].entropy);
+            REQUIRE(columns.cv[i] == rows[i].cv);
+            REQUIRE(columns.cp[i] == rows[i].cp);
+            REQUIRE(columns.speed_of_sound[i] == rows[i].speed_of_sound);
+        }
+    };
+
+    check_columns(waterThermoDataSaturatedLiquidStateWagnerPruss(), waterThermoDataColumnsSaturatedLiquidStateWagnerPruss());
+    check_columns(waterThermoDataSaturatedVaporStateWagnerPruss(), waterThermoDataColumnsSaturatedVaporStateWagnerPruss());
+    check_columns(waterThermoDataSinglePhaseStateWagnerPruss(), waterThermoDataColumnsSinglePhaseStateWagnerPruss());
+
+    // The nearest states found with the index of the table are those found with binary searches in pressure and then temperature
+    const auto& data = waterThermoDataSinglePhaseStateWagnerPruss();
+    const auto nearest = [&](double T, double P)
+    {
+        const auto comp = [](const auto& x, double P) { return x.pressure < P; };
+        auto lower = std::lower_bound(data.begin(), data.end(), P, comp);
+        if(lower == data.end()) lower = std::lower_bound(data.begin(), data.end(), data.back().pressure, comp);
+        const auto upper = std::upper_bound(data.begin(), data.end(), lower->pressure, [](double P, const auto& x) { return P < x.pressure; });
+        auto it = std::lower_bound(lower, upper, T, [](const auto& x, double T) { return x.temperature < T; });
+        if(it == upper) it = upper - 1;
+        return it - data.begin();
+    };
+
+    const auto check = [&](double T, double P)
+    {
+        const auto wps = waterThermoDataNearestWagnerPruss(T, P);
+        const auto& expected = data[nearest(T, P)];
+        REQUIRE(wps.temperature == expected.temperature);
+        REQUIRE(wps.pressure == expected.pressure);
+        REQUIRE(wps.density == expected.density);
+        REQUIRE(waterThermoDataMinTemperatureWagnerPruss(P).temperature == data[nearest(0.0, P)].temperature);
+        REQUIRE(waterThermoDataMaxTemperatureWagnerPruss(P).temperature == data[nearest(1e4, P)].temperature);
+    };
+
+    const auto factors = { 1.0 - 1e-4, 1.0 - 1e-12, 1.0, 1.0 + 1e-12, 1.0 + 1e-4 };
+    for(auto item : data)
+        for(auto fT : factors)
+            for(auto fP : factors)
+                check(item.temperature * fT, item.pressure * fP);
+
+    for(auto T : { -1.0, 0.0, 100.0, 1e4 })
+        for(auto P : { -1.0, 0.0, 1.0, 1e10 })
+            check(T, P);
+
+    // The pressures above the highest level, whose buckets hold no level, are found past the end of the levels
+    for(auto T : { 300.0, 1000.0 })
+        for(auto factor : { 1.0 + 1e-12, 1.0 + 1e-4, 1.5, 4.0 })
+            check(T, data.back().pressure * factor);
+
+    // The interpolated density is the tabulated one at the states of Table 13.2, except those on the saturation curve
+    for(auto item : waterThermoDataSinglePhaseStateWagnerPruss())
+    {
+        const auto T = item.temperature;
+        const auto P = item.pressure;
+        if(T < waterCriticalTemperature && std::abs(P/waterPressureSaturatedStateWagnerPruss(T) - 1.0) < 1e-3)
+            continue;
+        REQUIRE(waterThermoDataInterpolatedDensityWagnerPruss(T, P) == Approx(item.density).epsilon(1e-12));
+    }
+
+    // The interpolated density lies on the same side of the saturation curve as the given state
+    for(auto T = 275.0; T < waterCriticalTemperature - 1.0; T += 7.3)
+    {
+        const auto Psat = waterPressureSaturatedStateWagnerPruss(T);
+        for(auto factor : { 0.01, 0.3, 0.9, 0.999, 1.001, 1.1, 3.0, 100.0 })
+        {
+            const auto P = factor * Psat;
+            const auto D = waterThermoDataInterpolatedDensityWagnerPruss(T, P);
+            if(factor < 1.0) REQUIRE(D < waterDensitySaturatedVaporStateWagnerPruss(T));
+            else REQUIRE(D > waterDensitySaturatedLiquidStateWagnerPruss(T) * 0.999);
+        }
+    }
 }
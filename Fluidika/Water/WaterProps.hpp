@@ -22,76 +22,80 @@
 
 namespace Fluidika {
 
-/// A type for storing thermodynamic properties of water.
-struct WaterThermoProps
+/// A type for storing thermodynamic properties of water with a generic scalar type.
+template<typename Scalar>
+struct WaterThermoPropsBase
 {
 	/// The temperature of water (in units of K)
-	Real temperature;
+	Scalar temperature;
 
 	/// The specific volume of water (in units of m3/kg)
-	Real volume;
+	Scalar volume;
 
 	/// The specific entropy of water (in units of J/(kg*K))
-	Real entropy;
+	Scalar entropy;
 
 	/// The specific Helmholtz free energy of water (in units of J/kg)
-	Real helmholtz;
+	Scalar helmholtz;
 
 	/// The specific internal energy of water (in units of J/kg)
-	Real internal_energy;
+	Scalar internal_energy;
 
 	/// The specific enthalpy of water (in units of J/kg)
-	Real enthalpy;
+	Scalar enthalpy;
 
 	/// The specific Gibbs free energy of water (in units of J/kg)
-	Real gibbs;
+	Scalar gibbs;
 
 	/// The specific isochoric heat capacity of water (in units of J/(kg*K))
-	Real cv;
+	Scalar cv;
 
 	/// The specific isobaric heat capacity of water (in units of J/(kg*K))
-	Real cp;
+	Scalar cp;
 
 	/// The specific density of water (in units of kg/m3)
-	Real density;
+	Scalar density;
 
 	/// The first-order partial derivative of density with respect to temperature (in units of (kg/m3)/K)
-	Real densityT;
+	Scalar densityT;
 
 	/// The first-order partial derivative of density with respect to pressure (in units of (kg/m3)/Pa)
-	Real densityP;
+	Scalar densityP;
 
 	/// The second-order partial derivative of density with respect to temperature (in units of (kg/m3)/(K*K))
-	Real densityTT;
+	Scalar densityTT;
 
 	/// The second-order partial derivative of density with respect to temperature and pressure (in units of (kg/m3)/(K*Pa))
-	Real densityTP;
+	Scalar densityTP;
 
 	/// The second-order partial derivative of density with respect to pressure (in units of (kg/m3)/(Pa*Pa))
-	Real densityPP;
+	Scalar densityPP;
 
 	/// The pressure of water (in units of Pa)
-	Real pressure;
+	Scalar pressure;
 
 	/// The first-order partial derivative of pressure with respect to temperature (in units of Pa/K)
-	Real pressureT;
+	Scalar pressureT;
 
 	/// The first-order partial derivative of pressure with respect to density (in units of Pa/(kg/m3))
-	Real pressureD;
+	Scalar pressureD;
 
 	/// The second-order partial derivative of pressure with respect to temperature (in units of Pa/(K*K))
-	Real pressureTT;
+	Scalar pressureTT;
 
 	/// The second-order partial derivative of pressure with respect to temperature and density (in units of Pa/(K*kg/m3))
-	Real pressureTD;
+	Scalar pressureTD;
 
 	/// The second-order partial derivative of pressure with respect to density (in units of Pa/((kg/m3)*(kg/m3)))
-	Real pressureDD;
+	Scalar pressureDD;
 
     /// The speed of sound (in m/s)
-    Real speed_of_sound;
+    Scalar speed_of_sound;
 };
 
+/// A type for storing thermodynamic properties of water.
+struct WaterThermoProps : WaterThermoPropsBase<Real> {};
+
 /// A type for storing only a small subset of thermodynamic properties of water.
 struct WaterThermoPropsSimple
 {
@@ -123,78 +127,161 @@ struct WaterThermoPropsSimple
     Real speed_of_sound;
 };
 
-/// A type for storing electrostatic properties of water.
-struct WaterElectroProps
+/// A type for storing the properties of water at saturation, where liquid and vapor water coexist.
+/// The derivatives with respect to temperature are taken along the saturation curve.
+struct WaterSaturationProps
+{
+    /// The temperature of water (in units of K)
+    Real temperature;
+
+    /// The saturation pressure of water (in units of Pa)
+    Real pressure;
+
+    /// The derivative of the saturation pressure with respect to temperature (in units of Pa/K)
+    Real pressureT;
+
+    /// The density of saturated liquid water (in units of kg/m3)
+    Real density_liquid;
+
+    /// The derivative of the density of saturated liquid water with respect to temperature (in units of (kg/m3)/K)
+    Real density_liquidT;
+
+    /// The density of saturated vapor water (in units of kg/m3)
+    Real density_vapor;
+
+    /// The derivative of the density of saturated vapor water with respect to temperature (in units of (kg/m3)/K)
+    Real density_vaporT;
+};
+
+/// A type for storing electrostatic properties of water with a generic scalar type.
+template<typename Scalar>
+struct WaterElectroPropsBase
 {
     /// The dielectric constant of water
-    Real epsilon;
+    Scalar epsilon;
 
     /// The first-order partial derivative of the dielectric constant with respect to temperature
-    Real epsilonT;
+    Scalar epsilonT;
 
     /// The first-order partial derivative of the dielectric constant with respect to pressure
-    Real epsilonP;
+    Scalar epsilonP;
 
     /// The second-order partial derivative of the dielectric constant with respect to temperature
-    Real epsilonTT;
+    Scalar epsilonTT;
 
     /// The second-order partial derivative of the dielectric constant with respect to temperature and pressure
-    Real epsilonTP;
+    Scalar epsilonTP;
 
     /// The second-order partial derivative of the dielectric constant with respect to pressure
-    Real epsilonPP;
+    Scalar epsilonPP;
 
     /// The Born function \f$ Z\equiv-\frac{1}{\epsilon} \f$ (see Helgeson and Kirkham, 1974)
-    Real bornZ;
+    Scalar bornZ;
 
     /// The Born function \f$ Y\equiv\left[\frac{\partial Z}{\partial T}\right]_{P} \f$ (see Helgeson and Kirkham, 1974)
-    Real bornY;
+    Scalar bornY;
 
     /// The Born function \f$ Q\equiv\left[\frac{\partial Z}{\partial P}\right]_{T} \f$ (see Helgeson and Kirkham, 1974)
-    Real bornQ;
+    Scalar bornQ;
 
     /// The Born function \f$ N\equiv\left[\frac{\partial Q}{\partial P}\right]_{T} \f$ (see Helgeson and Kirkham, 1974)
-    Real bornN;
+    Scalar bornN;
 
     /// The Born function \f$ U\equiv\left[\frac{\partial Q}{\partial T}\right]_{P} \f$ (see Helgeson and Kirkham, 1974)
-    Real bornU;
+    Scalar bornU;
 
     /// The Born function \f$ X\equiv\left[\frac{\partial Y}{\partial T}\right]_{P} \f$ (see Helgeson and Kirkham, 1974)
-    Real bornX;
+    Scalar bornX;
 };
 
-/// A type for storing specific Helmholtz free energy of water for Helmholtz-based water thermodynamic models.
-struct WaterHelmholtzProps
+/// A type for storing electrostatic properties of water.
+struct WaterElectroProps : WaterElectroPropsBase<Real> {};
+
+/// A type for storing specific Helmholtz free energy properties of water with a generic scalar type.
+/// @see WaterHelmholtzProps, WaterHelmholtzPropsFloat
+template<typename Scalar>
+struct WaterHelmholtzPropsBase
 {
     /// The specific Helmholtz free energy of water (in units of J/kg)
-    Real helmholtz;
+    Scalar helmholtz;
 
     /// The first-order partial derivative of the specific Helmholtz free energy of water with respect to temperature
-    Real helmholtzT;
+    Scalar helmholtzT;
 
     /// The first-order partial derivative of the specific Helmholtz free energy of water with respect to density
-    Real helmholtzD;
+    Scalar helmholtzD;
 
     /// The second-order partial derivative of the specific Helmholtz free energy of water with respect to temperature
-    Real helmholtzTT;
+    Scalar helmholtzTT;
 
     /// The second-order partial derivative of the specific Helmholtz free energy of water with respect to temperature and density
-    Real helmholtzTD;
+    Scalar helmholtzTD;
 
     /// The second-order partial derivative of the specific Helmholtz free energy of water with respect to density
-    Real helmholtzDD;
+    Scalar helmholtzDD;
 
     /// The third-order partial derivative of the specific Helmholtz free energy of water with respect to temperature
-    Real helmholtzTTT;
+    Scalar helmholtzTTT;
 
     /// The third-order partial derivative of the specific Helmholtz free energy of water with respect to temperature, temperature, and density
-    Real helmholtzTTD;
+    Scalar helmholtzTTD;
 
     /// The third-order partial derivative of the specific Helmholtz free energy of water with respect to temperature, density, and density
-    Real helmholtzTDD;
+    Scalar helmholtzTDD;
 
     /// The third-order partial derivative of the specific Helmholtz free energy of water with respect to density
-    Real helmholtzDDD;
+    Scalar helmholtzDDD;
 };
 
+/// A type for storing specific Helmholtz free energy of water for Helmholtz-based water thermodynamic models.
+struct WaterHelmholtzProps : WaterHelmholtzPropsBase<Real> {};
+
+/// A type for storing specific Helmholtz free energy properties of water in single precision.
+/// @see WaterHelmholtzProps
+struct WaterHelmholtzPropsFloat : WaterHelmholtzPropsBase<float> {};
+
+/// A type for referencing arrays of specific Helmholtz free energy properties of water with a generic scalar type.
+/// Each member points to an array with one entry per state of water, so that the states are stored as a
+/// structure of arrays, which is the layout used by the batch evaluation of the equations of state.
+/// @see WaterHelmholtzPropsArrays, WaterHelmholtzPropsArraysFloat
+template<typename Scalar>
+struct WaterHelmholtzPropsArraysBase
+{
+    /// The array of specific Helmholtz free energies of water (in units of J/kg)
+    Scalar* helmholtz;
+
+    /// The array of first-order partial derivatives of the specific Helmholtz free energy of water with respect to temperature
+    Scalar* helmholtzT;
+
+    /// The array of first-order partial derivatives of the specific Helmholtz free energy of water with respect to density
+    Scalar* helmholtzD;
+
+    /// The array of second-order partial derivatives of the specific Helmholtz free energy of water with respect to temperature
+    Scalar* helmholtzTT;
+
+    /// The array of second-order partial derivatives of the specific Helmholtz free energy of water with respect to temperature and density
+    Scalar* helmholtzTD;
+
+    /// The array of second-order partial derivatives of the specific Helmholtz free energy of water with respect to density
+    Scalar* helmholtzDD;
+
+    /// The array of third-order partial derivatives of the specific Helmholtz free energy of water with respect to temperature
+    Scalar* helmholtzTTT;
+
+    /// The array of third-order partial derivatives of the specific Helmholtz free energy of water with respect to temperature, temperature, and density
+    Scalar* helmholtzTTD;
+
+    /// The array of third-order partial derivatives of the specific Helmholtz free energy of water with respect to temperature, density, and density
+    Scalar* helmholtzTDD;
+
+    /// The array of third-order partial derivatives of the specific Helmholtz free energy of water with respect to density
+    Scalar* helmholtzDDD;
+};
+
+/// A type for referencing arrays of specific Helmholtz free energy properties of water stored column by column.
+struct WaterHelmholtzPropsArrays : WaterHelmholtzPropsArraysBase<Real> {};
+
+/// A type for referencing arrays of specific Helmholtz free energy properties of water in single precision stored column by column.
+struct WaterHelmholtzPropsArraysFloat : WaterHelmholtzPropsArraysBase<float> {};
+
 } // namespace Fluidika
@@ -1 +1,2 @@
 # Only list below the public dependencies, those needed during run stage
+find_package(Threads REQUIRED)